@@ -1452,7 +1452,13 @@ static int ist_add(const OptionsContext *o, Demuxer *d, AVStream *st, AVDictiona
         av_dict_set(&ds->decoder_opts, "thread_type", "-frame", 0);
 
     switch (par->codec_type) {
-    case AVMEDIA_TYPE_VIDEO:
+    case AVMEDIA_TYPE_VIDEO: {
+        int keyframes_only = 0;
+
+        opt_match_per_stream_int(ist, &o->keyframes_only, ic, st, &keyframes_only);
+        if (keyframes_only)
+            av_dict_set(&ds->decoder_opts, "flags2", "+keyframes", AV_DICT_APPEND);
+
         opt_match_per_stream_str(ist, &o->frame_rates, ic, st, &framerate);
         if (framerate) {
             ret = av_parse_video_rate(&ist->framerate, framerate);
@@ -1469,6 +1475,7 @@ static int ist_add(const OptionsContext *o, Demuxer *d, AVStream *st, AVDictiona
 #endif
 
         break;
+    }
     case AVMEDIA_TYPE_AUDIO: {
         const char *ch_layout_str = NULL;
 
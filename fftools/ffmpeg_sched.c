@@ -32,6 +32,7 @@
 #include "libavcodec/packet.h"
 
 #include "libavutil/avassert.h"
+#include "libavutil/bprint.h"
 #include "libavutil/error.h"
 #include "libavutil/fifo.h"
 #include "libavutil/frame.h"
@@ -60,6 +61,34 @@ typedef struct SchWaiter {
     int                 choked_next;
 } SchWaiter;
 
+#define SCH_STATS_HIST_SIZE 24
+
+typedef struct SchTaskStats {
+    // the following are updated by the task itself and read by
+    // sch_stats_print(); all times are in microseconds
+    atomic_int_least64_t    time_start;
+    atomic_int_least64_t    time_end;
+    // waiting for input
+    atomic_int_least64_t    time_wait_in;
+    // waiting for space in downstream queues or for being unchoked
+    atomic_int_least64_t    time_wait_out;
+    // waiting for a run slot, see sch_set_run_slots()
+    atomic_int_least64_t    time_wait_slot;
+
+    atomic_uint_least64_t   nb_in;
+    atomic_uint_least64_t   nb_out;
+
+    /* Histogram of the time spent processing each item, i.e. between
+     * receiving an item and asking for the next one (between sending
+     * consecutive packets for demuxers). Bucket i counts items that took
+     * [2^i, 2^(i+1)) microseconds, bucket 0 also counts anything shorter
+     * and the last bucket anything longer. */
+    atomic_uint_least64_t   latency[SCH_STATS_HIST_SIZE];
+
+    // only accessed by the task
+    int64_t                 item_start;
+} SchTaskStats;
+
 typedef struct SchTask {
     Scheduler          *parent;
     SchedulerNode       node;
@@ -69,6 +98,8 @@ typedef struct SchTask {
 
     pthread_t           thread;
     int                 thread_running;
+
+    SchTaskStats        stats;
 } SchTask;
 
 typedef struct SchDecOutput {
@@ -311,21 +342,198 @@ struct Scheduler {
     pthread_mutex_t     schedule_lock;
 
     atomic_int_least64_t last_dts;
+
+    /* Maximum number of tasks allowed to execute concurrently, 0 for no limit.
+     * A task holds a run slot while it is executing and gives it up whenever
+     * it has to wait for another task inside the scheduler. */
+    unsigned            nb_run_slots;
+    unsigned            run_slots_used;
+    pthread_mutex_t     run_slots_lock;
+    pthread_cond_t      run_slots_cond;
+
+    // collect per-task statistics, see sch_stats_enable()
+    int                 stats;
 };
 
+/**
+ * @return whether blocking operations of this task need to go through
+ *         task_wait_start()/task_wait_end()
+ */
+static int task_tracked(const Scheduler *sch, const SchTask *task)
+{
+    return task && (sch->nb_run_slots || sch->stats);
+}
+
+/**
+ * Wait for a free run slot and take it.
+ *
+ * @param task the calling task; NULL when not called from a scheduler task,
+ *             in which case this is a no-op
+ */
+static void run_slot_acquire(Scheduler *sch, SchTask *task)
+{
+    if (!task || !sch->nb_run_slots)
+        return;
+
+    pthread_mutex_lock(&sch->run_slots_lock);
+
+    if (sch->run_slots_used >= sch->nb_run_slots) {
+        int64_t t0 = sch->stats ? av_gettime_relative() : 0;
+
+        while (sch->run_slots_used >= sch->nb_run_slots)
+            pthread_cond_wait(&sch->run_slots_cond, &sch->run_slots_lock);
+
+        if (sch->stats)
+            atomic_fetch_add(&task->stats.time_wait_slot, av_gettime_relative() - t0);
+    }
+    sch->run_slots_used++;
+
+    pthread_mutex_unlock(&sch->run_slots_lock);
+}
+
+static void run_slot_release(Scheduler *sch, SchTask *task)
+{
+    if (!task || !sch->nb_run_slots)
+        return;
+
+    pthread_mutex_lock(&sch->run_slots_lock);
+
+    av_assert0(sch->run_slots_used > 0);
+    sch->run_slots_used--;
+    pthread_cond_signal(&sch->run_slots_cond);
+
+    pthread_mutex_unlock(&sch->run_slots_lock);
+}
+
+enum WaitType {
+    WAIT_IN,
+    WAIT_OUT,
+};
+
+/**
+ * Must be called by a task before it blocks waiting for another task.
+ *
+ * @return a value to be passed to task_wait_end()
+ */
+static int64_t task_wait_start(Scheduler *sch, SchTask *task)
+{
+    run_slot_release(sch, task);
+    return (task && sch->stats) ? av_gettime_relative() : 0;
+}
+
+static void task_wait_end(Scheduler *sch, SchTask *task, int64_t t0,
+                          enum WaitType type)
+{
+    if (task && sch->stats) {
+        SchTaskStats *st = &task->stats;
+        atomic_fetch_add(type == WAIT_IN ? &st->time_wait_in : &st->time_wait_out,
+                         av_gettime_relative() - t0);
+    }
+    run_slot_acquire(sch, task);
+}
+
+// the task is done with its current item and is about to ask for another one
+static void task_item_end(Scheduler *sch, SchTask *task)
+{
+    SchTaskStats *st = &task->stats;
+    int64_t dur;
+    int bucket;
+
+    if (!sch->stats || !st->item_start)
+        return;
+
+    dur    = av_gettime_relative() - st->item_start;
+    bucket = dur > 1 ? av_log2(dur) : 0;
+    atomic_fetch_add(&st->latency[FFMIN(bucket, SCH_STATS_HIST_SIZE - 1)], 1);
+
+    st->item_start = 0;
+}
+
+// the task received a new item
+static void task_item_start(Scheduler *sch, SchTask *task)
+{
+    if (!sch->stats)
+        return;
+
+    atomic_fetch_add(&task->stats.nb_in, 1);
+    task->stats.item_start = av_gettime_relative();
+}
+
+/**
+ * Lock a mutex that may be held by another task while it waits inside the
+ * scheduler, without keeping our run slot occupied in the meantime.
+ */
+static void task_mutex_lock(Scheduler *sch, SchTask *task, pthread_mutex_t *mutex)
+{
+    run_slot_release(sch, task);
+    pthread_mutex_lock(mutex);
+    run_slot_acquire(sch, task);
+}
+
+static int task_tq_send(Scheduler *sch, SchTask *task, ThreadQueue *tq,
+                        unsigned stream_idx, void *data)
+{
+    int64_t t0;
+    int ret;
+
+    if (!task_tracked(sch, task))
+        return tq_send(tq, stream_idx, data, 0);
+
+    ret = tq_send(tq, stream_idx, data, THREAD_QUEUE_NONBLOCK);
+    if (ret == AVERROR(EAGAIN)) {
+        // the queue is full, let the consumer run while we wait
+        t0  = task_wait_start(sch, task);
+        ret = tq_send(tq, stream_idx, data, 0);
+        task_wait_end(sch, task, t0, WAIT_OUT);
+    }
+
+    if (ret >= 0 && sch->stats)
+        atomic_fetch_add(&task->stats.nb_out, 1);
+
+    return ret;
+}
+
+static int task_tq_receive(Scheduler *sch, SchTask *task, ThreadQueue *tq,
+                           int *stream_idx, void *data)
+{
+    int64_t t0;
+    int ret;
+
+    if (!task_tracked(sch, task))
+        return tq_receive(tq, stream_idx, data, 0);
+
+    task_item_end(sch, task);
+
+    ret = tq_receive(tq, stream_idx, data, THREAD_QUEUE_NONBLOCK);
+    if (ret == AVERROR(EAGAIN)) {
+        // the queue is empty, let the producers run while we wait
+        t0  = task_wait_start(sch, task);
+        ret = tq_receive(tq, stream_idx, data, 0);
+        task_wait_end(sch, task, t0, WAIT_IN);
+    }
+
+    if (ret >= 0)
+        task_item_start(sch, task);
+
+    return ret;
+}
+
 /**
  * Wait until this task is allowed to proceed.
  *
  * @retval 0 the caller should proceed
  * @retval 1 the caller should terminate
  */
-static int waiter_wait(Scheduler *sch, SchWaiter *w)
+static int waiter_wait(Scheduler *sch, SchTask *task, SchWaiter *w)
 {
+    int64_t t0;
     int terminate;
 
     if (!atomic_load(&w->choked))
         return 0;
 
+    t0 = task_wait_start(sch, task);
+
     pthread_mutex_lock(&w->lock);
 
     while (atomic_load(&w->choked) && !atomic_load(&sch->terminate))
@@ -335,6 +543,8 @@ static int waiter_wait(Scheduler *sch, SchWaiter *w)
 
     pthread_mutex_unlock(&w->lock);
 
+    task_wait_end(sch, task, t0, WAIT_OUT);
+
     return terminate;
 }
 
@@ -371,8 +581,12 @@ static void waiter_uninit(SchWaiter *w)
     pthread_cond_destroy(&w->cond);
 }
 
+/**
+ * @param single_producer items will only be sent to the queue from one thread
+ *                        at a time, see THREAD_QUEUE_SINGLE_PRODUCER
+ */
 static int queue_alloc(ThreadQueue **ptq, unsigned nb_streams, unsigned queue_size,
-                       enum QueueType type)
+                       enum QueueType type, int single_producer)
 {
     ThreadQueue *tq;
 
@@ -393,7 +607,8 @@ static int queue_alloc(ThreadQueue **ptq, unsigned nb_streams, unsigned queue_si
     }
 
     tq = tq_alloc(nb_streams, queue_size,
-                  (type == QUEUE_PACKETS) ? THREAD_QUEUE_PACKETS : THREAD_QUEUE_FRAMES);
+                  (type == QUEUE_PACKETS) ? THREAD_QUEUE_PACKETS : THREAD_QUEUE_FRAMES,
+                  single_producer ? THREAD_QUEUE_SINGLE_PRODUCER : 0);
     if (!tq)
         return AVERROR(ENOMEM);
 
@@ -566,6 +781,9 @@ void sch_free(Scheduler **psch)
     pthread_mutex_destroy(&sch->finish_lock);
     pthread_cond_destroy(&sch->finish_cond);
 
+    pthread_mutex_destroy(&sch->run_slots_lock);
+    pthread_cond_destroy(&sch->run_slots_cond);
+
     av_freep(psch);
 }
 
@@ -602,6 +820,14 @@ Scheduler *sch_alloc(void)
     if (ret)
         goto fail;
 
+    ret = pthread_mutex_init(&sch->run_slots_lock, NULL);
+    if (ret)
+        goto fail;
+
+    ret = pthread_cond_init(&sch->run_slots_cond, NULL);
+    if (ret)
+        goto fail;
+
     return sch;
 fail:
     sch_free(&sch);
@@ -615,6 +841,21 @@ int sch_sdp_filename(Scheduler *sch, const char *sdp_filename)
     return sch->sdp_filename ? 0 : AVERROR(ENOMEM);
 }
 
+int sch_set_run_slots(Scheduler *sch, unsigned nb_slots)
+{
+    av_assert0(sch->state == SCH_STATE_UNINIT);
+
+    sch->nb_run_slots = nb_slots;
+    return 0;
+}
+
+void sch_stats_enable(Scheduler *sch)
+{
+    av_assert0(sch->state == SCH_STATE_UNINIT);
+
+    sch->stats = 1;
+}
+
 static const AVClass sch_mux_class = {
     .class_name                = "SchMux",
     .version                   = LIBAVUTIL_VERSION_INT,
@@ -761,10 +1002,6 @@ int sch_add_dec(Scheduler *sch, SchThreadFunc func, void *ctx, int send_end_ts)
     if (ret < 0)
         return ret;
 
-    ret = queue_alloc(&dec->queue, 1, 0, QUEUE_PACKETS);
-    if (ret < 0)
-        return ret;
-
     if (send_end_ts) {
         ret = av_thread_message_queue_alloc(&dec->queue_end_ts, 1, sizeof(Timestamp));
         if (ret < 0)
@@ -805,7 +1042,9 @@ int sch_add_enc(Scheduler *sch, SchThreadFunc func, void *ctx,
     if (!enc->send_pkt)
         return AVERROR(ENOMEM);
 
-    ret = queue_alloc(&enc->queue, 1, 0, QUEUE_FRAMES);
+    // the encoder is fed either directly by its source, or through a sync
+    // queue, which is only ever accessed with its lock held
+    ret = queue_alloc(&enc->queue, 1, 0, QUEUE_FRAMES, 1);
     if (ret < 0)
         return ret;
 
@@ -853,7 +1092,7 @@ int sch_add_filtergraph(Scheduler *sch, unsigned nb_inputs, unsigned nb_outputs,
     if (ret < 0)
         return ret;
 
-    ret = queue_alloc(&fg->queue, fg->nb_inputs + 1, 0, QUEUE_FRAMES);
+    ret = queue_alloc(&fg->queue, fg->nb_inputs + 1, 0, QUEUE_FRAMES, 0);
     if (ret < 0)
         return ret;
 
@@ -1136,7 +1375,7 @@ static int mux_task_start(SchMux *mux)
 
             if (pkt) {
                 if (!ms->init_eof)
-                    ret = tq_send(mux->queue, min_stream, pkt);
+                    ret = tq_send(mux->queue, min_stream, pkt, 0);
                 av_packet_free(&pkt);
                 if (ret == AVERROR_EOF)
                     ms->init_eof = 1;
@@ -1443,6 +1682,37 @@ fail:
     return ret;
 }
 
+// whether packets are only ever sent to the decoder by its source task
+static int dec_single_producer(const Scheduler *sch, unsigned dec_idx)
+{
+    // subtitle heartbeats are sent by muxer tasks
+    for (unsigned i = 0; i < sch->nb_mux; i++) {
+        const SchMux *mux = &sch->mux[i];
+
+        for (unsigned j = 0; j < mux->nb_streams; j++) {
+            const SchMuxStream *ms = &mux->streams[j];
+
+            for (unsigned k = 0; k < ms->nb_sub_heartbeat_dst; k++)
+                if (ms->sub_heartbeat_dst[k] == dec_idx)
+                    return 0;
+        }
+    }
+
+    return 1;
+}
+
+// whether all the streams of this muxer are fed by the same task
+static int mux_single_producer(const SchMux *mux)
+{
+    for (unsigned i = 1; i < mux->nb_streams; i++) {
+        if (mux->streams[i].src.type != mux->streams[0].src.type ||
+            mux->streams[i].src.idx  != mux->streams[0].src.idx)
+            return 0;
+    }
+
+    return 1;
+}
+
 static int start_prepare(Scheduler *sch)
 {
     int ret;
@@ -1474,6 +1744,11 @@ static int start_prepare(Scheduler *sch)
             return AVERROR(EINVAL);
         }
 
+        ret = queue_alloc(&dec->queue, 1, 0, QUEUE_PACKETS,
+                          dec_single_producer(sch, i));
+        if (ret < 0)
+            return ret;
+
         for (unsigned j = 0; j < dec->nb_outputs; j++) {
             SchDecOutput *o = &dec->outputs[j];
 
@@ -1537,7 +1812,7 @@ static int start_prepare(Scheduler *sch)
         }
 
         ret = queue_alloc(&mux->queue, mux->nb_streams, mux->queue_size,
-                          QUEUE_PACKETS);
+                          QUEUE_PACKETS, mux_single_producer(mux));
         if (ret < 0)
             return ret;
     }
@@ -1705,7 +1980,8 @@ static int enc_open(Scheduler *sch, SchEnc *enc, const AVFrame *frame)
     return 0;
 }
 
-static int send_to_enc_thread(Scheduler *sch, SchEnc *enc, AVFrame *frame)
+static int send_to_enc_thread(Scheduler *sch, SchTask *task,
+                              SchEnc *enc, AVFrame *frame)
 {
     int ret;
 
@@ -1717,14 +1993,15 @@ static int send_to_enc_thread(Scheduler *sch, SchEnc *enc, AVFrame *frame)
     if (enc->in_finished)
         return AVERROR_EOF;
 
-    ret = tq_send(enc->queue, 0, frame);
+    ret = task_tq_send(sch, task, enc->queue, 0, frame);
     if (ret < 0)
         enc->in_finished = 1;
 
     return ret;
 }
 
-static int send_to_enc_sq(Scheduler *sch, SchEnc *enc, AVFrame *frame)
+static int send_to_enc_sq(Scheduler *sch, SchTask *task,
+                          SchEnc *enc, AVFrame *frame)
 {
     SchSyncQueue *sq = &sch->sq_enc[enc->sq_idx[0]];
     int ret = 0;
@@ -1754,7 +2031,7 @@ static int send_to_enc_sq(Scheduler *sch, SchEnc *enc, AVFrame *frame)
         }
     }
 
-    pthread_mutex_lock(&sq->lock);
+    task_mutex_lock(sch, task, &sq->lock);
 
     ret = sq_send(sq->sq, enc->sq_idx[1], SQFRAME(frame));
     if (ret < 0)
@@ -1772,7 +2049,7 @@ static int send_to_enc_sq(Scheduler *sch, SchEnc *enc, AVFrame *frame)
         }
 
         enc = &sch->enc[sq->enc_idx[ret]];
-        ret = send_to_enc_thread(sch, enc, sq->frame);
+        ret = send_to_enc_thread(sch, task, enc, sq->frame);
         if (ret < 0) {
             av_frame_unref(sq->frame);
             if (ret != AVERROR_EOF)
@@ -1786,7 +2063,7 @@ static int send_to_enc_sq(Scheduler *sch, SchEnc *enc, AVFrame *frame)
     if (ret < 0) {
         // close all encoders fed from this sync queue
         for (unsigned i = 0; i < sq->nb_enc_idx; i++) {
-            int err = send_to_enc_thread(sch, &sch->enc[sq->enc_idx[i]], NULL);
+            int err = send_to_enc_thread(sch, task, &sch->enc[sq->enc_idx[i]], NULL);
 
             // if the sync queue error is EOF and closing the encoder
             // produces a more serious error, make sure to pick the latter
@@ -1800,10 +2077,17 @@ finish:
     return ret;
 }
 
-static int send_to_enc(Scheduler *sch, SchEnc *enc, AVFrame *frame)
+static int send_to_enc(Scheduler *sch, SchTask *task, SchEnc *enc, AVFrame *frame)
 {
     if (enc->open_cb && frame && !enc->opened) {
-        int ret = enc_open(sch, enc, frame);
+        int ret;
+
+        // Opening the encoder may start muxer tasks and feed them packets
+        // buffered so far, without us being able to pass our identity along;
+        // so this one-off initialization runs outside of run slot accounting.
+        run_slot_release(sch, task);
+        ret = enc_open(sch, enc, frame);
+        run_slot_acquire(sch, task);
         if (ret < 0)
             return ret;
         enc->opened = 1;
@@ -1815,9 +2099,9 @@ static int send_to_enc(Scheduler *sch, SchEnc *enc, AVFrame *frame)
         }
     }
 
-    return (enc->sq_idx[0] >= 0)                ?
-           send_to_enc_sq    (sch, enc, frame)  :
-           send_to_enc_thread(sch, enc, frame);
+    return (enc->sq_idx[0] >= 0)                      ?
+           send_to_enc_sq    (sch, task, enc, frame)  :
+           send_to_enc_thread(sch, task, enc, frame);
 }
 
 static int mux_queue_packet(SchMux *mux, SchMuxStream *ms, AVPacket *pkt)
@@ -1856,8 +2140,8 @@ static int mux_queue_packet(SchMux *mux, SchMuxStream *ms, AVPacket *pkt)
     return 0;
 }
 
-static int send_to_mux(Scheduler *sch, SchMux *mux, unsigned stream_idx,
-                       AVPacket *pkt)
+static int send_to_mux(Scheduler *sch, SchTask *task, SchMux *mux,
+                       unsigned stream_idx, AVPacket *pkt)
 {
     SchMuxStream *ms = &mux->streams[stream_idx];
     int64_t dts = (pkt && pkt->dts != AV_NOPTS_VALUE)                                    ?
@@ -1870,7 +2154,7 @@ static int send_to_mux(Scheduler *sch, SchMux *mux, unsigned stream_idx,
 
         // the muxer could have started between the above atomic check and
         // locking the mutex, then this block falls through to normal send path
-        pthread_mutex_lock(&sch->mux_ready_lock);
+        task_mutex_lock(sch, task, &sch->mux_ready_lock);
 
         if (!atomic_load(&mux->mux_started)) {
             int ret = mux_queue_packet(mux, ms, pkt);
@@ -1891,7 +2175,7 @@ static int send_to_mux(Scheduler *sch, SchMux *mux, unsigned stream_idx,
         if (ms->init_eof)
             return AVERROR_EOF;
 
-        ret = tq_send(mux->queue, stream_idx, pkt);
+        ret = task_tq_send(sch, task, mux->queue, stream_idx, pkt);
         if (ret < 0)
             return ret;
     } else
@@ -1915,7 +2199,7 @@ update_schedule:
 }
 
 static int
-demux_stream_send_to_dst(Scheduler *sch, const SchedulerNode dst,
+demux_stream_send_to_dst(Scheduler *sch, SchTask *task, const SchedulerNode dst,
                          uint8_t *dst_finished, AVPacket *pkt, unsigned flags)
 {
     int ret;
@@ -1933,8 +2217,8 @@ demux_stream_send_to_dst(Scheduler *sch, const SchedulerNode dst,
         goto finish;
 
     ret = (dst.type == SCH_NODE_TYPE_MUX) ?
-          send_to_mux(sch, &sch->mux[dst.idx], dst.idx_stream, pkt) :
-          tq_send(sch->dec[dst.idx].queue, 0, pkt);
+          send_to_mux(sch, task, &sch->mux[dst.idx], dst.idx_stream, pkt) :
+          task_tq_send(sch, task, sch->dec[dst.idx].queue, 0, pkt);
     if (ret == AVERROR_EOF)
         goto finish;
 
@@ -1942,7 +2226,7 @@ demux_stream_send_to_dst(Scheduler *sch, const SchedulerNode dst,
 
 finish:
     if (dst.type == SCH_NODE_TYPE_MUX)
-        send_to_mux(sch, &sch->mux[dst.idx], dst.idx_stream, NULL);
+        send_to_mux(sch, task, &sch->mux[dst.idx], dst.idx_stream, NULL);
     else
         tq_send_finish(sch->dec[dst.idx].queue, 0);
 
@@ -1950,7 +2234,8 @@ finish:
     return AVERROR_EOF;
 }
 
-static int demux_send_for_stream(Scheduler *sch, SchDemux *d, SchDemuxStream *ds,
+static int demux_send_for_stream(Scheduler *sch, SchTask *task,
+                                 SchDemux *d, SchDemuxStream *ds,
                                  AVPacket *pkt, unsigned flags)
 {
     unsigned nb_done = 0;
@@ -1970,7 +2255,7 @@ static int demux_send_for_stream(Scheduler *sch, SchDemux *d, SchDemuxStream *ds
                 return ret;
         }
 
-        ret = demux_stream_send_to_dst(sch, ds->dst[i], finished, to_send, flags);
+        ret = demux_stream_send_to_dst(sch, task, ds->dst[i], finished, to_send, flags);
         if (to_send)
             av_packet_unref(to_send);
         if (ret == AVERROR_EOF)
@@ -2001,13 +2286,19 @@ static int demux_flush(Scheduler *sch, SchDemux *d, AVPacket *pkt)
 
             dec = &sch->dec[dst->idx];
 
-            ret = tq_send(dec->queue, 0, pkt);
+            ret = task_tq_send(sch, &d->task, dec->queue, 0, pkt);
             if (ret < 0)
                 return ret;
 
             if (dec->queue_end_ts) {
                 Timestamp ts;
-                ret = av_thread_message_queue_recv(dec->queue_end_ts, &ts, 0);
+                ret = av_thread_message_queue_recv(dec->queue_end_ts, &ts,
+                                                   AV_THREAD_MESSAGE_NONBLOCK);
+                if (ret == AVERROR(EAGAIN)) {
+                    int64_t t0 = task_wait_start(sch, &d->task);
+                    ret = av_thread_message_queue_recv(dec->queue_end_ts, &ts, 0);
+                    task_wait_end(sch, &d->task, t0, WAIT_OUT);
+                }
                 if (ret < 0)
                     return ret;
 
@@ -2030,31 +2321,39 @@ int sch_demux_send(Scheduler *sch, unsigned demux_idx, AVPacket *pkt,
                    unsigned flags)
 {
     SchDemux *d;
-    int terminate;
+    int ret, terminate;
 
     av_assert0(demux_idx < sch->nb_demux);
     d = &sch->demux[demux_idx];
 
-    terminate = waiter_wait(sch, &d->waiter);
+    task_item_end(sch, &d->task);
+
+    terminate = waiter_wait(sch, &d->task, &d->waiter);
     if (terminate)
         return AVERROR_EXIT;
 
     // flush the downstreams after seek
     if (pkt->stream_index == -1)
-        return demux_flush(sch, d, pkt);
+        ret = demux_flush(sch, d, pkt);
+    else {
+        av_assert0(pkt->stream_index < d->nb_streams);
+
+        ret = demux_send_for_stream(sch, &d->task, d, &d->streams[pkt->stream_index],
+                                    pkt, flags);
+    }
 
-    av_assert0(pkt->stream_index < d->nb_streams);
+    task_item_start(sch, &d->task);
 
-    return demux_send_for_stream(sch, d, &d->streams[pkt->stream_index], pkt, flags);
+    return ret;
 }
 
-static int demux_done(Scheduler *sch, unsigned demux_idx)
+static int demux_done(Scheduler *sch, SchTask *task, unsigned demux_idx)
 {
     SchDemux *d = &sch->demux[demux_idx];
     int ret = 0;
 
     for (unsigned i = 0; i < d->nb_streams; i++) {
-        int err = demux_send_for_stream(sch, d, &d->streams[i], NULL, 0);
+        int err = demux_send_for_stream(sch, task, d, &d->streams[i], NULL, 0);
         if (err != AVERROR_EOF)
             ret = err_merge(ret, err);
     }
@@ -2078,7 +2377,7 @@ int sch_mux_receive(Scheduler *sch, unsigned mux_idx, AVPacket *pkt)
     av_assert0(mux_idx < sch->nb_mux);
     mux = &sch->mux[mux_idx];
 
-    ret = tq_receive(mux->queue, &stream_idx, pkt);
+    ret = task_tq_receive(sch, &mux->task, mux->queue, &stream_idx, pkt);
     pkt->stream_index = stream_idx;
     return ret;
 }
@@ -2121,7 +2420,7 @@ int sch_mux_sub_heartbeat(Scheduler *sch, unsigned mux_idx, unsigned stream_idx,
         if (ret < 0)
             return ret;
 
-        tq_send(dst->queue, 0, mux->sub_heartbeat_pkt);
+        task_tq_send(sch, &mux->task, dst->queue, 0, mux->sub_heartbeat_pkt);
     }
 
     return 0;
@@ -2165,14 +2464,20 @@ int sch_dec_receive(Scheduler *sch, unsigned dec_idx, AVPacket *pkt)
     // the decoder should have given us post-flush end timestamp in pkt
     if (dec->expect_end_ts) {
         Timestamp ts = (Timestamp){ .ts = pkt->pts, .tb = pkt->time_base };
-        ret = av_thread_message_queue_send(dec->queue_end_ts, &ts, 0);
+        ret = av_thread_message_queue_send(dec->queue_end_ts, &ts,
+                                           AV_THREAD_MESSAGE_NONBLOCK);
+        if (ret == AVERROR(EAGAIN)) {
+            int64_t t0 = task_wait_start(sch, &dec->task);
+            ret = av_thread_message_queue_send(dec->queue_end_ts, &ts, 0);
+            task_wait_end(sch, &dec->task, t0, WAIT_OUT);
+        }
         if (ret < 0)
             return ret;
 
         dec->expect_end_ts = 0;
     }
 
-    ret = tq_receive(dec->queue, &dummy, pkt);
+    ret = task_tq_receive(sch, &dec->task, dec->queue, &dummy, pkt);
     av_assert0(dummy <= 0);
 
     // got a flush packet, on the next call to this function the decoder
@@ -2183,11 +2488,11 @@ int sch_dec_receive(Scheduler *sch, unsigned dec_idx, AVPacket *pkt)
     return ret;
 }
 
-static int send_to_filter(Scheduler *sch, SchFilterGraph *fg,
+static int send_to_filter(Scheduler *sch, SchTask *task, SchFilterGraph *fg,
                           unsigned in_idx, AVFrame *frame)
 {
     if (frame)
-        return tq_send(fg->queue, in_idx, frame);
+        return task_tq_send(sch, task, fg->queue, in_idx, frame);
 
     if (!fg->inputs[in_idx].send_finished) {
         fg->inputs[in_idx].send_finished = 1;
@@ -2200,7 +2505,7 @@ static int send_to_filter(Scheduler *sch, SchFilterGraph *fg,
     return 0;
 }
 
-static int dec_send_to_dst(Scheduler *sch, const SchedulerNode dst,
+static int dec_send_to_dst(Scheduler *sch, SchTask *task, const SchedulerNode dst,
                            uint8_t *dst_finished, AVFrame *frame)
 {
     int ret;
@@ -2212,8 +2517,8 @@ static int dec_send_to_dst(Scheduler *sch, const SchedulerNode dst,
         goto finish;
 
     ret = (dst.type == SCH_NODE_TYPE_FILTER_IN) ?
-          send_to_filter(sch, &sch->filters[dst.idx], dst.idx_stream, frame) :
-          send_to_enc(sch, &sch->enc[dst.idx], frame);
+          send_to_filter(sch, task, &sch->filters[dst.idx], dst.idx_stream, frame) :
+          send_to_enc(sch, task, &sch->enc[dst.idx], frame);
     if (ret == AVERROR_EOF)
         goto finish;
 
@@ -2221,9 +2526,9 @@ static int dec_send_to_dst(Scheduler *sch, const SchedulerNode dst,
 
 finish:
     if (dst.type == SCH_NODE_TYPE_FILTER_IN)
-        send_to_filter(sch, &sch->filters[dst.idx], dst.idx_stream, NULL);
+        send_to_filter(sch, task, &sch->filters[dst.idx], dst.idx_stream, NULL);
     else
-        send_to_enc(sch, &sch->enc[dst.idx], NULL);
+        send_to_enc(sch, task, &sch->enc[dst.idx], NULL);
 
     *dst_finished = 1;
 
@@ -2260,7 +2565,7 @@ int sch_dec_send(Scheduler *sch, unsigned dec_idx,
                 return ret;
         }
 
-        ret = dec_send_to_dst(sch, o->dst[i], finished, to_send);
+        ret = dec_send_to_dst(sch, &dec->task, o->dst[i], finished, to_send);
         if (ret < 0) {
             av_frame_unref(to_send);
             if (ret == AVERROR_EOF) {
@@ -2274,7 +2579,7 @@ int sch_dec_send(Scheduler *sch, unsigned dec_idx,
     return (nb_done == o->nb_dst) ? AVERROR_EOF : 0;
 }
 
-static int dec_done(Scheduler *sch, unsigned dec_idx)
+static int dec_done(Scheduler *sch, SchTask *task, unsigned dec_idx)
 {
     SchDec *dec = &sch->dec[dec_idx];
     int ret = 0;
@@ -2290,7 +2595,7 @@ static int dec_done(Scheduler *sch, unsigned dec_idx)
         SchDecOutput *o = &dec->outputs[i];
 
         for (unsigned j = 0; j < o->nb_dst; j++) {
-            int err = dec_send_to_dst(sch, o->dst[j], &o->dst_finished[j], NULL);
+            int err = dec_send_to_dst(sch, task, o->dst[j], &o->dst_finished[j], NULL);
             if (err < 0 && err != AVERROR_EOF)
                 ret = err_merge(ret, err);
         }
@@ -2307,13 +2612,13 @@ int sch_enc_receive(Scheduler *sch, unsigned enc_idx, AVFrame *frame)
     av_assert0(enc_idx < sch->nb_enc);
     enc = &sch->enc[enc_idx];
 
-    ret = tq_receive(enc->queue, &dummy, frame);
+    ret = task_tq_receive(sch, &enc->task, enc->queue, &dummy, frame);
     av_assert0(dummy <= 0);
 
     return ret;
 }
 
-static int enc_send_to_dst(Scheduler *sch, const SchedulerNode dst,
+static int enc_send_to_dst(Scheduler *sch, SchTask *task, const SchedulerNode dst,
                            uint8_t *dst_finished, AVPacket *pkt)
 {
     int ret;
@@ -2325,8 +2630,8 @@ static int enc_send_to_dst(Scheduler *sch, const SchedulerNode dst,
         goto finish;
 
     ret = (dst.type == SCH_NODE_TYPE_MUX) ?
-          send_to_mux(sch, &sch->mux[dst.idx], dst.idx_stream, pkt) :
-          tq_send(sch->dec[dst.idx].queue, 0, pkt);
+          send_to_mux(sch, task, &sch->mux[dst.idx], dst.idx_stream, pkt) :
+          task_tq_send(sch, task, sch->dec[dst.idx].queue, 0, pkt);
     if (ret == AVERROR_EOF)
         goto finish;
 
@@ -2334,7 +2639,7 @@ static int enc_send_to_dst(Scheduler *sch, const SchedulerNode dst,
 
 finish:
     if (dst.type == SCH_NODE_TYPE_MUX)
-        send_to_mux(sch, &sch->mux[dst.idx], dst.idx_stream, NULL);
+        send_to_mux(sch, task, &sch->mux[dst.idx], dst.idx_stream, NULL);
     else
         tq_send_finish(sch->dec[dst.idx].queue, 0);
 
@@ -2364,7 +2669,7 @@ int sch_enc_send(Scheduler *sch, unsigned enc_idx, AVPacket *pkt)
                 return ret;
         }
 
-        ret = enc_send_to_dst(sch, enc->dst[i], finished, to_send);
+        ret = enc_send_to_dst(sch, &enc->task, enc->dst[i], finished, to_send);
         if (ret < 0) {
             av_packet_unref(to_send);
             if (ret == AVERROR_EOF)
@@ -2376,7 +2681,7 @@ int sch_enc_send(Scheduler *sch, unsigned enc_idx, AVPacket *pkt)
     return 0;
 }
 
-static int enc_done(Scheduler *sch, unsigned enc_idx)
+static int enc_done(Scheduler *sch, SchTask *task, unsigned enc_idx)
 {
     SchEnc *enc = &sch->enc[enc_idx];
     int ret = 0;
@@ -2384,7 +2689,7 @@ static int enc_done(Scheduler *sch, unsigned enc_idx)
     tq_receive_finish(enc->queue, 0);
 
     for (unsigned i = 0; i < enc->nb_dst; i++) {
-        int err = enc_send_to_dst(sch, enc->dst[i], &enc->dst_finished[i], NULL);
+        int err = enc_send_to_dst(sch, task, enc->dst[i], &enc->dst_finished[i], NULL);
         if (err < 0 && err != AVERROR_EOF)
             ret = err_merge(ret, err);
     }
@@ -2416,14 +2721,14 @@ int sch_filter_receive(Scheduler *sch, unsigned fg_idx,
     }
 
     if (*in_idx == fg->nb_inputs) {
-        int terminate = waiter_wait(sch, &fg->waiter);
+        int terminate = waiter_wait(sch, &fg->task, &fg->waiter);
         return terminate ? AVERROR_EOF : AVERROR(EAGAIN);
     }
 
     while (1) {
         int ret, idx;
 
-        ret = tq_receive(fg->queue, &idx, frame);
+        ret = task_tq_receive(sch, &fg->task, fg->queue, &idx, frame);
         if (idx < 0)
             return AVERROR_EOF;
         else if (ret >= 0) {
@@ -2468,12 +2773,12 @@ int sch_filter_send(Scheduler *sch, unsigned fg_idx, unsigned out_idx, AVFrame *
     av_assert0(out_idx < fg->nb_outputs);
     dst = fg->outputs[out_idx].dst;
 
-    return (dst.type == SCH_NODE_TYPE_ENC)                                    ?
-           send_to_enc   (sch, &sch->enc[dst.idx],                     frame) :
-           send_to_filter(sch, &sch->filters[dst.idx], dst.idx_stream, frame);
+    return (dst.type == SCH_NODE_TYPE_ENC)                                              ?
+           send_to_enc   (sch, &fg->task, &sch->enc[dst.idx],                     frame) :
+           send_to_filter(sch, &fg->task, &sch->filters[dst.idx], dst.idx_stream, frame);
 }
 
-static int filter_done(Scheduler *sch, unsigned fg_idx)
+static int filter_done(Scheduler *sch, SchTask *task, unsigned fg_idx)
 {
     SchFilterGraph *fg = &sch->filters[fg_idx];
     int ret = 0;
@@ -2483,9 +2788,9 @@ static int filter_done(Scheduler *sch, unsigned fg_idx)
 
     for (unsigned i = 0; i < fg->nb_outputs; i++) {
         SchedulerNode dst = fg->outputs[i].dst;
-        int err = (dst.type == SCH_NODE_TYPE_ENC)                                   ?
-                  send_to_enc   (sch, &sch->enc[dst.idx],                     NULL) :
-                  send_to_filter(sch, &sch->filters[dst.idx], dst.idx_stream, NULL);
+        int err = (dst.type == SCH_NODE_TYPE_ENC)                                         ?
+                  send_to_enc   (sch, task, &sch->enc[dst.idx],                     NULL) :
+                  send_to_filter(sch, task, &sch->filters[dst.idx], dst.idx_stream, NULL);
 
         if (err < 0 && err != AVERROR_EOF)
             ret = err_merge(ret, err);
@@ -2509,17 +2814,21 @@ int sch_filter_command(Scheduler *sch, unsigned fg_idx, AVFrame *frame)
     av_assert0(fg_idx < sch->nb_filters);
     fg = &sch->filters[fg_idx];
 
-    return send_to_filter(sch, fg, fg->nb_inputs, frame);
+    return send_to_filter(sch, NULL, fg, fg->nb_inputs, frame);
 }
 
-static int task_cleanup(Scheduler *sch, SchedulerNode node)
+/**
+ * @param task the calling task, or NULL when cleaning up after a task that
+ *             never ran
+ */
+static int task_cleanup(Scheduler *sch, SchTask *task, SchedulerNode node)
 {
     switch (node.type) {
-    case SCH_NODE_TYPE_DEMUX:       return demux_done (sch, node.idx);
-    case SCH_NODE_TYPE_MUX:         return mux_done   (sch, node.idx);
-    case SCH_NODE_TYPE_DEC:         return dec_done   (sch, node.idx);
-    case SCH_NODE_TYPE_ENC:         return enc_done   (sch, node.idx);
-    case SCH_NODE_TYPE_FILTER_IN:   return filter_done(sch, node.idx);
+    case SCH_NODE_TYPE_DEMUX:       return demux_done (sch, task, node.idx);
+    case SCH_NODE_TYPE_MUX:         return mux_done   (sch,       node.idx);
+    case SCH_NODE_TYPE_DEC:         return dec_done   (sch, task, node.idx);
+    case SCH_NODE_TYPE_ENC:         return enc_done   (sch, task, node.idx);
+    case SCH_NODE_TYPE_FILTER_IN:   return filter_done(sch, task, node.idx);
     default: av_assert0(0);
     }
 }
@@ -2531,14 +2840,24 @@ static void *task_wrapper(void *arg)
     int ret;
     int err = 0;
 
+    if (sch->stats)
+        atomic_store(&task->stats.time_start, av_gettime_relative());
+
+    run_slot_acquire(sch, task);
+
     ret = task->func(task->func_arg);
     if (ret < 0)
         av_log(task->func_arg, AV_LOG_ERROR,
                "Task finished with error code: %d (%s)\n", ret, av_err2str(ret));
 
-    err = task_cleanup(sch, task->node);
+    err = task_cleanup(sch, task, task->node);
     ret = err_merge(ret, err);
 
+    run_slot_release(sch, task);
+
+    if (sch->stats)
+        atomic_store(&task->stats.time_end, av_gettime_relative());
+
     // EOF is considered normal termination
     if (ret == AVERROR_EOF)
         ret = 0;
@@ -2562,7 +2881,7 @@ static int task_stop(Scheduler *sch, SchTask *task)
     void *thread_ret;
 
     if (!task->thread_running)
-        return task_cleanup(sch, task->node);
+        return task_cleanup(sch, NULL, task->node);
 
     ret = pthread_join(task->thread, &thread_ret);
     av_assert0(ret == 0);
@@ -2629,3 +2948,70 @@ int sch_stop(Scheduler *sch, int64_t *finish_ts)
 
     return ret;
 }
+
+static void stats_print_task(AVBPrint *bp, const char *type, unsigned idx,
+                             const SchTask *task, ThreadQueue *queue,
+                             int64_t now, int *first)
+{
+    const SchTaskStats *st = &task->stats;
+    const AVClass *cls = *(const AVClass**)task->func_arg;
+    const char   *name = cls->item_name(task->func_arg);
+
+    int64_t start     = atomic_load(&st->time_start);
+    int64_t end       = atomic_load(&st->time_end);
+    int64_t wait_in   = atomic_load(&st->time_wait_in);
+    int64_t wait_out  = atomic_load(&st->time_wait_out);
+    int64_t wait_slot = atomic_load(&st->time_wait_slot);
+    int64_t busy      = 0;
+    int last_bucket   = -1;
+
+    if (start)
+        busy = FFMAX((end ? end : now) - start - wait_in - wait_out - wait_slot, 0);
+
+    av_bprintf(bp, "%s{\"type\":\"%s\",\"index\":%u,\"name\":\"",
+               *first ? "" : ",", type, idx);
+    av_bprint_escape(bp, name, "\"\\", AV_ESCAPE_MODE_BACKSLASH, 0);
+    av_bprintf(bp, "\",\"running\":%d", start && !end);
+    if (queue)
+        av_bprintf(bp, ",\"queued\":%zu", tq_nb_items(queue));
+    av_bprintf(bp, ",\"items_in\":%"PRIu64",\"items_out\":%"PRIu64,
+               (uint64_t)atomic_load(&st->nb_in), (uint64_t)atomic_load(&st->nb_out));
+    av_bprintf(bp, ",\"busy_us\":%"PRId64",\"wait_in_us\":%"PRId64
+               ",\"wait_out_us\":%"PRId64",\"wait_slot_us\":%"PRId64,
+               busy, wait_in, wait_out, wait_slot);
+
+    // omit the trailing empty buckets
+    for (int i = 0; i < SCH_STATS_HIST_SIZE; i++)
+        if (atomic_load(&st->latency[i]))
+            last_bucket = i;
+
+    av_bprintf(bp, ",\"latency_log2_us\":[");
+    for (int i = 0; i <= last_bucket; i++)
+        av_bprintf(bp, "%s%"PRIu64, i ? "," : "", (uint64_t)atomic_load(&st->latency[i]));
+    av_bprintf(bp, "]}");
+
+    *first = 0;
+}
+
+void sch_stats_print(Scheduler *sch, AVBPrint *bp)
+{
+    int64_t now = av_gettime_relative();
+    int first = 1;
+
+    av_assert0(sch->stats);
+
+    av_bprintf(bp, "{\"time_us\":%"PRId64",\"tasks\":[", now);
+
+    for (unsigned i = 0; i < sch->nb_demux; i++)
+        stats_print_task(bp, "demux", i, &sch->demux[i].task, NULL, now, &first);
+    for (unsigned i = 0; i < sch->nb_dec; i++)
+        stats_print_task(bp, "dec", i, &sch->dec[i].task, sch->dec[i].queue, now, &first);
+    for (unsigned i = 0; i < sch->nb_filters; i++)
+        stats_print_task(bp, "filter", i, &sch->filters[i].task, sch->filters[i].queue, now, &first);
+    for (unsigned i = 0; i < sch->nb_enc; i++)
+        stats_print_task(bp, "enc", i, &sch->enc[i].task, sch->enc[i].queue, now, &first);
+    for (unsigned i = 0; i < sch->nb_mux; i++)
+        stats_print_task(bp, "mux", i, &sch->mux[i].task, sch->mux[i].queue, now, &first);
+
+    av_bprintf(bp, "]}");
+}
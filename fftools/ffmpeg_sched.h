@@ -85,6 +85,7 @@
  * knowledge about the whole transcoding pipeline.
  */
 
+struct AVBPrint;
 struct AVFrame;
 struct AVPacket;
 
@@ -298,6 +299,41 @@ int sch_mux_stream_ready(Scheduler *sch, unsigned mux_idx, unsigned stream_idx);
  */
 int sch_sdp_filename(Scheduler *sch, const char *sdp_filename);
 
+/**
+ * Limit the number of tasks that may execute concurrently.
+ *
+ * This is a concurrency limit, not a thread pool: every component still runs
+ * in its own thread, but at most nb_slots of them are allowed to do work at
+ * any given time. A task waiting inside the scheduler (for input, for space in
+ * a downstream queue or for being unchoked) does not count towards the limit.
+ * Must be called before sch_start().
+ *
+ * @param nb_slots maximum number of concurrently executing tasks, 0 (the
+ *                 default) for no limit
+ */
+int sch_set_run_slots(Scheduler *sch, unsigned nb_slots);
+
+/**
+ * Enable collecting per-task statistics, which can then be retrieved with
+ * sch_stats_print(). Must be called before sch_start().
+ */
+void sch_stats_enable(Scheduler *sch);
+
+/**
+ * Print a snapshot of the per-task statistics as a single-line JSON object.
+ *
+ * For every task, the following values are printed:
+ * - number of items currently waiting in its input queue, if any;
+ * - number of items received and sent;
+ * - time spent working and waiting for input, for space in downstream queues
+ *   (or being choked) and for a run slot (see sch_set_run_slots());
+ * - a histogram of the time spent processing each item, with bucket i
+ *   covering [2^i, 2^(i+1)) microseconds.
+ *
+ * May only be called after sch_stats_enable().
+ */
+void sch_stats_print(Scheduler *sch, struct AVBPrint *bp);
+
 /**
  * Add an encoder to the scheduler.
  *
@@ -20,7 +20,20 @@
 
 #include "config.h"
 
+#if HAVE_SCHED_SETAFFINITY
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE
+#endif
+#include <sched.h>
+#endif
+
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+#if HAVE_SETPROCESSAFFINITYMASK
+#include <windows.h>
+#endif
 
 #include "cmdutils.h"
 #include "opt_common.h"
@@ -1102,6 +1115,137 @@ int opt_cpucount(void *optctx, const char *opt, const char *arg)
     return ret;
 }
 
+#define CPUSET_MAX 1024
+
+/* parse a list like "0-3,8,10-11" into a bitmap of CPUSET_MAX bits */
+static int parse_cpu_list(uint8_t *cpus, const char *list)
+{
+    const char *p = list;
+    int nb_cpus = 0;
+
+    while (*p && !av_isspace(*p)) {
+        long first, last;
+        char *end;
+
+        first = last = strtol(p, &end, 10);
+        if (end == p || first < 0 || first >= CPUSET_MAX)
+            return AVERROR(EINVAL);
+        p = end;
+
+        if (*p == '-') {
+            last = strtol(++p, &end, 10);
+            if (end == p || last < first || last >= CPUSET_MAX)
+                return AVERROR(EINVAL);
+            p = end;
+        }
+
+        for (long i = first; i <= last; i++) {
+            nb_cpus += !(cpus[i >> 3] & (1 << (i & 7)));
+            cpus[i >> 3] |= 1 << (i & 7);
+        }
+
+        if (*p == ',')
+            p++;
+        else if (*p && !av_isspace(*p))
+            return AVERROR(EINVAL);
+    }
+
+    while (av_isspace(*p))
+        p++;
+
+    return (*p || !nb_cpus) ? AVERROR(EINVAL) : nb_cpus;
+}
+
+/* read the list of CPUs belonging to a NUMA node from sysfs */
+static int read_node_cpu_list(char *buf, size_t size, const char *node)
+{
+    char path[128];
+    char *end;
+    long idx;
+    FILE *f;
+    int ret = 0;
+
+    idx = strtol(node, &end, 10);
+    if (end == node || *end || idx < 0 || idx > INT_MAX)
+        return AVERROR(EINVAL);
+
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%ld/cpulist", idx);
+    f = fopen(path, "r");
+    if (!f)
+        return AVERROR(errno);
+
+    if (!fgets(buf, size, f))
+        ret = ferror(f) ? AVERROR(errno) : AVERROR_INVALIDDATA;
+
+    fclose(f);
+    return ret;
+}
+
+int opt_cpuset(void *optctx, const char *opt, const char *arg)
+{
+    uint8_t cpus[CPUSET_MAX / 8] = { 0 };
+    char node_cpus[1024];
+    const char *list = arg;
+    int ret;
+
+    if (av_strstart(arg, "node:", &list)) {
+        ret = read_node_cpu_list(node_cpus, sizeof(node_cpus), list);
+        if (ret < 0) {
+            av_log(NULL, AV_LOG_FATAL, "Cannot get the CPUs of NUMA node '%s': %s\n",
+                   list, av_err2str(ret));
+            return ret;
+        }
+        list = node_cpus;
+    }
+
+    ret = parse_cpu_list(cpus, list);
+    if (ret < 0) {
+        av_log(NULL, AV_LOG_FATAL, "Invalid CPU list '%s'\n", arg);
+        return ret;
+    }
+
+    {
+#if HAVE_SCHED_SETAFFINITY && defined(CPU_SET)
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        for (int i = 0; i < FFMIN(CPUSET_MAX, CPU_SETSIZE); i++)
+            if (cpus[i >> 3] & (1 << (i & 7)))
+                CPU_SET(i, &set);
+
+        /* this only applies to the calling thread, but every thread created
+         * afterwards (scheduler tasks, codec/filter/scaler workers) inherits
+         * it; global options are applied before any of those are started */
+        if (sched_setaffinity(0, sizeof(set), &set) < 0)
+            ret = AVERROR(errno);
+#elif HAVE_SETPROCESSAFFINITYMASK
+        DWORD_PTR mask = 0;
+
+        for (int i = 0; i < CPUSET_MAX; i++) {
+            if (!(cpus[i >> 3] & (1 << (i & 7))))
+                continue;
+            if (i >= sizeof(mask) * 8) {
+                ret = AVERROR(EINVAL);
+                break;
+            }
+            mask |= (DWORD_PTR)1 << i;
+        }
+
+        if (ret >= 0 && !SetProcessAffinityMask(GetCurrentProcess(), mask))
+            ret = AVERROR(EINVAL);
+#else
+        ret = AVERROR(ENOSYS);
+#endif
+    }
+    if (ret < 0) {
+        av_log(NULL, AV_LOG_FATAL, "Cannot set the CPU affinity to '%s': %s\n",
+               arg, av_err2str(ret));
+        return ret;
+    }
+
+    return 0;
+}
+
 static void expand_filename_template(AVBPrint *bp, const char *template,
                                      struct tm *tm)
 {
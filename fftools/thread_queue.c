@@ -16,6 +16,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <stdatomic.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -38,18 +39,49 @@ enum {
 };
 
 struct ThreadQueue {
-    int              *finished;
+    atomic_int       *finished;
     unsigned int    nb_streams;
 
     enum ThreadQueueType type;
 
+    // used unless THREAD_QUEUE_SINGLE_PRODUCER was specified,
+    // protected by lock
     AVContainerFifo *fifo;
     AVFifo          *fifo_stream_index;
 
     pthread_mutex_t lock;
     pthread_cond_t  cond;
+
+    /* Lock-free ring buffer used for THREAD_QUEUE_SINGLE_PRODUCER queues.
+     * Items in [head, tail) (modulo ring_size) belong to the consumer, the
+     * rest to the producer; only the consumer advances head and only the
+     * producer advances tail. lock/cond are then only used for parking the
+     * producer when the ring is full and the consumer when it is empty. */
+    void           **ring;
+    unsigned        *ring_stream_index;
+    size_t           ring_size;
+    atomic_size_t    head;
+    atomic_size_t    tail;
+    atomic_int       send_waiting;
+    atomic_int       recv_waiting;
 };
 
+static void item_move(const ThreadQueue *tq, void *dst, void *src)
+{
+    if (tq->type == THREAD_QUEUE_FRAMES)
+        av_frame_move_ref(dst, src);
+    else
+        av_packet_move_ref(dst, src);
+}
+
+static void item_unref(const ThreadQueue *tq, void *item)
+{
+    if (tq->type == THREAD_QUEUE_FRAMES)
+        av_frame_unref(item);
+    else
+        av_packet_unref(item);
+}
+
 void tq_free(ThreadQueue **ptq)
 {
     ThreadQueue *tq = *ptq;
@@ -60,6 +92,15 @@ void tq_free(ThreadQueue **ptq)
     av_container_fifo_free(&tq->fifo);
     av_fifo_freep2(&tq->fifo_stream_index);
 
+    for (size_t i = 0; tq->ring && i < tq->ring_size; i++) {
+        if (tq->type == THREAD_QUEUE_FRAMES)
+            av_frame_free((AVFrame**)&tq->ring[i]);
+        else
+            av_packet_free((AVPacket**)&tq->ring[i]);
+    }
+    av_freep(&tq->ring);
+    av_freep(&tq->ring_stream_index);
+
     av_freep(&tq->finished);
 
     pthread_cond_destroy(&tq->cond);
@@ -69,7 +110,7 @@ void tq_free(ThreadQueue **ptq)
 }
 
 ThreadQueue *tq_alloc(unsigned int nb_streams, size_t queue_size,
-                      enum ThreadQueueType type)
+                      enum ThreadQueueType type, unsigned int flags)
 {
     ThreadQueue *tq;
     int ret;
@@ -94,10 +135,34 @@ ThreadQueue *tq_alloc(unsigned int nb_streams, size_t queue_size,
     tq->finished = av_calloc(nb_streams, sizeof(*tq->finished));
     if (!tq->finished)
         goto fail;
+    for (unsigned int i = 0; i < nb_streams; i++)
+        atomic_init(&tq->finished[i], 0);
     tq->nb_streams = nb_streams;
 
     tq->type = type;
 
+    if (flags & THREAD_QUEUE_SINGLE_PRODUCER) {
+        tq->ring              = av_calloc(queue_size, sizeof(*tq->ring));
+        tq->ring_stream_index = av_calloc(queue_size, sizeof(*tq->ring_stream_index));
+        if (!tq->ring || !tq->ring_stream_index)
+            goto fail;
+        tq->ring_size = queue_size;
+
+        for (size_t i = 0; i < queue_size; i++) {
+            tq->ring[i] = (type == THREAD_QUEUE_FRAMES) ?
+                          (void*)av_frame_alloc() : (void*)av_packet_alloc();
+            if (!tq->ring[i])
+                goto fail;
+        }
+
+        atomic_init(&tq->head,         0);
+        atomic_init(&tq->tail,         0);
+        atomic_init(&tq->send_waiting, 0);
+        atomic_init(&tq->recv_waiting, 0);
+
+        return tq;
+    }
+
     tq->fifo = (type == THREAD_QUEUE_FRAMES) ?
                av_container_fifo_alloc_avframe(0) : av_container_fifo_alloc_avpacket(0);
     if (!tq->fifo)
@@ -113,27 +178,94 @@ fail:
     return NULL;
 }
 
-int tq_send(ThreadQueue *tq, unsigned int stream_idx, void *data)
+static void ring_wake(ThreadQueue *tq, atomic_int *waiting)
+{
+    /* The waiting side sets its flag before re-checking the ring state, while
+     * we have updated the ring state before checking the flag. Sequentially
+     * consistent ordering of both pairs then guarantees that either the waiter
+     * sees our update, or we see its flag and wake it up here. */
+    if (!atomic_load(waiting))
+        return;
+
+    pthread_mutex_lock(&tq->lock);
+    pthread_cond_broadcast(&tq->cond);
+    pthread_mutex_unlock(&tq->lock);
+}
+
+static int ring_full(ThreadQueue *tq, size_t tail)
 {
-    int *finished;
+    return tail - atomic_load(&tq->head) >= tq->ring_size;
+}
+
+static int ring_send(ThreadQueue *tq, unsigned int stream_idx, void *data,
+                     unsigned int flags)
+{
+    atomic_int *finished = &tq->finished[stream_idx];
+    size_t          tail = atomic_load_explicit(&tq->tail, memory_order_relaxed);
+
+    if (atomic_load(finished) & FINISHED_SEND)
+        return AVERROR(EINVAL);
+
+    while (1) {
+        if (atomic_load(finished) & FINISHED_RECV) {
+            atomic_fetch_or(finished, FINISHED_SEND);
+            return AVERROR_EOF;
+        }
+
+        if (!ring_full(tq, tail))
+            break;
+
+        if (flags & THREAD_QUEUE_NONBLOCK)
+            return AVERROR(EAGAIN);
+
+        pthread_mutex_lock(&tq->lock);
+        atomic_store(&tq->send_waiting, 1);
+        while (ring_full(tq, tail) && !(atomic_load(finished) & FINISHED_RECV))
+            pthread_cond_wait(&tq->cond, &tq->lock);
+        atomic_store(&tq->send_waiting, 0);
+        pthread_mutex_unlock(&tq->lock);
+    }
+
+    item_move(tq, tq->ring[tail % tq->ring_size], data);
+    tq->ring_stream_index[tail % tq->ring_size] = stream_idx;
+    atomic_store(&tq->tail, tail + 1);
+
+    ring_wake(tq, &tq->recv_waiting);
+
+    return 0;
+}
+
+int tq_send(ThreadQueue *tq, unsigned int stream_idx, void *data,
+            unsigned int flags)
+{
+    atomic_int *finished;
     int ret;
 
     av_assert0(stream_idx < tq->nb_streams);
     finished = &tq->finished[stream_idx];
 
+    if (tq->ring)
+        return ring_send(tq, stream_idx, data, flags);
+
     pthread_mutex_lock(&tq->lock);
 
-    if (*finished & FINISHED_SEND) {
+    if (atomic_load(finished) & FINISHED_SEND) {
         ret = AVERROR(EINVAL);
         goto finish;
     }
 
-    while (!(*finished & FINISHED_RECV) && !av_fifo_can_write(tq->fifo_stream_index))
+    while (!(atomic_load(finished) & FINISHED_RECV) &&
+           !av_fifo_can_write(tq->fifo_stream_index)) {
+        if (flags & THREAD_QUEUE_NONBLOCK) {
+            ret = AVERROR(EAGAIN);
+            goto finish;
+        }
         pthread_cond_wait(&tq->cond, &tq->lock);
+    }
 
-    if (*finished & FINISHED_RECV) {
+    if (atomic_load(finished) & FINISHED_RECV) {
         ret = AVERROR_EOF;
-        *finished |= FINISHED_SEND;
+        atomic_fetch_or(finished, FINISHED_SEND);
     } else {
         ret = av_fifo_write(tq->fifo_stream_index, &stream_idx, 1);
         if (ret < 0)
@@ -163,9 +295,8 @@ static int receive_locked(ThreadQueue *tq, int *stream_idx,
 
         ret = av_fifo_read(tq->fifo_stream_index, &idx, 1);
         av_assert0(ret >= 0);
-        if (tq->finished[idx] & FINISHED_RECV) {
-            (tq->type == THREAD_QUEUE_FRAMES) ?
-            av_frame_unref(data) : av_packet_unref(data);
+        if (atomic_load(&tq->finished[idx]) & FINISHED_RECV) {
+            item_unref(tq, data);
             continue;
         }
 
@@ -174,12 +305,14 @@ static int receive_locked(ThreadQueue *tq, int *stream_idx,
     }
 
     for (unsigned int i = 0; i < tq->nb_streams; i++) {
-        if (!tq->finished[i])
+        int finished = atomic_load(&tq->finished[i]);
+
+        if (!finished)
             continue;
 
         /* return EOF to the consumer at most once for each stream */
-        if (!(tq->finished[i] & FINISHED_RECV)) {
-            tq->finished[i] |= FINISHED_RECV;
+        if (!(finished & FINISHED_RECV)) {
+            atomic_fetch_or(&tq->finished[i], FINISHED_RECV);
             *stream_idx   = i;
             return AVERROR_EOF;
         }
@@ -190,12 +323,104 @@ static int receive_locked(ThreadQueue *tq, int *stream_idx,
     return nb_finished == tq->nb_streams ? AVERROR_EOF : AVERROR(EAGAIN);
 }
 
-int tq_receive(ThreadQueue *tq, int *stream_idx, void *data)
+static int ring_receive_nonblock(ThreadQueue *tq, int *stream_idx, void *data)
+{
+    size_t head = atomic_load_explicit(&tq->head, memory_order_relaxed);
+    unsigned int nb_finished = 0;
+    int eof_idx = -1;
+
+    /* Look at the EOF flags before the ring. The producer only marks a stream
+     * as finished after it is done sending to it, so all the items preceding
+     * an EOF we see here are already visible in the ring. */
+    for (unsigned int i = 0; i < tq->nb_streams; i++) {
+        int finished = atomic_load(&tq->finished[i]);
+
+        if (!finished)
+            continue;
+
+        if (!(finished & FINISHED_RECV)) {
+            if (eof_idx < 0)
+                eof_idx = i;
+        } else
+            nb_finished++;
+    }
+
+    while (head != atomic_load(&tq->tail)) {
+        void      *item = tq->ring[head % tq->ring_size];
+        unsigned    idx = tq->ring_stream_index[head % tq->ring_size];
+        int     discard = atomic_load(&tq->finished[idx]) & FINISHED_RECV;
+
+        if (discard)
+            item_unref(tq, item);
+        else
+            item_move(tq, data, item);
+
+        atomic_store(&tq->head, ++head);
+        ring_wake(tq, &tq->send_waiting);
+
+        if (!discard) {
+            *stream_idx = idx;
+            return 0;
+        }
+    }
+
+    /* return EOF to the consumer at most once for each stream */
+    if (eof_idx >= 0) {
+        atomic_fetch_or(&tq->finished[eof_idx], FINISHED_RECV);
+        *stream_idx = eof_idx;
+        return AVERROR_EOF;
+    }
+
+    return nb_finished == tq->nb_streams ? AVERROR_EOF : AVERROR(EAGAIN);
+}
+
+// whether ring_receive_nonblock() would return something other than EAGAIN
+static int ring_can_receive(ThreadQueue *tq)
+{
+    unsigned int nb_finished = 0;
+
+    if (atomic_load(&tq->head) != atomic_load(&tq->tail))
+        return 1;
+
+    for (unsigned int i = 0; i < tq->nb_streams; i++) {
+        int finished = atomic_load(&tq->finished[i]);
+
+        if (finished && !(finished & FINISHED_RECV))
+            return 1;
+        nb_finished += !!finished;
+    }
+
+    return nb_finished == tq->nb_streams;
+}
+
+static int ring_receive(ThreadQueue *tq, int *stream_idx, void *data,
+                        unsigned int flags)
+{
+    while (1) {
+        int ret = ring_receive_nonblock(tq, stream_idx, data);
+
+        if (ret != AVERROR(EAGAIN) || (flags & THREAD_QUEUE_NONBLOCK))
+            return ret;
+
+        pthread_mutex_lock(&tq->lock);
+        atomic_store(&tq->recv_waiting, 1);
+        while (!ring_can_receive(tq))
+            pthread_cond_wait(&tq->cond, &tq->lock);
+        atomic_store(&tq->recv_waiting, 0);
+        pthread_mutex_unlock(&tq->lock);
+    }
+}
+
+int tq_receive(ThreadQueue *tq, int *stream_idx, void *data,
+               unsigned int flags)
 {
     int ret;
 
     *stream_idx = -1;
 
+    if (tq->ring)
+        return ring_receive(tq, stream_idx, data, flags);
+
     pthread_mutex_lock(&tq->lock);
 
     while (1) {
@@ -207,7 +432,7 @@ int tq_receive(ThreadQueue *tq, int *stream_idx, void *data)
         if (can_read != av_container_fifo_can_read(tq->fifo))
             pthread_cond_broadcast(&tq->cond);
 
-        if (ret == AVERROR(EAGAIN)) {
+        if (ret == AVERROR(EAGAIN) && !(flags & THREAD_QUEUE_NONBLOCK)) {
             pthread_cond_wait(&tq->cond, &tq->lock);
             continue;
         }
@@ -229,7 +454,7 @@ void tq_send_finish(ThreadQueue *tq, unsigned int stream_idx)
     /* mark the stream as send-finished;
      * next time the consumer thread tries to read this stream it will get
      * an EOF and recv-finished flag will be set */
-    tq->finished[stream_idx] |= FINISHED_SEND;
+    atomic_fetch_or(&tq->finished[stream_idx], FINISHED_SEND);
     pthread_cond_broadcast(&tq->cond);
 
     pthread_mutex_unlock(&tq->lock);
@@ -244,8 +469,22 @@ void tq_receive_finish(ThreadQueue *tq, unsigned int stream_idx)
     /* mark the stream as recv-finished;
      * next time the producer thread tries to send for this stream, it will
      * get an EOF and send-finished flag will be set */
-    tq->finished[stream_idx] |= FINISHED_RECV;
+    atomic_fetch_or(&tq->finished[stream_idx], FINISHED_RECV);
     pthread_cond_broadcast(&tq->cond);
 
     pthread_mutex_unlock(&tq->lock);
 }
+
+size_t tq_nb_items(ThreadQueue *tq)
+{
+    size_t ret;
+
+    if (tq->ring)
+        return atomic_load(&tq->tail) - atomic_load(&tq->head);
+
+    pthread_mutex_lock(&tq->lock);
+    ret = av_container_fifo_can_read(tq->fifo);
+    pthread_mutex_unlock(&tq->lock);
+
+    return ret;
+}
@@ -26,6 +26,22 @@ enum ThreadQueueType {
     THREAD_QUEUE_PACKETS,
 };
 
+enum ThreadQueueFlags {
+    /**
+     * Return AVERROR(EAGAIN) instead of waiting when the operation cannot be
+     * completed immediately.
+     */
+    THREAD_QUEUE_NONBLOCK = (1 << 0),
+    /**
+     * For tq_alloc(): items will never be sent to the queue from more than
+     * one thread at a time, though the sending thread may change as long as
+     * the callers synchronize between themselves. Such queues are implemented
+     * with a lock-free ring buffer and only lock when the consumer has to
+     * wait for an item or the producer for free space.
+     */
+    THREAD_QUEUE_SINGLE_PRODUCER = (1 << 1),
+};
+
 typedef struct ThreadQueue ThreadQueue;
 
 /**
@@ -35,9 +51,10 @@ typedef struct ThreadQueue ThreadQueue;
  *                   maintained
  * @param queue_size number of items that can be stored in the queue without
  *                   blocking
+ * @param flags a combination of ThreadQueueFlags
  */
 ThreadQueue *tq_alloc(unsigned int nb_streams, size_t queue_size,
-                      enum ThreadQueueType type);
+                      enum ThreadQueueType type, unsigned int flags);
 void         tq_free(ThreadQueue **tq);
 
 /**
@@ -46,13 +63,16 @@ void         tq_free(ThreadQueue **tq);
  * @param data the item to send, its contents will be moved using the callback
  *             provided to tq_alloc(); on failure the item will be left
  *             untouched
+ * @param flags a combination of ThreadQueueFlags
  * @return
  * - 0 the item was successfully sent
  * - AVERROR(ENOMEM) could not allocate an item for writing to the FIFO
  * - AVERROR(EINVAL) the sending side has previously been marked as finished
  * - AVERROR_EOF the receiving side has marked the given stream as finished
+ * - AVERROR(EAGAIN) the queue is full and THREAD_QUEUE_NONBLOCK was set
  */
-int tq_send(ThreadQueue *tq, unsigned int stream_idx, void *data);
+int tq_send(ThreadQueue *tq, unsigned int stream_idx, void *data,
+            unsigned int flags);
 /**
  * Mark the given stream finished from the sending side.
  */
@@ -65,17 +85,27 @@ void tq_send_finish(ThreadQueue *tq, unsigned int stream_idx);
  *                   written here
  * @param data the data item will be written here on success using the
  *             callback provided to tq_alloc()
+ * @param flags a combination of ThreadQueueFlags
  * @return
  * - 0 a data item was successfully read; *stream_idx contains a non-negative
  *   stream index
  * - AVERROR_EOF When *stream_idx is non-negative, this signals that the sending
  *   side has marked the given stream as finished. This will happen at most once
  *   for each stream. When *stream_idx is -1, all streams are done.
+ * - AVERROR(EAGAIN) nothing is available and THREAD_QUEUE_NONBLOCK was set
  */
-int tq_receive(ThreadQueue *tq, int *stream_idx, void *data);
+int tq_receive(ThreadQueue *tq, int *stream_idx, void *data,
+               unsigned int flags);
 /**
  * Mark the given stream finished from the receiving side.
  */
 void tq_receive_finish(ThreadQueue *tq, unsigned int stream_idx);
 
+/**
+ * @return number of items currently stored in the queue; only meant for
+ *         informational purposes, since the value may be outdated by the time
+ *         this function returns
+ */
+size_t tq_nb_items(ThreadQueue *tq);
+
 #endif // FFTOOLS_THREAD_QUEUE_H
@@ -795,6 +795,54 @@ static void put_bitstream_info(AACEncContext *s, const char *name)
     put_bits(&s->pb, 12 - padbits, 0);
 }
 
+/**
+ * Run the parts of the coefficient coding search that only depend on the
+ * channel element itself: the quantizer search and TNS.
+ */
+static void search_element(AVCodecContext *avctx, AACEncContext *s,
+                           int el, int start_ch)
+{
+    ChannelElement *cpe = &s->cpe[el];
+    int tag   = s->chan_map[el + 1];
+    int chans = tag == TYPE_CPE ? 2 : 1;
+    int ch;
+
+    s->psy.bitres.alloc = cpe->bitres_alloc;
+    s->cur_type = tag;
+    for (ch = 0; ch < chans; ch++) {
+        s->cur_channel = start_ch + ch;
+        if (s->options.pns && s->coder->mark_pns)
+            s->coder->mark_pns(s, avctx, &cpe->ch[ch]);
+        s->coder->search_for_quantizers(avctx, s, &cpe->ch[ch], s->lambda);
+    }
+    for (ch = 0; ch < chans; ch++) { /* TNS */
+        SingleChannelElement *sce = &cpe->ch[ch];
+        s->cur_channel = start_ch + ch;
+        if (s->options.tns && s->coder->search_for_tns)
+            s->coder->search_for_tns(s, sce);
+        if (s->options.tns && s->coder->apply_tns_filt)
+            s->coder->apply_tns_filt(s, sce);
+    }
+}
+
+static int search_element_job(AVCodecContext *avctx, void *arg,
+                              int el, int threadnr)
+{
+    AACEncContext *s = avctx->priv_data;
+    AACEncContext *w = &s->workers[threadnr];
+    int start_ch = 0;
+
+    for (int i = 0; i < el; i++)
+        start_ch += s->chan_map[i + 1] == TYPE_CPE ? 2 : 1;
+
+    w->lambda     = s->lambda;
+    w->psy.cutoff = s->psy.cutoff;
+    search_element(avctx, w, el, start_ch);
+    s->cpe[el].psy_cutoff = w->psy.cutoff;
+
+    return 0;
+}
+
 /*
  * Copy input samples.
  * Channels are reordered from libavcodec's default order to AAC order.
@@ -833,6 +881,7 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
     int target_bits, rate_bits, too_many_bits, too_few_bits;
     int ms_mode = 0, is_mode = 0, tns_mode = 0, pred_mode = 0;
     int chan_el_counter[4];
+    int threaded;
     FFPsyWindowInfo windows[AAC_MAX_CHANNELS];
 
     /* add current frame to queue */
@@ -851,6 +900,11 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
     if (!avctx->frame_num)
         return 0;
 
+    /* The coder picks the psy cutoff on its first run and keeps it constant
+     * afterwards. The first frame is searched serially so that every element
+     * is analyzed with the same cutoff as in the single-threaded case. */
+    threaded = s->nb_workers && avctx->frame_num > 1;
+
     start_ch = 0;
     for (i = 0; i < s->chan_map[0]; i++) {
         FFPsyWindowInfo* wi = windows + start_ch;
@@ -950,7 +1004,6 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
             put_bitstream_info(s, LIBAVCODEC_IDENT);
         start_ch = 0;
         target_bits = 0;
-        memset(chan_el_counter, 0, sizeof(chan_el_counter));
         for (i = 0; i < s->chan_map[0]; i++) {
             FFPsyWindowInfo* wi = windows + start_ch;
             const float *coeffs[2];
@@ -960,8 +1013,6 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
             cpe->common_window = 0;
             memset(cpe->is_mask, 0, sizeof(cpe->is_mask));
             memset(cpe->ms_mask, 0, sizeof(cpe->ms_mask));
-            put_bits(&s->pb, 3, tag);
-            put_bits(&s->pb, 4, chan_el_counter[tag]++);
             for (ch = 0; ch < chans; ch++) {
                 sce = &cpe->ch[ch];
                 coeffs[ch] = sce->coeffs;
@@ -979,13 +1030,26 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                     * (s->lambda / (avctx->global_quality ? avctx->global_quality : 120));
                 s->psy.bitres.alloc /= chans;
             }
+            cpe->bitres_alloc = s->psy.bitres.alloc;
+            if (!threaded)
+                search_element(avctx, s, i, start_ch);
+            start_ch += chans;
+        }
+        if (threaded) {
+            avctx->execute2(avctx, search_element_job, NULL, NULL, s->chan_map[0]);
+            s->psy.cutoff = s->cpe[s->chan_map[0] - 1].psy_cutoff;
+        }
+
+        start_ch = 0;
+        memset(chan_el_counter, 0, sizeof(chan_el_counter));
+        for (i = 0; i < s->chan_map[0]; i++) {
+            FFPsyWindowInfo* wi = windows + start_ch;
+            tag      = s->chan_map[i+1];
+            chans    = tag == TYPE_CPE ? 2 : 1;
+            cpe      = &s->cpe[i];
+            put_bits(&s->pb, 3, tag);
+            put_bits(&s->pb, 4, chan_el_counter[tag]++);
             s->cur_type = tag;
-            for (ch = 0; ch < chans; ch++) {
-                s->cur_channel = start_ch + ch;
-                if (s->options.pns && s->coder->mark_pns)
-                    s->coder->mark_pns(s, avctx, &cpe->ch[ch]);
-                s->coder->search_for_quantizers(avctx, s, &cpe->ch[ch], s->lambda);
-            }
             if (chans > 1
                 && wi[0].window_type[0] == wi[1].window_type[0]
                 && wi[0].window_shape   == wi[1].window_shape) {
@@ -998,13 +1062,9 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                     }
                 }
             }
-            for (ch = 0; ch < chans; ch++) { /* TNS and PNS */
+            for (ch = 0; ch < chans; ch++) { /* PNS */
                 sce = &cpe->ch[ch];
                 s->cur_channel = start_ch + ch;
-                if (s->options.tns && s->coder->search_for_tns)
-                    s->coder->search_for_tns(s, sce);
-                if (s->options.tns && s->coder->apply_tns_filt)
-                    s->coder->apply_tns_filt(s, sce);
                 if (sce->tns.present)
                     tns_mode = 1;
                 if (s->options.pns && s->coder->search_for_pns)
@@ -1141,6 +1201,9 @@ static av_cold int aac_encode_end(AVCodecContext *avctx)
     av_tx_uninit(&s->mdct128);
     ff_psy_end(&s->psy);
     ff_lpc_end(&s->lpc);
+    for (int i = 0; i < s->nb_workers; i++)
+        ff_lpc_end(&s->workers[i].lpc);
+    av_freep(&s->workers);
     if (s->psypp)
         ff_psy_preprocess_end(s->psypp);
     av_freep(&s->buffer.samples);
@@ -1182,6 +1245,31 @@ static av_cold int alloc_buffers(AVCodecContext *avctx, AACEncContext *s)
     return 0;
 }
 
+static av_cold int init_workers(AVCodecContext *avctx, AACEncContext *s)
+{
+    int ret;
+
+    s->workers = av_calloc(avctx->thread_count, sizeof(*s->workers));
+    if (!s->workers)
+        return AVERROR(ENOMEM);
+
+    for (int i = 0; i < avctx->thread_count; i++) {
+        AACEncContext *w = &s->workers[i];
+
+        *w = *s;
+        w->workers    = NULL;
+        w->nb_workers = 0;
+        memset(&w->lpc, 0, sizeof(w->lpc));
+        s->nb_workers++;
+
+        ret = ff_lpc_init(&w->lpc, 2*avctx->frame_size, TNS_MAX_ORDER, FF_LPC_TYPE_LEVINSON);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 static av_cold int aac_encode_init(AVCodecContext *avctx)
 {
     AACEncContext *s = avctx->priv_data;
@@ -1302,6 +1390,13 @@ static av_cold int aac_encode_init(AVCodecContext *avctx)
 
     ff_af_queue_init(avctx, &s->afq);
 
+    /* channel elements are searched concurrently */
+    if (avctx->active_thread_type & FF_THREAD_SLICE &&
+        avctx->thread_count > 1 && s->chan_map[0] > 1) {
+        if ((ret = init_workers(avctx, s)) < 0)
+            return ret;
+    }
+
     return 0;
 }
 
@@ -1337,7 +1432,7 @@ const FFCodec ff_aac_encoder = {
     .p.type         = AVMEDIA_TYPE_AUDIO,
     .p.id           = AV_CODEC_ID_AAC,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
-                      AV_CODEC_CAP_SMALL_LAST_FRAME,
+                      AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_SLICE_THREADS,
     .priv_data_size = sizeof(AACEncContext),
     .init           = aac_encode_init,
     FF_CODEC_ENCODE_CB(aac_encode_frame),
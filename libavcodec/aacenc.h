@@ -132,6 +132,8 @@ typedef struct ChannelElement {
     uint8_t ms_mask[128];     ///< Set if mid/side stereo is used for each scalefactor window band
     uint8_t is_mask[128];     ///< Set if intensity stereo is used
     // shared
+    int bitres_alloc;         ///< per-channel bit allocation from the psychoacoustic model
+    int psy_cutoff;           ///< psy bandwidth chosen by the coder for this element
     SingleChannelElement ch[2];
 } ChannelElement;
 
@@ -221,6 +223,9 @@ typedef struct AACEncContext {
     struct {
         float *samples;
     } buffer;
+
+    struct AACEncContext *workers;               ///< per-thread coder contexts for slice threading
+    int nb_workers;
 } AACEncContext;
 
 void ff_quantize_band_cost_cache_init(struct AACEncContext *s);
@@ -1395,6 +1395,21 @@ static int bit_alloc(AC3EncodeContext *s, int snr_offset)
 }
 
 
+/*
+ * Return the number of mantissa bits for the given SNR offset, using the
+ * worker cache filled by an earlier search over the same frame if possible.
+ * The bit allocation pointers are only valid if bit_alloc() has been called.
+ */
+static int bit_alloc_cached(AC3EncodeContext *s, int snr_offset)
+{
+    if (!s->mant_bits_cache)
+        return bit_alloc(s, snr_offset);
+    if (s->mant_bits_cache[snr_offset] < 0)
+        s->mant_bits_cache[snr_offset] = bit_alloc(s, snr_offset);
+    return s->mant_bits_cache[snr_offset];
+}
+
+
 /*
  * Constant bitrate bit allocation search.
  * Find the largest SNR offset that will allow data to fit in the frame.
@@ -1414,12 +1429,12 @@ static int cbr_bit_allocation(AC3EncodeContext *s)
     /* if previous frame SNR offset was 1023, check if current frame can also
        use SNR offset of 1023. if so, skip the search. */
     if ((snr_offset | s->fine_snr_offset[1]) == 1023) {
-        if (bit_alloc(s, 1023) <= bits_left)
+        if (bit_alloc_cached(s, 1023) <= bits_left)
             return 0;
     }
 
     while (snr_offset >= 0 &&
-           bit_alloc(s, snr_offset) > bits_left) {
+           bit_alloc_cached(s, snr_offset) > bits_left) {
         snr_offset -= 64;
     }
     if (snr_offset < 0)
@@ -1428,7 +1443,7 @@ static int cbr_bit_allocation(AC3EncodeContext *s)
     FFSWAP(uint8_t *, s->bap_buffer, s->bap1_buffer);
     for (snr_incr = 64; snr_incr > 0; snr_incr >>= 2) {
         while (snr_offset + snr_incr <= 1023 &&
-               bit_alloc(s, snr_offset + snr_incr) <= bits_left) {
+               bit_alloc_cached(s, snr_offset + snr_incr) <= bits_left) {
             snr_offset += snr_incr;
             FFSWAP(uint8_t *, s->bap_buffer, s->bap1_buffer);
         }
@@ -1982,12 +1997,199 @@ static void ac3_output_frame(AC3EncodeContext *s, unsigned char *frame)
     output_frame_end(s, &pb);
 }
 
+static int set_packet_props(AVCodecContext *avctx, AVPacket *avpkt,
+                            const AVFrame *frame)
+{
+    if (frame->pts != AV_NOPTS_VALUE)
+        avpkt->pts = frame->pts - ff_samples_to_time_base(avctx, avctx->initial_padding);
+    avpkt->duration = frame->duration ? frame->duration :
+                      ff_samples_to_time_base(avctx, frame->nb_samples);
+
+    return ff_encode_reordered_opaque(avctx, avpkt, frame);
+}
+
+/*
+ * Hand the next input frame to a worker. Everything depending on the
+ * previous frames is resolved here, in coding order.
+ */
+static int queue_frame(AVCodecContext *avctx, const AVFrame *frame)
+{
+    AC3EncodeContext *s = avctx->priv_data;
+    AC3EncodeContext *w = &s->workers[s->nb_queued];
+    const unsigned sampletype_size = SAMPLETYPE_SIZE(s);
+    const int last_block = (s->num_blocks - 1) * AC3_BLOCK_SIZE;
+    int ret;
+
+    if (s->options.allow_per_frame_metadata) {
+        ret = ac3_validate_metadata(s);
+        if (ret)
+            return ret;
+        w->options                 = s->options;
+        w->bitstream_id            = s->bitstream_id;
+        w->center_mix_level        = s->center_mix_level;
+        w->surround_mix_level      = s->surround_mix_level;
+        w->ltrt_center_mix_level   = s->ltrt_center_mix_level;
+        w->ltrt_surround_mix_level = s->ltrt_surround_mix_level;
+        w->loro_center_mix_level   = s->loro_center_mix_level;
+        w->loro_surround_mix_level = s->loro_surround_mix_level;
+    }
+
+    if (s->bit_alloc.sr_code == 1 || s->eac3)
+        ac3_adjust_frame_size(s);
+    w->frame_size = s->frame_size;
+
+    /* the MDCT of the first block overlaps the last block of the previous frame */
+    for (int ch = 0; ch < s->channels; ch++) {
+        memcpy(w->planar_samples[ch], s->planar_samples[ch],
+               AC3_BLOCK_SIZE * sampletype_size);
+        memcpy(s->planar_samples[ch],
+               frame->extended_data[s->channel_map[ch]] + last_block * sampletype_size,
+               AC3_BLOCK_SIZE * sampletype_size);
+    }
+
+    ret = av_frame_ref(s->queued_frames[s->nb_queued], frame);
+    if (ret < 0)
+        return ret;
+    s->nb_queued++;
+
+    return 0;
+}
+
+static int analyze_frame_worker(AVCodecContext *avctx, void *arg)
+{
+    AC3EncodeContext *s = arg;
+
+    s->encode_frame(s, s->in_frame->extended_data);
+
+    ac3_apply_rematrixing(s);
+
+    ac3_process_exponents(s);
+
+    /* The search result depends on the SNR offset it starts from, which is
+     * only known once the previous frame is done. Searching from the last
+     * known offset fills the cache for the final search in coding order. */
+    memset(s->mant_bits_cache, -1, 1024 * sizeof(*s->mant_bits_cache));
+    ac3_compute_bit_allocation(s);
+
+    return 0;
+}
+
+static int output_frame_worker(AVCodecContext *avctx, void *arg)
+{
+    AC3EncodeContext *s = arg;
+
+    /* the final search may have been served from the cache */
+    bit_alloc(s, s->coarse_snr_offset << 4 | s->fine_snr_offset[1]);
+
+    ac3_group_exponents(s);
+
+    ac3_quantize_mantissas(s);
+
+    av_fast_malloc(&s->out_buf, &s->out_buf_size, s->frame_size);
+    if (!s->out_buf) {
+        s->out_bytes = AVERROR(ENOMEM);
+        return 0;
+    }
+    ac3_output_frame(s, s->out_buf);
+    s->out_bytes = s->frame_size;
+
+    return 0;
+}
+
+static int encode_queued_frames(AVCodecContext *avctx)
+{
+    AC3EncodeContext *s = avctx->priv_data;
+    int ret;
+
+    for (int i = 0; i < s->nb_queued; i++) {
+        AC3EncodeContext *w = &s->workers[i];
+
+        w->coarse_snr_offset  = s->coarse_snr_offset;
+        w->fine_snr_offset[1] = s->fine_snr_offset[1];
+        av_frame_move_ref(w->in_frame, s->queued_frames[i]);
+    }
+
+    avctx->execute(avctx, analyze_frame_worker, s->workers, NULL,
+                   s->nb_queued, sizeof(*s->workers));
+
+    for (int i = 0; i < s->nb_queued; i++) {
+        AC3EncodeContext *w = &s->workers[i];
+
+        w->coarse_snr_offset  = s->coarse_snr_offset;
+        w->fine_snr_offset[1] = s->fine_snr_offset[1];
+        ret = cbr_bit_allocation(w);
+        if (ret) {
+            av_log(avctx, AV_LOG_ERROR, "Bit allocation failed. Try increasing the bitrate.\n");
+            return ret;
+        }
+        s->coarse_snr_offset  = w->coarse_snr_offset;
+        s->fine_snr_offset[1] = w->fine_snr_offset[1];
+    }
+
+    avctx->execute(avctx, output_frame_worker, s->workers, NULL,
+                   s->nb_queued, sizeof(*s->workers));
+
+    for (int i = 0; i < s->nb_queued; i++)
+        if (s->workers[i].out_bytes < 0)
+            return s->workers[i].out_bytes;
+
+    s->nb_encoded   = s->nb_queued;
+    s->next_encoded = 0;
+    s->nb_queued    = 0;
+
+    return 0;
+}
+
+static int encode_frame_threaded(AVCodecContext *avctx, AVPacket *avpkt,
+                                 const AVFrame *frame, int *got_packet_ptr)
+{
+    AC3EncodeContext *s = avctx->priv_data;
+    int ret;
+
+    if (frame) {
+        ret = queue_frame(avctx, frame);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (s->next_encoded == s->nb_encoded && s->nb_queued &&
+        (s->nb_queued == s->nb_workers || !frame)) {
+        ret = encode_queued_frames(avctx);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (s->next_encoded < s->nb_encoded) {
+        AC3EncodeContext *w = &s->workers[s->next_encoded++];
+
+        ret = ff_get_encode_buffer(avctx, avpkt, w->out_bytes, 0);
+        if (ret < 0)
+            return ret;
+        memcpy(avpkt->data, w->out_buf, w->out_bytes);
+
+        ret = set_packet_props(avctx, avpkt, w->in_frame);
+        av_frame_unref(w->in_frame);
+        if (ret < 0)
+            return ret;
+
+        *got_packet_ptr = 1;
+    }
+
+    return 0;
+}
+
 int ff_ac3_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                         const AVFrame *frame, int *got_packet_ptr)
 {
     AC3EncodeContext *const s = avctx->priv_data;
     int ret;
 
+    if (s->nb_workers)
+        return encode_frame_threaded(avctx, avpkt, frame, got_packet_ptr);
+
+    if (!frame)
+        return 0;
+
     if (s->options.allow_per_frame_metadata) {
         ret = ac3_validate_metadata(s);
         if (ret)
@@ -2018,8 +2220,9 @@ int ff_ac3_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
         return ret;
     ac3_output_frame(s, avpkt->data);
 
-    if (frame->pts != AV_NOPTS_VALUE)
-        avpkt->pts = frame->pts - ff_samples_to_time_base(avctx, avctx->initial_padding);
+    ret = set_packet_props(avctx, avpkt, frame);
+    if (ret < 0)
+        return ret;
 
     *got_packet_ptr = 1;
     return 0;
@@ -2150,15 +2353,11 @@ static void dprint_options(AC3EncodeContext *s)
 #endif
 }
 
-/**
- * Finalize encoding and free any memory allocated by the encoder.
- *
- * @param avctx  Codec context
+/*
+ * Free the buffers and transform owned by one encoding context.
  */
-av_cold int ff_ac3_encode_close(AVCodecContext *avctx)
+static av_cold void free_buffers(AC3EncodeContext *s)
 {
-    AC3EncodeContext *s = avctx->priv_data;
-
     for (int ch = 0; ch < s->channels; ch++)
         av_freep(&s->planar_samples[ch]);
     av_freep(&s->bap_buffer);
@@ -2172,9 +2371,32 @@ av_cold int ff_ac3_encode_close(AVCodecContext *avctx)
     av_freep(&s->mask_buffer);
     av_freep(&s->qmant_buffer);
     av_freep(&s->cpl_coord_buffer);
-    av_freep(&s->fdsp);
-
     av_tx_uninit(&s->tx);
+}
+
+/**
+ * Finalize encoding and free any memory allocated by the encoder.
+ *
+ * @param avctx  Codec context
+ */
+av_cold int ff_ac3_encode_close(AVCodecContext *avctx)
+{
+    AC3EncodeContext *s = avctx->priv_data;
+
+    for (int i = 0; i < s->nb_workers; i++) {
+        AC3EncodeContext *w = &s->workers[i];
+
+        free_buffers(w);
+        av_frame_free(&w->in_frame);
+        av_freep(&w->mant_bits_cache);
+        av_freep(&w->out_buf);
+        av_frame_free(&s->queued_frames[i]);
+    }
+    av_freep(&s->workers);
+    av_freep(&s->queued_frames);
+
+    free_buffers(s);
+    av_freep(&s->fdsp);
 
     return 0;
 }
@@ -2473,6 +2695,61 @@ static av_cold int allocate_buffers(AC3EncodeContext *s)
 }
 
 
+/*
+ * Set up one copy of the encoder state per slice thread for encoding
+ * consecutive frames in parallel. The DSP contexts are shared, the buffers
+ * and the MDCT are private to each worker.
+ */
+static av_cold int init_workers(AVCodecContext *avctx)
+{
+    AC3EncodeContext *s = avctx->priv_data;
+    int ret;
+
+    s->workers       = av_calloc(avctx->thread_count, sizeof(*s->workers));
+    s->queued_frames = av_calloc(avctx->thread_count, sizeof(*s->queued_frames));
+    if (!s->workers || !s->queued_frames)
+        return AVERROR(ENOMEM);
+
+    for (int i = 0; i < avctx->thread_count; i++) {
+        AC3EncodeContext *w = &s->workers[i];
+
+        *w = *s;
+        memset(w->planar_samples, 0, sizeof(w->planar_samples));
+        w->bap_buffer         = NULL;
+        w->bap1_buffer        = NULL;
+        w->mdct_coef_buffer   = NULL;
+        w->fixed_coef_buffer  = NULL;
+        w->exp_buffer         = NULL;
+        w->grouped_exp_buffer = NULL;
+        w->psd_buffer         = NULL;
+        w->band_psd_buffer    = NULL;
+        w->mask_buffer        = NULL;
+        w->qmant_buffer       = NULL;
+        w->cpl_coord_buffer   = NULL;
+        w->tx                 = NULL;
+        w->ref_bap_set        = 0;
+        w->workers            = NULL;
+        w->queued_frames      = NULL;
+        w->nb_workers         = 0;
+        s->nb_workers++;
+
+        ret = allocate_buffers(w);
+        if (ret)
+            return ret;
+        ret = w->mdct_init(w);
+        if (ret < 0)
+            return ret;
+
+        w->in_frame         = av_frame_alloc();
+        s->queued_frames[i] = av_frame_alloc();
+        w->mant_bits_cache  = av_malloc_array(1024, sizeof(*w->mant_bits_cache));
+        if (!w->in_frame || !s->queued_frames[i] || !w->mant_bits_cache)
+            return AVERROR(ENOMEM);
+    }
+
+    return 0;
+}
+
 av_cold int ff_ac3_encode_init(AVCodecContext *avctx)
 {
     static AVOnce init_static_once = AV_ONCE_INIT;
@@ -2518,6 +2795,12 @@ av_cold int ff_ac3_encode_init(AVCodecContext *avctx)
     ff_me_cmp_init(&s->mecc, avctx);
     ff_ac3dsp_init(&s->ac3dsp);
 
+    if (avctx->active_thread_type & FF_THREAD_SLICE && avctx->thread_count > 1) {
+        ret = init_workers(avctx);
+        if (ret < 0)
+            return ret;
+    }
+
     dprint_options(s);
 
     ff_thread_once(&init_static_once, exponent_init);
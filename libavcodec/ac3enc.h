@@ -254,6 +254,7 @@ typedef struct AC3EncodeContext {
 
     /** fixed vs. float function pointers */
     void (*encode_frame)(struct AC3EncodeContext *s, uint8_t * const *samples);
+    int  (*mdct_init)(struct AC3EncodeContext *s);
 
     /* AC-3 vs. E-AC-3 function pointers */
     void (*output_frame_header)(struct AC3EncodeContext *s, struct PutBitContext *pb);
@@ -266,6 +267,29 @@ typedef struct AC3EncodeContext {
         DECLARE_ALIGNED(32, float,   windowed_samples_float)[AC3_WINDOW_SIZE];
         DECLARE_ALIGNED(32, int32_t, windowed_samples_fixed)[AC3_WINDOW_SIZE];
     };
+
+    /**
+     * Frame-parallel encoding with slice threads: up to nb_workers input
+     * frames are queued and then encoded concurrently, each one by its own
+     * copy of this context. Everything that carries over from one frame to
+     * the next (MDCT overlap, frame size, metadata) is set up by the main
+     * context when a frame is queued. The bit allocation search starts from
+     * the SNR offset of the previous frame, so it is repeated in coding
+     * order, reusing the bit counts the workers cached.
+     */
+    struct AC3EncodeContext *workers;
+    int nb_workers;
+    AVFrame **queued_frames;
+    int nb_queued;
+    int nb_encoded;                         ///< number of workers holding an encoded frame
+    int next_encoded;                       ///< next worker to output a packet from
+
+    /* worker state */
+    AVFrame *in_frame;
+    int *mant_bits_cache;                   ///< mantissa bits per SNR offset, -1 if unknown
+    uint8_t *out_buf;
+    unsigned int out_buf_size;
+    int out_bytes;                          ///< size of the encoded frame or error code
 } AC3EncodeContext;
 
 extern const AVChannelLayout ff_ac3_ch_layouts[19];
@@ -358,6 +358,14 @@ typedef struct RcOverride{
  * Show all frames before the first keyframe
  */
 #define AV_CODEC_FLAG2_SHOW_ALL       (1 << 22)
+/**
+ * Decode keyframes only and output each of them as soon as it is decoded.
+ * Packets without AV_PKT_FLAG_KEY are dropped before reaching the decoder,
+ * frame threading is disabled and the decoders do not delay output for
+ * reordering. Intended for thumbnail and preview generation; combine with
+ * skip_loop_filter to also skip in-loop filtering.
+ */
+#define AV_CODEC_FLAG2_KEYFRAMES_ONLY (1 << 23)
 /**
  * Export motion vectors through frame side data
  */
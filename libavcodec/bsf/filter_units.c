@@ -195,6 +195,8 @@ static int filter_units_init(AVBSFContext *bsf)
         // Don't actually decompose anything, we only want the unit data.
         ctx->cbc->decompose_unit_types    = ctx->type_list;
         ctx->cbc->nb_decompose_unit_types = 0;
+        // Packets in which no unit is removed can then be returned as-is.
+        ctx->cbc->write_unchanged_by_ref  = 1;
     }
 
     if (bsf->par_in->extradata) {
@@ -165,6 +165,8 @@ static void cbs_unit_uninit(CodedBitstreamUnit *unit)
     unit->data             = NULL;
     unit->data_size        = 0;
     unit->data_bit_padding = 0;
+    unit->raw_data         = NULL;
+    unit->raw_size         = 0;
 }
 
 void CBS_FUNC(fragment_reset)(CodedBitstreamFragment *frag)
@@ -179,6 +181,7 @@ void CBS_FUNC(fragment_reset)(CodedBitstreamFragment *frag)
     frag->data             = NULL;
     frag->data_size        = 0;
     frag->data_bit_padding = 0;
+    frag->data_reusable    = 0;
 }
 
 av_cold void CBS_FUNC(fragment_free)(CodedBitstreamFragment *frag)
@@ -410,8 +413,21 @@ static int cbs_write_unit_data(CodedBitstreamContext *ctx,
 int CBS_FUNC(write_fragment_data)(CodedBitstreamContext *ctx,
                                CodedBitstreamFragment *frag)
 {
+    AVBufferRef *read_ref;
     int err, i;
 
+    if (ctx->write_unchanged_by_ref && frag->data_reusable) {
+        for (i = 0; i < frag->nb_units; i++) {
+            if (frag->units[i].content)
+                break;
+        }
+        if (i == frag->nb_units) {
+            // Nothing has changed, keep the data we read.
+            av_assert0(frag->data && frag->data_ref);
+            return 0;
+        }
+    }
+
     for (i = 0; i < frag->nb_units; i++) {
         CodedBitstreamUnit *unit = &frag->units[i];
 
@@ -419,7 +435,9 @@ int CBS_FUNC(write_fragment_data)(CodedBitstreamContext *ctx,
             continue;
 
         av_buffer_unref(&unit->data_ref);
-        unit->data = NULL;
+        unit->data     = NULL;
+        unit->raw_data = NULL;
+        unit->raw_size = 0;
 
         err = cbs_write_unit_data(ctx, unit);
         if (err < 0) {
@@ -430,10 +448,21 @@ int CBS_FUNC(write_fragment_data)(CodedBitstreamContext *ctx,
         av_assert0(unit->data && unit->data_ref);
     }
 
-    av_buffer_unref(&frag->data_ref);
+    // Unchanged units may still point into the data we read, so keep
+    // it around until the new data has been assembled.
+    read_ref = frag->data_ref;
+    frag->data_ref = NULL;
     frag->data = NULL;
+    frag->data_reusable = 0;
 
     err = ctx->codec->assemble_fragment(ctx, frag);
+
+    for (i = 0; i < frag->nb_units; i++) {
+        frag->units[i].raw_data = NULL;
+        frag->units[i].raw_size = 0;
+    }
+    av_buffer_unref(&read_ref);
+
     if (err < 0) {
         av_log(ctx->log_ctx, AV_LOG_ERROR, "Failed to assemble fragment.\n");
         return err;
@@ -806,6 +835,7 @@ int CBS_FUNC(insert_unit_content)(CodedBitstreamFragment *frag,
     err = cbs_insert_unit(frag, position);
     if (err < 0)
         return err;
+    frag->data_reusable = 0;
 
     if (content_ref) {
         // Create our own reference out of the user-supplied one.
@@ -876,6 +906,7 @@ void CBS_FUNC(delete_unit)(CodedBitstreamFragment *frag,
     cbs_unit_uninit(&frag->units[position]);
 
     --frag->nb_units;
+    frag->data_reusable = 0;
 
     if (frag->nb_units > 0)
         memmove(frag->units + position,
@@ -104,6 +104,22 @@ typedef struct CodedBitstreamUnit {
      */
     AVBufferRef *data_ref;
 
+    /**
+     * Pointer to the bytes this unit was read from, for codecs where
+     * data is not necessarily the same as those (e.g. because emulation
+     * prevention has been removed), if the unit can be written out
+     * again as it is.
+     *
+     * Only set when write_unchanged_by_ref is enabled.  Points into
+     * the fragment data and is cleared when that is replaced or when
+     * the unit is rewritten from content.
+     */
+    const uint8_t *raw_data;
+    /**
+     * The number of bytes at raw_data.
+     */
+    size_t         raw_size;
+
     /**
      * Pointer to the decomposed form of this unit.
      *
@@ -173,6 +189,15 @@ typedef struct CodedBitstreamFragment {
      * Must be NULL if nb_units_allocated is zero.
      */
     CodedBitstreamUnit *units;
+
+    /**
+     * Whether data can be written out again as it is.
+     *
+     * Set when reading if data uses the same framing as written
+     * fragments, cleared when units are inserted or deleted.
+     * For internal use by cbs.
+     */
+    int data_reusable;
 } CodedBitstreamFragment;
 
 
@@ -258,6 +283,23 @@ typedef struct CodedBitstreamContext {
      */
     int nb_decompose_unit_types;
 
+    /**
+     * Write unchanged fragments by reference to the data they were read
+     * from.
+     *
+     * If set, a fragment in which no unit has been decomposed, inserted
+     * or deleted since it was read is not reassembled when writing, its
+     * data is returned as-is instead.  In other fragments, units which
+     * have not been decomposed are copied as they were read rather than
+     * being escaped again.  Together with decompose_unit_types
+     * this avoids all parsing and copying for data passing through
+     * untouched, but the output then keeps details of the input framing
+     * (like start code lengths or trailing zero bytes) which would
+     * otherwise be normalised.  Unit data must not be replaced directly
+     * by the caller while this is set.
+     */
+    int write_unchanged_by_ref;
+
     /**
      * Enable trace output during read/write operations.
      */
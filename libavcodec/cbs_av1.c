@@ -796,6 +796,9 @@ static int cbs_av1_split_fragment(CodedBitstreamContext *ctx,
         size -= obu_length;
     }
 
+    // The units cover all of the data unless it has a configuration record.
+    frag->data_reusable = !(header && frag->data_size && frag->data[0] & 0x80);
+
 success:
     err = 0;
 fail:
@@ -518,6 +518,19 @@ static int cbs_h2645_fragment_add_nals(CodedBitstreamContext *ctx,
                             (uint8_t*)nal->data, size, ref);
         if (err < 0)
             return err;
+
+        if (ctx->write_unchanged_by_ref) {
+            // Keep the escaped form so that the unit does not need to be
+            // escaped again if it is written unchanged.  The trailing
+            // zeroes removed above must match those of the raw data.
+            size_t raw_size = nal->raw_size;
+            while (raw_size > 0 && nal->raw_data[raw_size - 1] == 0)
+                --raw_size;
+            if (nal->raw_size - raw_size == nal->size - size) {
+                frag->units[frag->nb_units - 1].raw_data = nal->raw_data;
+                frag->units[frag->nb_units - 1].raw_size = raw_size;
+            }
+        }
     }
 
     return 0;
@@ -751,6 +764,9 @@ static int cbs_h2645_split_fragment(CodedBitstreamContext *ctx,
         err = cbs_h2645_fragment_add_nals(ctx, frag, &priv->read_packet);
         if (err < 0)
             return err;
+
+        // Only Annex B can be written out again as it is.
+        frag->data_reusable = !priv->mp4;
     }
 
     return 0;
@@ -1840,7 +1856,10 @@ static int cbs_h2645_assemble_fragment(CodedBitstreamContext *ctx,
     max_size = 0;
     for (i = 0; i < frag->nb_units; i++) {
         // Start code + content with worst-case emulation prevention.
-        max_size += 4 + frag->units[i].data_size * 3 / 2;
+        if (frag->units[i].raw_data)
+            max_size += 4 + frag->units[i].raw_size;
+        else
+            max_size += 4 + frag->units[i].data_size * 3 / 2;
     }
 
     data = av_realloc(NULL, max_size + AV_INPUT_BUFFER_PADDING_SIZE);
@@ -1868,6 +1887,13 @@ static int cbs_h2645_assemble_fragment(CodedBitstreamContext *ctx,
         data[dp++] = 0;
         data[dp++] = 1;
 
+        if (unit->raw_data) {
+            // Unchanged since it was read, already escaped.
+            memcpy(data + dp, unit->raw_data, unit->raw_size);
+            dp += unit->raw_size;
+            continue;
+        }
+
         zero_run = 0;
         for (sp = 0; sp < unit->data_size; sp++) {
             if (zero_run < 2) {
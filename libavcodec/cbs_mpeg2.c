@@ -157,7 +157,7 @@ static int cbs_mpeg2_split_fragment(CodedBitstreamContext *ctx,
 {
     const uint8_t *start;
     uint32_t start_code = -1;
-    int err;
+    int reusable, err;
 
     start = avpriv_find_start_code(frag->data, frag->data + frag->data_size,
                                    &start_code);
@@ -165,6 +165,8 @@ static int cbs_mpeg2_split_fragment(CodedBitstreamContext *ctx,
         // No start code found.
         return AVERROR_INVALIDDATA;
     }
+    // Anything before the first start code is dropped.
+    reusable = start == frag->data + 4;
 
     do {
         CodedBitstreamUnitType unit_type = start_code & 0xff;
@@ -202,6 +204,8 @@ static int cbs_mpeg2_split_fragment(CodedBitstreamContext *ctx,
         // Do we have a further unit to add to the fragment?
     } while ((start_code >> 8) == 0x000001);
 
+    frag->data_reusable = reusable;
+
     return 0;
 }
 
@@ -224,9 +224,18 @@ static int decode_get_packet(AVCodecContext *avctx, AVPacket *pkt)
     AVCodecInternal *avci = avctx->internal;
     int ret;
 
-    ret = av_bsf_receive_packet(avci->bsf, pkt);
-    if (ret < 0)
-        return ret;
+    while (1) {
+        ret = av_bsf_receive_packet(avci->bsf, pkt);
+        if (ret < 0)
+            return ret;
+
+        /* in keyframes-only mode, drop everything else before the decoder
+         * gets to see it; empty packets are still passed through */
+        if (!(avctx->flags2 & AV_CODEC_FLAG2_KEYFRAMES_ONLY) ||
+            (pkt->flags & AV_PKT_FLAG_KEY) || !pkt->size)
+            break;
+        av_packet_unref(pkt);
+    }
 
     if (!(ffcodec(avctx->codec)->caps_internal & FF_CODEC_CAP_SETS_FRAME_PROPS)) {
         ret = extract_packet_props(avctx->internal, pkt);
@@ -129,6 +129,25 @@ typedef struct FlacEncodeContext {
 
     int flushed;
     int64_t next_pts;
+
+    /**
+     * Frame-parallel encoding with slice threads: up to nb_workers input
+     * frames are queued and then encoded concurrently, each one by its own
+     * copy of this context. The stream-wide state (frame numbers, MD5 sum,
+     * frame size limits) is only updated by the main context, in order.
+     */
+    struct FlacEncodeContext *workers;
+    int nb_workers;
+    AVFrame **queued_frames;
+    int nb_queued;
+    int nb_encoded;                 ///< number of workers holding an encoded frame
+    int next_encoded;               ///< next worker to output a packet from
+
+    /* worker state */
+    AVFrame *in_frame;
+    uint8_t *out_buf;
+    unsigned int out_buf_size;
+    int out_bytes;                  ///< size of the encoded frame or error code
 } FlacEncodeContext;
 
 
@@ -267,6 +286,43 @@ static av_cold void dprint_compression_options(FlacEncodeContext *s)
 }
 
 
+static av_cold int init_workers(AVCodecContext *avctx)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    int ret;
+
+    s->workers = av_calloc(avctx->thread_count, sizeof(*s->workers));
+    s->queued_frames = av_calloc(avctx->thread_count, sizeof(*s->queued_frames));
+    if (!s->workers || !s->queued_frames)
+        return AVERROR(ENOMEM);
+
+    for (int i = 0; i < avctx->thread_count; i++) {
+        FlacEncodeContext *w = &s->workers[i];
+
+        *w = *s;
+        w->md5ctx        = NULL;
+        w->md5_buffer    = NULL;
+        w->workers       = NULL;
+        w->queued_frames = NULL;
+        w->nb_workers    = 0;
+        memset(&w->lpc_ctx, 0, sizeof(w->lpc_ctx));
+        s->nb_workers++;
+
+        ret = ff_lpc_init(&w->lpc_ctx, avctx->frame_size,
+                          s->options.max_prediction_order, FF_LPC_TYPE_LEVINSON);
+        if (ret < 0)
+            return ret;
+
+        w->in_frame         = av_frame_alloc();
+        s->queued_frames[i] = av_frame_alloc();
+        if (!w->in_frame || !s->queued_frames[i])
+            return AVERROR(ENOMEM);
+    }
+
+    return 0;
+}
+
+
 static av_cold int flac_encode_init(AVCodecContext *avctx)
 {
     int freq = avctx->sample_rate;
@@ -466,13 +522,21 @@ static av_cold int flac_encode_init(AVCodecContext *avctx)
 
     ret = ff_lpc_init(&s->lpc_ctx, avctx->frame_size,
                       s->options.max_prediction_order, FF_LPC_TYPE_LEVINSON);
+    if (ret < 0)
+        return ret;
 
     ff_bswapdsp_init(&s->bdsp);
     ff_flacencdsp_init(&s->flac_dsp);
 
     dprint_compression_options(s);
 
-    return ret;
+    if (avctx->active_thread_type & FF_THREAD_SLICE && avctx->thread_count > 1) {
+        ret = init_workers(avctx);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
 }
 
 
@@ -1561,9 +1625,9 @@ static void write_frame_footer(FlacEncodeContext *s)
 }
 
 
-static int write_frame(FlacEncodeContext *s, AVPacket *avpkt)
+static int write_frame(FlacEncodeContext *s, uint8_t *buf, int size)
 {
-    init_put_bits(&s->pb, avpkt->data, avpkt->size);
+    init_put_bits(&s->pb, buf, size);
     write_frame_header(s);
     write_subframes(s);
     write_frame_footer(s);
@@ -1571,10 +1635,11 @@ static int write_frame(FlacEncodeContext *s, AVPacket *avpkt)
 }
 
 
-static int update_md5_sum(FlacEncodeContext *s, const void *samples)
+static int update_md5_sum(FlacEncodeContext *s, const void *samples,
+                          int nb_samples)
 {
     const uint8_t *buf;
-    int buf_size = s->frame.blocksize * s->channels *
+    int buf_size = nb_samples * s->channels *
                    ((s->avctx->bits_per_raw_sample + 7) / 8);
 
     if (s->avctx->bits_per_raw_sample > 16 || HAVE_BIGENDIAN) {
@@ -1595,7 +1660,7 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
         const int32_t *samples0 = samples;
         uint8_t *tmp            = s->md5_buffer;
 
-        for (i = 0; i < s->frame.blocksize * s->channels; i++) {
+        for (i = 0; i < nb_samples * s->channels; i++) {
             int32_t v = samples0[i] >> 8;
             AV_WL24(tmp + 3*i, v);
         }
@@ -1606,7 +1671,7 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
         const int32_t *samples0 = samples;
         uint8_t *tmp            = s->md5_buffer;
 
-        for (i = 0; i < s->frame.blocksize * s->channels; i++)
+        for (i = 0; i < nb_samples * s->channels; i++)
             AV_WL32(tmp + 4*i, samples0[i]);
         buf = s->md5_buffer;
     }
@@ -1616,6 +1681,196 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
 }
 
 
+/**
+ * Change max_framesize for a small final frame.
+ * Must be called for every frame in coding order.
+ */
+static void update_max_framesize(FlacEncodeContext *s, int nb_samples)
+{
+    if (nb_samples < s->frame.blocksize) {
+        s->max_framesize = flac_get_max_frame_size(nb_samples,
+                                                   s->channels,
+                                                   s->avctx->bits_per_raw_sample);
+    }
+}
+
+
+/**
+ * Encode one frame worth of samples without writing it.
+ *
+ * @return size of the encoded frame in bytes or a negative error code
+ */
+static int encode_samples(FlacEncodeContext *s, const AVFrame *frame)
+{
+    int frame_bytes;
+
+    init_frame(s, frame->nb_samples);
+
+    copy_samples(s, frame->data[0]);
+
+    channel_decorrelation(s);
+
+    remove_wasted_bits(s);
+
+    frame_bytes = encode_frame(s);
+
+    /* Fall back on verbatim mode if the compressed frame is larger than it
+       would be if encoded uncompressed. */
+    if (frame_bytes < 0 || frame_bytes > s->max_framesize) {
+        s->frame.verbatim_only = 1;
+        frame_bytes = encode_frame(s);
+        if (frame_bytes < 0) {
+            av_log(s->avctx, AV_LOG_ERROR, "Bad frame count\n");
+            return frame_bytes;
+        }
+    }
+
+    return frame_bytes;
+}
+
+
+/**
+ * Update the stream-wide state after encoding a frame.
+ * Must be called for every frame in coding order.
+ */
+static int update_stream_info(FlacEncodeContext *s, const AVFrame *frame,
+                              int out_bytes)
+{
+    int ret;
+
+    s->frame_count++;
+    s->sample_count += frame->nb_samples;
+    if ((ret = update_md5_sum(s, frame->data[0], frame->nb_samples)) < 0) {
+        av_log(s->avctx, AV_LOG_ERROR, "Error updating MD5 checksum\n");
+        return ret;
+    }
+    if (out_bytes > s->max_encoded_framesize)
+        s->max_encoded_framesize = out_bytes;
+    if (out_bytes < s->min_framesize)
+        s->min_framesize = out_bytes;
+
+    s->next_pts = frame->pts + ff_samples_to_time_base(s->avctx, frame->nb_samples);
+
+    return 0;
+}
+
+
+static int set_packet_props(AVCodecContext *avctx, AVPacket *avpkt,
+                            const AVFrame *frame)
+{
+    avpkt->pts      = frame->pts;
+    avpkt->duration = frame->duration ? frame->duration :
+                      ff_samples_to_time_base(avctx, frame->nb_samples);
+
+    return ff_encode_reordered_opaque(avctx, avpkt, frame);
+}
+
+
+static int encode_frame_worker(AVCodecContext *avctx, void *arg)
+{
+    FlacEncodeContext *s = arg;
+    int frame_bytes;
+
+    frame_bytes = encode_samples(s, s->in_frame);
+    if (frame_bytes >= 0) {
+        av_fast_malloc(&s->out_buf, &s->out_buf_size, frame_bytes);
+        if (s->out_buf)
+            frame_bytes = write_frame(s, s->out_buf, frame_bytes);
+        else
+            frame_bytes = AVERROR(ENOMEM);
+    }
+    s->out_bytes = frame_bytes;
+
+    return 0;
+}
+
+
+static int encode_queued_frames(AVCodecContext *avctx)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    int ret;
+
+    for (int i = 0; i < s->nb_queued; i++) {
+        FlacEncodeContext *w = &s->workers[i];
+        AVFrame *frame = s->queued_frames[i];
+
+        /* the main context only tracks the block size to apply the same
+         * frame size limit as the single-threaded path */
+        update_max_framesize(s, frame->nb_samples);
+        s->frame.blocksize = frame->nb_samples;
+
+        w->max_framesize = s->max_framesize;
+        w->frame_count   = s->frame_count + i;
+        av_frame_move_ref(w->in_frame, frame);
+    }
+
+    avctx->execute(avctx, encode_frame_worker, s->workers, NULL,
+                   s->nb_queued, sizeof(*s->workers));
+
+    for (int i = 0; i < s->nb_queued; i++) {
+        FlacEncodeContext *w = &s->workers[i];
+
+        if (w->out_bytes < 0)
+            return w->out_bytes;
+        ret = update_stream_info(s, w->in_frame, w->out_bytes);
+        if (ret < 0)
+            return ret;
+    }
+
+    s->nb_encoded   = s->nb_queued;
+    s->next_encoded = 0;
+    s->nb_queued    = 0;
+
+    return 0;
+}
+
+
+/**
+ * Queue the input frame and return the oldest encoded frame, if any.
+ * A batch of frames is encoded once all workers are idle and either every
+ * worker has a frame or the encoder is being flushed.
+ */
+static int encode_frame_threaded(AVCodecContext *avctx, AVPacket *avpkt,
+                                 const AVFrame *frame, int *got_packet_ptr)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    int ret;
+
+    if (frame) {
+        av_assert1(s->nb_queued < s->nb_workers);
+        ret = av_frame_ref(s->queued_frames[s->nb_queued], frame);
+        if (ret < 0)
+            return ret;
+        s->nb_queued++;
+    }
+
+    if (s->next_encoded == s->nb_encoded && s->nb_queued &&
+        (s->nb_queued == s->nb_workers || !frame)) {
+        ret = encode_queued_frames(avctx);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (s->next_encoded < s->nb_encoded) {
+        FlacEncodeContext *w = &s->workers[s->next_encoded++];
+
+        ret = ff_get_encode_buffer(avctx, avpkt, w->out_bytes, 0);
+        if (ret < 0)
+            return ret;
+        memcpy(avpkt->data, w->out_buf, w->out_bytes);
+
+        ret = set_packet_props(avctx, avpkt, w->in_frame);
+        av_frame_unref(w->in_frame);
+        if (ret < 0)
+            return ret;
+
+        *got_packet_ptr = 1;
+    }
+
+    return 0;
+}
+
+
 static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                              const AVFrame *frame, int *got_packet_ptr)
 {
@@ -1624,6 +1879,12 @@ static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
 
     s = avctx->priv_data;
 
+    if (s->nb_workers) {
+        ret = encode_frame_threaded(avctx, avpkt, frame, got_packet_ptr);
+        if (ret < 0 || *got_packet_ptr || frame)
+            return ret;
+    }
+
     /* when the last block is reached, update the header in extradata */
     if (!frame) {
         s->max_framesize = s->max_encoded_framesize;
@@ -1646,51 +1907,22 @@ static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
         return 0;
     }
 
-    /* change max_framesize for small final frame */
-    if (frame->nb_samples < s->frame.blocksize) {
-        s->max_framesize = flac_get_max_frame_size(frame->nb_samples,
-                                                   s->channels,
-                                                   avctx->bits_per_raw_sample);
-    }
+    update_max_framesize(s, frame->nb_samples);
 
-    init_frame(s, frame->nb_samples);
-
-    copy_samples(s, frame->data[0]);
-
-    channel_decorrelation(s);
-
-    remove_wasted_bits(s);
-
-    frame_bytes = encode_frame(s);
-
-    /* Fall back on verbatim mode if the compressed frame is larger than it
-       would be if encoded uncompressed. */
-    if (frame_bytes < 0 || frame_bytes > s->max_framesize) {
-        s->frame.verbatim_only = 1;
-        frame_bytes = encode_frame(s);
-        if (frame_bytes < 0) {
-            av_log(avctx, AV_LOG_ERROR, "Bad frame count\n");
-            return frame_bytes;
-        }
-    }
+    frame_bytes = encode_samples(s, frame);
+    if (frame_bytes < 0)
+        return frame_bytes;
 
     if ((ret = ff_get_encode_buffer(avctx, avpkt, frame_bytes, 0)) < 0)
         return ret;
 
-    out_bytes = write_frame(s, avpkt);
+    out_bytes = write_frame(s, avpkt->data, avpkt->size);
 
-    s->frame_count++;
-    s->sample_count += frame->nb_samples;
-    if ((ret = update_md5_sum(s, frame->data[0])) < 0) {
-        av_log(avctx, AV_LOG_ERROR, "Error updating MD5 checksum\n");
+    if ((ret = update_stream_info(s, frame, out_bytes)) < 0)
         return ret;
-    }
-    if (out_bytes > s->max_encoded_framesize)
-        s->max_encoded_framesize = out_bytes;
-    if (out_bytes < s->min_framesize)
-        s->min_framesize = out_bytes;
 
-    s->next_pts = frame->pts + ff_samples_to_time_base(avctx, frame->nb_samples);
+    if ((ret = set_packet_props(avctx, avpkt, frame)) < 0)
+        return ret;
 
     av_shrink_packet(avpkt, out_bytes);
 
@@ -1703,6 +1935,17 @@ static av_cold int flac_encode_close(AVCodecContext *avctx)
 {
     FlacEncodeContext *s = avctx->priv_data;
 
+    for (int i = 0; i < s->nb_workers; i++) {
+        FlacEncodeContext *w = &s->workers[i];
+
+        av_frame_free(&w->in_frame);
+        av_freep(&w->out_buf);
+        ff_lpc_end(&w->lpc_ctx);
+        av_frame_free(&s->queued_frames[i]);
+    }
+    av_freep(&s->workers);
+    av_freep(&s->queued_frames);
+
     av_freep(&s->md5ctx);
     av_freep(&s->md5_buffer);
     ff_lpc_end(&s->lpc_ctx);
@@ -1754,7 +1997,7 @@ const FFCodec ff_flac_encoder = {
     .p.type         = AVMEDIA_TYPE_AUDIO,
     .p.id           = AV_CODEC_ID_FLAC,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
-                      AV_CODEC_CAP_SMALL_LAST_FRAME |
+                      AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_SLICE_THREADS |
                       AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE,
     .priv_data_size = sizeof(FlacEncodeContext),
     .init           = flac_encode_init,
@@ -1762,5 +2005,5 @@ const FFCodec ff_flac_encoder = {
     .close          = flac_encode_close,
     CODEC_SAMPLEFMTS(AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S32),
     .p.priv_class   = &flac_encoder_class,
-    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP | FF_CODEC_CAP_EOF_FLUSH,
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP,
 };
@@ -53,6 +53,11 @@ typedef struct FramePool {
     int samples;
 } FramePool;
 
+static AVBufferRef *frame_pool_alloc(void *opaque, size_t size)
+{
+    return CONFIG_MEMORY_POISONING ? av_buffer_alloc(size) : av_buffer_allocz(size);
+}
+
 static void frame_pool_free(AVRefStructOpaque unused, void *obj)
 {
     FramePool *pool = obj;
@@ -119,10 +124,9 @@ static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
                     ret = AVERROR(EINVAL);
                     goto fail;
                 }
-                pool->pools[i] = av_buffer_pool_init(size[i] + 16 + STRIDE_ALIGN - 1,
-                                                     CONFIG_MEMORY_POISONING ?
-                                                        NULL :
-                                                        av_buffer_allocz);
+                pool->pools[i] = av_buffer_pool_init3(size[i] + 16 + STRIDE_ALIGN - 1,
+                                                      NULL, frame_pool_alloc, NULL,
+                                                      AV_BUFFER_POOL_FLAG_THREAD_CACHE);
                 if (!pool->pools[i]) {
                     ret = AVERROR(ENOMEM);
                     goto fail;
@@ -142,10 +146,9 @@ static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
         if (ret < 0)
             goto fail;
 
-        pool->pools[0] = av_buffer_pool_init(pool->linesize[0],
-                                             CONFIG_MEMORY_POISONING ?
-                                                NULL :
-                                                av_buffer_allocz);
+        pool->pools[0] = av_buffer_pool_init3(pool->linesize[0],
+                                              NULL, frame_pool_alloc, NULL,
+                                              AV_BUFFER_POOL_FLAG_THREAD_CACHE);
         if (!pool->pools[0]) {
             ret = AVERROR(ENOMEM);
             goto fail;
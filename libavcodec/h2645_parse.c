@@ -23,12 +23,12 @@
 #include "config.h"
 
 #include "libavutil/intmath.h"
-#include "libavutil/intreadwrite.h"
 #include "libavutil/mem.h"
 
 #include "bytestream.h"
 #include "h264.h"
 #include "h2645_parse.h"
+#include "startcode.h"
 #include "vvc.h"
 
 #include "hevc/hevc.h"
@@ -36,55 +36,26 @@
 int ff_h2645_extract_rbsp(const uint8_t *src, int length,
                           H2645RBSP *rbsp, H2645NAL *nal, int small_padding)
 {
+    ff_startcode_find_candidate_fn find_candidate;
     int i, si, di;
     uint8_t *dst;
 
+    if (!rbsp->find_candidate)
+        rbsp->find_candidate = ff_startcode_find_candidate_get();
+    find_candidate = rbsp->find_candidate;
+
     nal->skipped_bytes = 0;
-#define STARTCODE_TEST                                                  \
-        if (i + 2 < length && src[i + 1] == 0 &&                        \
-           (src[i + 2] == 3 || src[i + 2] == 1)) {                      \
-            if (src[i + 2] == 1) {                                      \
-                /* startcode, so we must be past the end */             \
-                length = i;                                             \
-            }                                                           \
-            break;                                                      \
+    for (i = 0; i + 1 < length; i++) {
+        i += find_candidate(src + i, length - 1 - i);
+        if (i + 2 < length && src[i + 1] == 0 &&
+           (src[i + 2] == 3 || src[i + 2] == 1)) {
+            if (src[i + 2] == 1) {
+                /* startcode, so we must be past the end */
+                length = i;
+            }
+            break;
         }
-#if HAVE_FAST_UNALIGNED
-#define FIND_FIRST_ZERO                                                 \
-        if (i > 0 && !src[i])                                           \
-            i--;                                                        \
-        while (src[i])                                                  \
-            i++
-#if HAVE_FAST_64BIT
-    for (i = 0; i + 1 < length; i += 9) {
-        if (!((~AV_RN64(src + i) &
-               (AV_RN64(src + i) - 0x0100010001000101ULL)) &
-              0x8000800080008080ULL))
-            continue;
-        FIND_FIRST_ZERO;
-        STARTCODE_TEST;
-        i -= 7;
-    }
-#else
-    for (i = 0; i + 1 < length; i += 5) {
-        if (!((~AV_RN32(src + i) &
-               (AV_RN32(src + i) - 0x01000101U)) &
-              0x80008080U))
-            continue;
-        FIND_FIRST_ZERO;
-        STARTCODE_TEST;
-        i -= 3;
-    }
-#endif /* HAVE_FAST_64BIT */
-#else
-    for (i = 0; i + 1 < length; i += 2) {
-        if (src[i])
-            continue;
-        if (i > 0 && src[i - 1] == 0)
-            i--;
-        STARTCODE_TEST;
     }
-#endif /* HAVE_FAST_UNALIGNED */
 
     if (i >= length - 1 && small_padding) { // no escaped 0
         nal->data     =
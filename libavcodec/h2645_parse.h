@@ -76,6 +76,8 @@ typedef struct H2645RBSP {
     AVBufferRef *rbsp_buffer_ref;
     int rbsp_buffer_alloc_size;
     int rbsp_buffer_size;
+    /* zero byte search, looked up on first use */
+    int (*find_candidate)(const uint8_t *buf, int size);
 } H2645RBSP;
 
 /* an input packet split into unescaped NAL units */
@@ -785,6 +785,32 @@ static av_always_inline void hl_decode_mb_idct_luma(const H264Context *h, H264Sl
     }
 }
 
+/**
+ * Point the reference indices of a field macroblock in an MBAFF frame
+ * to the matching field references.
+ */
+static av_always_inline void mbaff_field_ref_cache(H264SliceContext *sl,
+                                                   int mb_type)
+{
+    int list, i;
+
+    for (list = 0; list < sl->list_count; list++) {
+        if (!USES_LIST(mb_type, list))
+            continue;
+        if (IS_16X16(mb_type)) {
+            int8_t *ref = &sl->ref_cache[list][scan8[0]];
+            fill_rectangle(ref, 4, 4, 8, (16 + *ref) ^ (sl->mb_y & 1), 1);
+        } else {
+            for (i = 0; i < 16; i += 4) {
+                int ref = sl->ref_cache[list][scan8[i]];
+                if (ref >= 0)
+                    fill_rectangle(&sl->ref_cache[list][scan8[i]], 2, 2,
+                                   8, (16 + ref) ^ (sl->mb_y & 1), 1);
+            }
+        }
+    }
+}
+
 #define BITS   8
 #define SIMPLE 1
 #include "h264_mb_template.c"
@@ -797,6 +823,363 @@ static av_always_inline void hl_decode_mb_idct_luma(const H264Context *h, H264Sl
 #define SIMPLE 0
 #include "h264_mb_template.c"
 
+static av_always_inline int pixel_get(const uint8_t *buf, int pixel_shift,
+                                      int index)
+{
+    return pixel_shift ? AV_RN16A(buf + 2 * index) : buf[index];
+}
+
+static av_always_inline void pixel_set(uint8_t *buf, int pixel_shift,
+                                       int index, int value)
+{
+    if (pixel_shift)
+        AV_WN16A(buf + 2 * index, value);
+    else
+        buf[index] = value;
+}
+
+static void weight_lowres(uint8_t *block, int width, int height,
+                          int pixel_shift, int bit_depth,
+                          int log2_denom, int weight, int offset)
+{
+    offset = (unsigned)offset << (log2_denom + (bit_depth - 8));
+    if (log2_denom)
+        offset += 1 << (log2_denom - 1);
+
+    for (int y = 0; y < height; y++, block += H264_LOWRES_MC_STRIDE)
+        for (int x = 0; x < width; x++) {
+            int v = (pixel_get(block, pixel_shift, x) * weight + offset) >> log2_denom;
+            pixel_set(block, pixel_shift, x, av_clip_uintp2(v, bit_depth));
+        }
+}
+
+static void biweight_lowres(uint8_t *dst, const uint8_t *src,
+                            int width, int height,
+                            int pixel_shift, int bit_depth, int log2_denom,
+                            int weightd, int weights, int offset)
+{
+    offset = (unsigned)offset << (bit_depth - 8);
+    offset = (unsigned)((offset + 1) | 1) << log2_denom;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int v = (pixel_get(src, pixel_shift, x) * weights +
+                     pixel_get(dst, pixel_shift, x) * weightd + offset) >> (log2_denom + 1);
+            pixel_set(dst, pixel_shift, x, av_clip_uintp2(v, bit_depth));
+        }
+        dst += H264_LOWRES_MC_STRIDE;
+        src += H264_LOWRES_MC_STRIDE;
+    }
+}
+
+/**
+ * Bilinear motion compensation of one plane of a partition at the reduced
+ * size, using the chroma MC functions like the mpegvideo lowres code.
+ *
+ * @param x,y     position in units of 1 / (1 << frac_bits) reduced size samples
+ * @param pic_width,pic_height reduced size plane dimensions
+ */
+static void mc_dir_part_lowres(const H264Context *h, H264SliceContext *sl,
+                               uint8_t *dest, const uint8_t *src,
+                               ptrdiff_t linesize, int pic_width, int pic_height,
+                               int x, int y, int frac_bits_x, int frac_bits_y,
+                               int width, int height, int avg)
+{
+    const H264ChromaContext *c = &h->h264chroma;
+    const int idx    = 3 - av_log2(width);
+    const int full_x = x >> frac_bits_x;
+    const int full_y = y >> frac_bits_y;
+    const int mx     = ((x & ((1 << frac_bits_x) - 1)) << 3) >> frac_bits_x;
+    const int my     = ((y & ((1 << frac_bits_y) - 1)) << 3) >> frac_bits_y;
+    /* the SIMD versions only handle even heights, the MC buffers are
+     * large enough for the extra row */
+    const int mc_height = FFALIGN(height, 2);
+
+    /* always go through the edge emulation buffer, the MC functions use
+     * the same stride for source and destination */
+    h->vdsp.emulated_edge_mc(sl->edge_emu_buffer,
+                             src + full_y * linesize + full_x * (1 << h->pixel_shift),
+                             H264_LOWRES_MC_STRIDE, linesize,
+                             width + 1, mc_height + 1, full_x, full_y,
+                             pic_width, pic_height);
+
+    (avg ? c->avg_h264_chroma_pixels_tab : c->put_h264_chroma_pixels_tab)[idx]
+        (dest, sl->edge_emu_buffer, H264_LOWRES_MC_STRIDE, mc_height, mx, my);
+}
+
+/**
+ * Predict the partition n covering the given full size luma rectangle of
+ * the current macroblock into the reduced size MC buffers.
+ */
+static void mc_part_lowres(const H264Context *h, H264SliceContext *sl, int n,
+                           int x, int y, int width, int height,
+                           int list0, int list1)
+{
+    const int lowres      = h->avctx->lowres;
+    const int pixel_shift = h->pixel_shift;
+    const int bit_depth   = h->ps.sps->bit_depth_luma;
+    const int mb_field    = MB_FIELD(sl);
+    const int nb_planes   = CONFIG_GRAY && h->flags & AV_CODEC_FLAG_GRAY ? 1 : 3;
+    const int refn0       = sl->ref_cache[0][scan8[n]];
+    const int refn1       = sl->ref_cache[1][scan8[n]];
+    const int weighted    = (sl->pwt.use_weight == 2 && list0 && list1 &&
+                             sl->pwt.implicit_weight[refn0][refn1][sl->mb_y & 1] != 32) ||
+                            sl->pwt.use_weight == 1;
+    const int pos_x       = (16 * sl->mb_x + x) * 4;
+    const int pos_y       = (16 * (sl->mb_y >> mb_field) + y) * 4;
+
+    for (int p = 0; p < nb_planes; p++) {
+        const int shift_x    = lowres + (p ? h->chroma_x_shift : 0);
+        const int shift_y    = lowres + (p ? h->chroma_y_shift : 0);
+        const ptrdiff_t linesize = p ? sl->mb_uvlinesize : sl->mb_linesize;
+        const int pic_width  = 16 * h->mb_width >> shift_x;
+        const int pic_height = (16 * h->mb_height >> mb_field) >> shift_y;
+        int part_w = width  >> shift_x;
+        int part_h = height >> shift_y;
+        uint8_t *dest0, *dest1;
+
+        /* partitions smaller than one reduced size sample are predicted
+         * from the one starting on it */
+        if (!part_w) {
+            if (x & ((1 << shift_x) - 1))
+                continue;
+            part_w = 1;
+        }
+        if (!part_h) {
+            if (y & ((1 << shift_y) - 1))
+                continue;
+            part_h = 1;
+        }
+
+        dest0 = sl->lowres_scratch + 3 * H264_LOWRES_SCRATCH_PLANE +
+                p * H264_LOWRES_MC_PLANE +
+                (y >> shift_y) * H264_LOWRES_MC_STRIDE +
+                ((x >> shift_x) << pixel_shift);
+        dest1 = dest0 + 3 * H264_LOWRES_MC_PLANE;
+
+        for (int list = 0; list < 2; list++) {
+            const H264Ref *ref;
+            int my;
+
+            if (!(list ? list1 : list0))
+                continue;
+
+            ref = &sl->ref_list[list][list ? refn1 : refn0];
+            my  = sl->mv_cache[list][scan8[n]][1];
+            if (p && h->ps.sps->chroma_format_idc <= 1 && mb_field)
+                // chroma offset when predicting from a field of opposite parity
+                my += 2 * ((sl->mb_y & 1) - (ref->reference - 1));
+
+            mc_dir_part_lowres(h, sl, list && weighted ? dest1 : dest0,
+                               ref->data[p], linesize, pic_width, pic_height,
+                               pos_x + sl->mv_cache[list][scan8[n]][0],
+                               pos_y + my, 2 + shift_x, 2 + shift_y,
+                               part_w, part_h, list && list0 && !weighted);
+        }
+
+        if (!weighted)
+            continue;
+
+        if (list0 && list1) {
+            int denom, weight0, weight1, offset;
+
+            if (sl->pwt.use_weight == 2) {
+                denom   = 5;
+                weight0 = sl->pwt.implicit_weight[refn0][refn1][sl->mb_y & 1];
+                weight1 = 64 - weight0;
+                offset  = 0;
+            } else if (!p) {
+                denom   = sl->pwt.luma_log2_weight_denom;
+                weight0 = sl->pwt.luma_weight[refn0][0][0];
+                weight1 = sl->pwt.luma_weight[refn1][1][0];
+                offset  = sl->pwt.luma_weight[refn0][0][1] +
+                          sl->pwt.luma_weight[refn1][1][1];
+            } else {
+                denom   = sl->pwt.chroma_log2_weight_denom;
+                weight0 = sl->pwt.chroma_weight[refn0][0][p - 1][0];
+                weight1 = sl->pwt.chroma_weight[refn1][1][p - 1][0];
+                offset  = sl->pwt.chroma_weight[refn0][0][p - 1][1] +
+                          sl->pwt.chroma_weight[refn1][1][p - 1][1];
+            }
+            biweight_lowres(dest0, dest1, part_w, part_h, pixel_shift,
+                            bit_depth, denom, weight0, weight1, offset);
+        } else {
+            const int list = !!list1;
+            const int refn = list ? refn1 : refn0;
+
+            if (!p)
+                weight_lowres(dest0, part_w, part_h, pixel_shift, bit_depth,
+                              sl->pwt.luma_log2_weight_denom,
+                              sl->pwt.luma_weight[refn][list][0],
+                              sl->pwt.luma_weight[refn][list][1]);
+            else if (sl->pwt.use_weight_chroma)
+                weight_lowres(dest0, part_w, part_h, pixel_shift, bit_depth,
+                              sl->pwt.chroma_log2_weight_denom,
+                              sl->pwt.chroma_weight[refn][list][p - 1][0],
+                              sl->pwt.chroma_weight[refn][list][p - 1][1]);
+        }
+    }
+}
+
+static void hl_motion_lowres(const H264Context *h, H264SliceContext *sl,
+                             int mb_type)
+{
+    if (IS_16X16(mb_type)) {
+        mc_part_lowres(h, sl, 0, 0, 0, 16, 16,
+                       IS_DIR(mb_type, 0, 0), IS_DIR(mb_type, 0, 1));
+    } else if (IS_16X8(mb_type)) {
+        mc_part_lowres(h, sl, 0, 0, 0, 16, 8,
+                       IS_DIR(mb_type, 0, 0), IS_DIR(mb_type, 0, 1));
+        mc_part_lowres(h, sl, 8, 0, 8, 16, 8,
+                       IS_DIR(mb_type, 1, 0), IS_DIR(mb_type, 1, 1));
+    } else if (IS_8X16(mb_type)) {
+        mc_part_lowres(h, sl, 0, 0, 0, 8, 16,
+                       IS_DIR(mb_type, 0, 0), IS_DIR(mb_type, 0, 1));
+        mc_part_lowres(h, sl, 4, 8, 0, 8, 16,
+                       IS_DIR(mb_type, 1, 0), IS_DIR(mb_type, 1, 1));
+    } else {
+        av_assert2(IS_8X8(mb_type));
+
+        for (int i = 0; i < 4; i++) {
+            const int sub_mb_type = sl->sub_mb_type[i];
+            const int list0 = IS_DIR(sub_mb_type, 0, 0);
+            const int list1 = IS_DIR(sub_mb_type, 0, 1);
+            const int n = 4 * i;
+            const int x = (i & 1) * 8;
+            const int y = (i & 2) * 4;
+
+            if (IS_SUB_8X8(sub_mb_type)) {
+                mc_part_lowres(h, sl, n, x, y, 8, 8, list0, list1);
+            } else if (IS_SUB_8X4(sub_mb_type)) {
+                mc_part_lowres(h, sl, n,     x, y,     8, 4, list0, list1);
+                mc_part_lowres(h, sl, n + 2, x, y + 4, 8, 4, list0, list1);
+            } else if (IS_SUB_4X8(sub_mb_type)) {
+                mc_part_lowres(h, sl, n,     x,     y, 4, 8, list0, list1);
+                mc_part_lowres(h, sl, n + 1, x + 4, y, 4, 8, list0, list1);
+            } else {
+                av_assert2(IS_SUB_4X4(sub_mb_type));
+                for (int j = 0; j < 4; j++)
+                    mc_part_lowres(h, sl, n + j, x + 4 * (j & 1),
+                                   y + 2 * (j & 2), 4, 4, list0, list1);
+            }
+        }
+    }
+}
+
+/**
+ * Decode one macroblock at 1 / (1 << lowres) of the coded size.
+ *
+ * Inter prediction is done at the reduced size and written out directly
+ * for macroblocks without residual. Otherwise the macroblock is
+ * reconstructed at full size by the regular code in a scratch buffer,
+ * starting from the upsampled prediction or intra neighbours, and box
+ * filtered into the frame. The loop filter and error concealment are
+ * disabled, so the output drifts from the exact decode over time.
+ */
+static void hl_decode_mb_lowres(const H264Context *h, H264SliceContext *sl)
+{
+    const int lowres      = h->avctx->lowres;
+    const int pixel_shift = h->pixel_shift;
+    const int mb_x        = sl->mb_x;
+    const int mb_y        = sl->mb_y;
+    const int mb_field    = MB_FIELD(sl);
+    const int mb_type     = h->cur_pic.mb_type[sl->mb_xy];
+    const int nb_planes   = CONFIG_GRAY && h->flags & AV_CODEC_FLAG_GRAY ? 1 : 3;
+    uint8_t *dest[3];
+
+    sl->mb_linesize   = sl->linesize   << mb_field;
+    sl->mb_uvlinesize = sl->uvlinesize << mb_field;
+
+    for (int p = 0; p < 3; p++) {
+        const int width  = 16 >> (lowres + (p ? h->chroma_x_shift : 0));
+        const int height = 16 >> (lowres + (p ? h->chroma_y_shift : 0));
+        const int row    = ((mb_y >> mb_field) * height << mb_field) +
+                           (mb_field & mb_y);
+
+        dest[p] = h->cur_pic.f->data[p] + (mb_x * width << pixel_shift) +
+                  row * (p ? sl->uvlinesize : sl->linesize);
+    }
+
+    if (!IS_INTRA(mb_type)) {
+        if (FRAME_MBAFF(h) && mb_field)
+            mbaff_field_ref_cache(sl, mb_type);
+        if (HAVE_THREADS && (h->avctx->active_thread_type & FF_THREAD_FRAME))
+            await_references(h, sl);
+        hl_motion_lowres(h, sl, mb_type);
+    }
+
+    for (int p = 0; p < nb_planes; p++) {
+        const int shift_x    = p ? h->chroma_x_shift : 0;
+        const int shift_y    = p ? h->chroma_y_shift : 0;
+        const int width      = 16 >> shift_x;
+        const int height     = 16 >> shift_y;
+        const ptrdiff_t linesize = p ? sl->mb_uvlinesize : sl->mb_linesize;
+        const uint8_t *mc    = sl->lowres_scratch + 3 * H264_LOWRES_SCRATCH_PLANE +
+                               p * H264_LOWRES_MC_PLANE;
+        uint8_t *scratch     = sl->lowres_scratch + p * H264_LOWRES_SCRATCH_PLANE +
+                               H264_LOWRES_SCRATCH_STRIDE + (16 << pixel_shift);
+
+        if (!IS_INTRA(mb_type) && !sl->cbp) {
+            for (int y = 0; y < height >> lowres; y++)
+                memcpy(dest[p] + y * linesize, mc + y * H264_LOWRES_MC_STRIDE,
+                       (width >> lowres) << pixel_shift);
+        } else if (!IS_INTRA(mb_type)) {
+            for (int y = 0; y < height; y++)
+                for (int x = 0; x < width; x++)
+                    pixel_set(scratch + y * H264_LOWRES_SCRATCH_STRIDE, pixel_shift, x,
+                              pixel_get(mc + (y >> lowres) * H264_LOWRES_MC_STRIDE,
+                                        pixel_shift, x >> lowres));
+        } else {
+            /* only read neighbours from macroblocks of the same slice,
+             * others may still be decoded by another thread */
+            const uint8_t *top = dest[p] - linesize;
+            const int left_x   = sl->left_type[LTOP] && sl->topleft_type ? -1 : 0;
+            const int right_x  = width + (sl->topright_type ? 8 : 0);
+
+            if (sl->top_type)
+                for (int x = left_x; x < right_x; x++)
+                    pixel_set(scratch - H264_LOWRES_SCRATCH_STRIDE, pixel_shift, x,
+                              pixel_get(top, pixel_shift, x >> lowres));
+            if (sl->left_type[LTOP])
+                for (int y = 0; y < height; y++)
+                    pixel_set(scratch + y * H264_LOWRES_SCRATCH_STRIDE, pixel_shift, -1,
+                              pixel_get(dest[p] + (y >> lowres) * linesize,
+                                        pixel_shift, -1));
+        }
+    }
+
+    if (!IS_INTRA(mb_type) && !sl->cbp) {
+        h->list_counts[sl->mb_xy] = sl->list_count;
+        return;
+    }
+
+    if (CHROMA444(h))
+        hl_decode_mb_444_complex(h, sl);
+    else
+        hl_decode_mb_complex(h, sl);
+
+    for (int p = 0; p < nb_planes; p++) {
+        const int width  = 16 >> (lowres + (p ? h->chroma_x_shift : 0));
+        const int height = 16 >> (lowres + (p ? h->chroma_y_shift : 0));
+        const ptrdiff_t linesize = p ? sl->mb_uvlinesize : sl->mb_linesize;
+        const uint8_t *scratch = sl->lowres_scratch + p * H264_LOWRES_SCRATCH_PLANE +
+                                 H264_LOWRES_SCRATCH_STRIDE + (16 << pixel_shift);
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                const uint8_t *src = scratch + (y << lowres) * H264_LOWRES_SCRATCH_STRIDE;
+                int sum = 0;
+
+                for (int j = 0; j < 1 << lowres; j++, src += H264_LOWRES_SCRATCH_STRIDE)
+                    for (int i = 0; i < 1 << lowres; i++)
+                        sum += pixel_get(src, pixel_shift, (x << lowres) + i);
+                pixel_set(dest[p] + y * linesize, pixel_shift, x,
+                          (sum + (1 << (2 * lowres - 1))) >> (2 * lowres));
+            }
+        }
+    }
+}
+
 void ff_h264_hl_decode_mb(const H264Context *h, H264SliceContext *sl)
 {
     const int mb_xy   = sl->mb_xy;
@@ -804,6 +1187,11 @@ void ff_h264_hl_decode_mb(const H264Context *h, H264SliceContext *sl)
     int is_complex    = CONFIG_SMALL || sl->is_complex ||
                         IS_INTRA_PCM(mb_type) || sl->qscale == 0;
 
+    if (h->avctx->lowres) {
+        hl_decode_mb_lowres(h, sl);
+        return;
+    }
+
     if (CHROMA444(h)) {
         if (is_complex || h->pixel_shift)
             hl_decode_mb_444_complex(h, sl);
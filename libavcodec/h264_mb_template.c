@@ -62,7 +62,15 @@ static av_noinline void FUNC(hl_decode_mb)(const H264Context *h, H264SliceContex
 
     h->list_counts[mb_xy] = sl->list_count;
 
-    if (!SIMPLE && MB_FIELD(sl)) {
+    if (!SIMPLE && h->avctx->lowres) {
+        /* reconstruct into the full size scratch macroblock,
+         * see hl_decode_mb_lowres() */
+        linesize     = uvlinesize = H264_LOWRES_SCRATCH_STRIDE;
+        block_offset = sl->lowres_block_offset;
+        dest_y       = sl->lowres_scratch + linesize + (16 << PIXEL_SHIFT);
+        dest_cb      = dest_y  + H264_LOWRES_SCRATCH_PLANE;
+        dest_cr      = dest_cb + H264_LOWRES_SCRATCH_PLANE;
+    } else if (!SIMPLE && MB_FIELD(sl)) {
         linesize     = sl->mb_linesize = sl->linesize * 2;
         uvlinesize   = sl->mb_uvlinesize = sl->uvlinesize * 2;
         block_offset = &h->block_offset[48];
@@ -71,24 +79,8 @@ static av_noinline void FUNC(hl_decode_mb)(const H264Context *h, H264SliceContex
             dest_cb -= sl->uvlinesize * (block_h - 1);
             dest_cr -= sl->uvlinesize * (block_h - 1);
         }
-        if (FRAME_MBAFF(h)) {
-            int list;
-            for (list = 0; list < sl->list_count; list++) {
-                if (!USES_LIST(mb_type, list))
-                    continue;
-                if (IS_16X16(mb_type)) {
-                    int8_t *ref = &sl->ref_cache[list][scan8[0]];
-                    fill_rectangle(ref, 4, 4, 8, (16 + *ref) ^ (sl->mb_y & 1), 1);
-                } else {
-                    for (i = 0; i < 16; i += 4) {
-                        int ref = sl->ref_cache[list][scan8[i]];
-                        if (ref >= 0)
-                            fill_rectangle(&sl->ref_cache[list][scan8[i]], 2, 2,
-                                           8, (16 + ref) ^ (sl->mb_y & 1), 1);
-                    }
-                }
-            }
-        }
+        if (FRAME_MBAFF(h))
+            mbaff_field_ref_cache(sl, mb_type);
     } else {
         linesize   = sl->mb_linesize   = sl->linesize;
         uvlinesize = sl->mb_uvlinesize = sl->uvlinesize;
@@ -167,7 +159,7 @@ static av_noinline void FUNC(hl_decode_mb)(const H264Context *h, H264SliceContex
             if (sl->deblocking_filter)
                 xchg_mb_border(h, sl, dest_y, dest_cb, dest_cr, linesize,
                                uvlinesize, 0, 0, SIMPLE, PIXEL_SHIFT);
-        } else {
+        } else if (SIMPLE || !h->avctx->lowres) {
             if (chroma422) {
                 FUNC(hl_motion_422)(h, sl, dest_y, dest_cb, dest_cr,
                               h->h264qpel.put_h264_qpel_pixels_tab,
@@ -275,30 +267,20 @@ static av_noinline void FUNC(hl_decode_mb_444)(const H264Context *h, H264SliceCo
 
     h->list_counts[mb_xy] = sl->list_count;
 
-    if (!SIMPLE && MB_FIELD(sl)) {
+    if (!SIMPLE && h->avctx->lowres) {
+        linesize     = H264_LOWRES_SCRATCH_STRIDE;
+        block_offset = sl->lowres_block_offset;
+        for (p = 0; p < 3; p++)
+            dest[p] = sl->lowres_scratch + p * H264_LOWRES_SCRATCH_PLANE +
+                      linesize + (16 << PIXEL_SHIFT);
+    } else if (!SIMPLE && MB_FIELD(sl)) {
         linesize     = sl->mb_linesize = sl->mb_uvlinesize = sl->linesize * 2;
         block_offset = &h->block_offset[48];
         if (mb_y & 1) // FIXME move out of this function?
             for (p = 0; p < 3; p++)
                 dest[p] -= sl->linesize * 15;
-        if (FRAME_MBAFF(h)) {
-            int list;
-            for (list = 0; list < sl->list_count; list++) {
-                if (!USES_LIST(mb_type, list))
-                    continue;
-                if (IS_16X16(mb_type)) {
-                    int8_t *ref = &sl->ref_cache[list][scan8[0]];
-                    fill_rectangle(ref, 4, 4, 8, (16 + *ref) ^ (sl->mb_y & 1), 1);
-                } else {
-                    for (i = 0; i < 16; i += 4) {
-                        int ref = sl->ref_cache[list][scan8[i]];
-                        if (ref >= 0)
-                            fill_rectangle(&sl->ref_cache[list][scan8[i]], 2, 2,
-                                           8, (16 + ref) ^ (sl->mb_y & 1), 1);
-                    }
-                }
-            }
-        }
+        if (FRAME_MBAFF(h))
+            mbaff_field_ref_cache(sl, mb_type);
     } else {
         linesize = sl->mb_linesize = sl->mb_uvlinesize = sl->linesize;
     }
@@ -335,7 +317,7 @@ static av_noinline void FUNC(hl_decode_mb_444)(const H264Context *h, H264SliceCo
             if (sl->deblocking_filter)
                 xchg_mb_border(h, sl, dest[0], dest[1], dest[2], linesize,
                                linesize, 0, 1, SIMPLE, PIXEL_SHIFT);
-        } else {
+        } else if (SIMPLE || !h->avctx->lowres) {
             FUNC(hl_motion_444)(h, sl, dest[0], dest[1], dest[2],
                       h->h264qpel.put_h264_qpel_pixels_tab,
                       h->h264chroma.put_h264_chroma_pixels_tab,
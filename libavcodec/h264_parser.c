@@ -259,7 +259,7 @@ static inline int parse_nal_units(AVCodecParserContext *s,
                                   const uint8_t * const buf, int buf_size)
 {
     H264ParseContext *p = s->priv_data;
-    H2645RBSP rbsp = { NULL };
+    H2645RBSP rbsp = { .find_candidate = p->h264dsp.startcode_find_candidate };
     H2645NAL nal = { NULL };
     int buf_index, next_avc;
     unsigned int pps_id;
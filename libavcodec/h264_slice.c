@@ -156,6 +156,25 @@ static int alloc_scratch_buffers(H264SliceContext *sl, int linesize)
         return AVERROR(ENOMEM);
     }
 
+    if (h->avctx->lowres) {
+        const int stride = H264_LOWRES_SCRATCH_STRIDE;
+
+        av_fast_malloc(&sl->lowres_scratch, &sl->lowres_scratch_allocated,
+                       H264_LOWRES_SCRATCH_SIZE);
+        if (!sl->lowres_scratch) {
+            sl->lowres_scratch_allocated = 0;
+            return AVERROR(ENOMEM);
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int offset = (4 * ((scan8[i] - scan8[0]) & 7) << h->pixel_shift) +
+                         4 * stride * ((scan8[i] - scan8[0]) >> 3);
+            sl->lowres_block_offset[i]      =
+            sl->lowres_block_offset[16 + i] =
+            sl->lowres_block_offset[32 + i] = offset;
+        }
+    }
+
     return 0;
 }
 
@@ -912,6 +931,13 @@ static enum AVPixelFormat get_pixel_format(H264Context *h, int force_callback)
         return AVERROR_INVALIDDATA;
     }
 
+    /* hardware decoders cannot reconstruct at reduced resolution,
+     * keep only the software format, which is always the last one */
+    if (h->avctx->lowres) {
+        pix_fmts[0] = fmt[-1];
+        fmt = pix_fmts + 1;
+    }
+
     *fmt = AV_PIX_FMT_NONE;
 
     for (int i = 0; pix_fmts[i] != AV_PIX_FMT_NONE; i++)
@@ -924,6 +950,7 @@ static enum AVPixelFormat get_pixel_format(H264Context *h, int force_callback)
 static void init_dimensions(H264Context *h)
 {
     const SPS *sps = h->ps.sps;
+    const int lowres = h->avctx->lowres;
     int cr = sps->crop_right;
     int cl = sps->crop_left;
     int ct = sps->crop_top;
@@ -951,14 +978,15 @@ static void init_dimensions(H264Context *h)
         h->height_from_caller = 0;
     }
 
+    /* with lowres, frames are allocated and cropped at the reduced size */
     h->avctx->coded_width  = h->width;
     h->avctx->coded_height = h->height;
-    h->avctx->width        = width;
-    h->avctx->height       = height;
-    h->crop_right          = cr;
-    h->crop_left           = cl;
-    h->crop_top            = ct;
-    h->crop_bottom         = cb;
+    h->avctx->width        = AV_CEIL_RSHIFT(width,  lowres);
+    h->avctx->height       = AV_CEIL_RSHIFT(height, lowres);
+    h->crop_left           = cl >> lowres;
+    h->crop_top            = ct >> lowres;
+    h->crop_right          = (h->width  >> lowres) - h->avctx->width  - h->crop_left;
+    h->crop_bottom         = (h->height >> lowres) - h->avctx->height - h->crop_top;
 }
 
 static int h264_slice_header_init(H264Context *h)
@@ -1296,13 +1324,18 @@ static int h264_select_output_frame(H264Context *h)
     const SPS *sps = h->ps.sps;
     H264Picture *out = h->cur_pic_ptr;
     H264Picture *cur = h->cur_pic_ptr;
+    int keyframes_only = h->avctx->flags2 & AV_CODEC_FLAG2_KEYFRAMES_ONLY;
     int i, pics, out_of_order, out_idx;
 
     cur->mmco_reset = h->mmco_reset;
     h->mmco_reset = 0;
 
-    if (sps->bitstream_restriction_flag ||
-        h->avctx->strict_std_compliance >= FF_COMPLIANCE_STRICT) {
+    if (keyframes_only) {
+        /* Only random access points are fed to the decoder, there is
+         * nothing to reorder them with. */
+        h->avctx->has_b_frames = 0;
+    } else if (sps->bitstream_restriction_flag ||
+               h->avctx->strict_std_compliance >= FF_COMPLIANCE_STRICT) {
         h->avctx->has_b_frames = FFMAX(h->avctx->has_b_frames, sps->num_reorder_frames);
     }
 
@@ -1325,7 +1358,8 @@ static int h264_select_output_frame(H264Context *h)
             h->last_pocs[i] = INT_MIN;
         h->last_pocs[0] = cur->poc;
         cur->mmco_reset = 1;
-    } else if(h->avctx->has_b_frames < out_of_order && !sps->bitstream_restriction_flag){
+    } else if(h->avctx->has_b_frames < out_of_order && !sps->bitstream_restriction_flag &&
+              !keyframes_only){
         int loglevel = h->avctx->frame_num > 1 ? AV_LOG_WARNING : AV_LOG_VERBOSE;
         av_log(h->avctx, loglevel, "Increasing reorder buffer to %d\n", out_of_order);
         h->avctx->has_b_frames = out_of_order;
@@ -1351,8 +1385,8 @@ static int h264_select_output_frame(H264Context *h)
             out     = h->delayed_pic[i];
             out_idx = i;
         }
-    if (h->avctx->has_b_frames == 0 &&
-        ((h->delayed_pic[0]->f->flags & AV_FRAME_FLAG_KEY) || h->delayed_pic[0]->mmco_reset))
+    if (keyframes_only || (h->avctx->has_b_frames == 0 &&
+        ((h->delayed_pic[0]->f->flags & AV_FRAME_FLAG_KEY) || h->delayed_pic[0]->mmco_reset)))
         h->next_outputed_poc = INT_MIN;
     out_of_order = out->poc < h->next_outputed_poc;
 
@@ -1952,7 +1986,9 @@ static int h264_slice_init(H264Context *h, H264SliceContext *sl,
     if (!h->setup_finished)
         ff_h264_direct_ref_list_init(h, sl);
 
-    if (h->avctx->skip_loop_filter >= AVDISCARD_ALL ||
+    /* the loop filter works on full resolution macroblocks */
+    if (h->avctx->lowres ||
+        h->avctx->skip_loop_filter >= AVDISCARD_ALL ||
         (h->avctx->skip_loop_filter >= AVDISCARD_NONKEY &&
          h->nal_unit_type != H264_NAL_IDR_SLICE) ||
         (h->avctx->skip_loop_filter >= AVDISCARD_NONINTRA &&
@@ -121,7 +121,9 @@ void ff_h264_draw_horiz_band(const H264Context *h, H264SliceContext *sl,
         y      <<= 1;
     }
 
-    height = FFMIN(height, avctx->height - y);
+    y      >>= avctx->lowres;
+    height >>= avctx->lowres;
+    height   = FFMIN(height, avctx->height - y);
 
     desc   = av_pix_fmt_desc_get(avctx->pix_fmt);
     vshift = desc->log2_chroma_h;
@@ -175,11 +177,13 @@ void ff_h264_free_tables(H264Context *h)
         av_freep(&sl->edge_emu_buffer);
         av_freep(&sl->top_borders[0]);
         av_freep(&sl->top_borders[1]);
+        av_freep(&sl->lowres_scratch);
 
         sl->bipred_scratchpad_allocated = 0;
         sl->edge_emu_buffer_allocated   = 0;
         sl->top_borders_allocated[0]    = 0;
         sl->top_borders_allocated[1]    = 0;
+        sl->lowres_scratch_allocated    = 0;
     }
 }
 
@@ -421,6 +425,10 @@ static av_cold int h264_decode_init(AVCodecContext *avctx)
 
     ff_h264_flush_change(h);
 
+    /* error concealment works on full resolution macroblocks */
+    if (avctx->lowres)
+        h->enable_er = 0;
+
     if (h->enable_er < 0 && (avctx->active_thread_type & FF_THREAD_SLICE))
         h->enable_er = 0;
 
@@ -1118,6 +1126,7 @@ const FFCodec ff_h264_decoder = {
     .p.capabilities        = AV_CODEC_CAP_DR1 |
                              AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS |
                              AV_CODEC_CAP_FRAME_THREADS,
+    .p.max_lowres          = 3,
     .hw_configs            = (const AVCodecHWConfigInternal *const []) {
 #if CONFIG_H264_DXVA2_HWACCEL
                                HWACCEL_DXVA2(h264),
@@ -177,6 +177,19 @@ typedef struct H264Ref {
     const H264Picture *parent;
 } H264Ref;
 
+/**
+ * Layout of H264SliceContext.lowres_scratch: three full size macroblock
+ * planes with a one sample top/left border and room for the top right
+ * samples, followed by two sets of three reduced size motion compensation
+ * planes. Strides are in bytes and large enough for high bit depth.
+ */
+#define H264_LOWRES_SCRATCH_STRIDE (48 * 2)
+#define H264_LOWRES_SCRATCH_PLANE  (17 * H264_LOWRES_SCRATCH_STRIDE)
+#define H264_LOWRES_MC_STRIDE      (16 * 2)
+#define H264_LOWRES_MC_PLANE       (10 * H264_LOWRES_MC_STRIDE)
+#define H264_LOWRES_SCRATCH_SIZE   (3 * H264_LOWRES_SCRATCH_PLANE + \
+                                    6 * H264_LOWRES_MC_PLANE)
+
 typedef struct H264SliceContext {
     const struct H264Context *h264;
     GetBitContext gb;
@@ -289,6 +302,14 @@ typedef struct H264SliceContext {
     int edge_emu_buffer_allocated;
     int top_borders_allocated[2];
 
+    /**
+     * lowres decoding: full size reconstruction scratch macroblock and
+     * reduced size motion compensation buffers, see hl_decode_mb_lowres()
+     */
+    uint8_t *lowres_scratch;
+    int lowres_scratch_allocated;
+    int lowres_block_offset[48];
+
     /**
      * non zero coeff count cache.
      * is 64 if not available.
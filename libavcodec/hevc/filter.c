@@ -877,7 +877,9 @@ void ff_hevc_hls_filter(HEVCLocalContext *lc, const HEVCLayerContext *l,
     const HEVCContext *const s = lc->parent;
     int x_end = x >= sps->width  - ctb_size;
     int skip = 0;
-    if (s->avctx->skip_loop_filter >= AVDISCARD_ALL ||
+    /* the loop filters work on full resolution CTBs */
+    if (s->avctx->lowres ||
+        s->avctx->skip_loop_filter >= AVDISCARD_ALL ||
         (s->avctx->skip_loop_filter >= AVDISCARD_NONKEY && !IS_IDR(s)) ||
         (s->avctx->skip_loop_filter >= AVDISCARD_NONINTRA &&
          s->sh.slice_type != HEVC_SLICE_I) ||
@@ -336,9 +336,12 @@ static void export_stream_params(HEVCContext *s, const HEVCSPS *sps)
     avctx->pix_fmt             = sps->pix_fmt;
     avctx->coded_width         = sps->width;
     avctx->coded_height        = sps->height;
-    avctx->width               = sps->width  - ow->left_offset - ow->right_offset;
-    avctx->height              = sps->height - ow->top_offset  - ow->bottom_offset;
-    avctx->has_b_frames        = sps->temporal_layer[sps->max_sub_layers - 1].num_reorder_pics;
+    avctx->width               = AV_CEIL_RSHIFT((int)(sps->width  - ow->left_offset - ow->right_offset),
+                                                avctx->lowres);
+    avctx->height              = AV_CEIL_RSHIFT((int)(sps->height - ow->top_offset  - ow->bottom_offset),
+                                                avctx->lowres);
+    avctx->has_b_frames        = (avctx->flags2 & AV_CODEC_FLAG2_KEYFRAMES_ONLY) ? 0 :
+                                 sps->temporal_layer[sps->max_sub_layers - 1].num_reorder_pics;
     avctx->profile             = sps->ptl.general_ptl.profile_idc;
     avctx->level               = sps->ptl.general_ptl.level_idc;
 
@@ -710,6 +713,10 @@ static enum AVPixelFormat get_format(HEVCContext *s, const HEVCSPS *sps)
         break;
     }
 
+    /* hardware decoders cannot reconstruct at reduced resolution */
+    if (s->avctx->lowres)
+        fmt = pix_fmts;
+
     if (alpha_fmt != AV_PIX_FMT_NONE)
         *fmt++ = alpha_fmt;
     *fmt++ = sps->pix_fmt;
@@ -752,6 +759,7 @@ static int set_sps(HEVCContext *s, HEVCLayerContext *l, const HEVCSPS *sps)
     ff_hevc_pred_init(&s->hpc,     sps->bit_depth);
     ff_hevc_dsp_init (&s->hevcdsp, sps->bit_depth);
     ff_videodsp_init (&s->vdsp,    sps->bit_depth);
+    ff_h264chroma_init(&s->h264chroma, sps->bit_depth);
 
     l->sps    = av_refstruct_ref_c(sps);
     s->vps    = av_refstruct_ref_c(sps->vps);
@@ -1405,15 +1413,15 @@ static int hls_transform_unit(HEVCLocalContext *lc,
                                                 log2_trafo_size_c, scan_idx_c, 1);
                 else
                     if (lc->tu.cross_pf) {
-                        ptrdiff_t stride = s->cur_frame->f->linesize[1];
+                        ptrdiff_t stride;
                         int hshift = sps->hshift[1];
                         int vshift = sps->vshift[1];
                         const int16_t *coeffs_y = (int16_t*)lc->edge_emu_buffer;
                         int16_t *coeffs   = (int16_t*)lc->edge_emu_buffer2;
                         int size = 1 << log2_trafo_size_c;
 
-                        uint8_t *dst = &s->cur_frame->f->data[1][(y0 >> vshift) * stride +
-                                                              ((x0 >> hshift) << sps->pixel_shift)];
+                        uint8_t *dst = ff_hevc_recon_ptr(lc, sps, 1, x0 >> hshift,
+                                                         y0 >> vshift, &stride);
                         for (i = 0; i < (size * size); i++) {
                             coeffs[i] = ((lc->tu.res_scale_val * coeffs_y[i]) >> 3);
                         }
@@ -1435,15 +1443,15 @@ static int hls_transform_unit(HEVCLocalContext *lc,
                                                 log2_trafo_size_c, scan_idx_c, 2);
                 else
                     if (lc->tu.cross_pf) {
-                        ptrdiff_t stride = s->cur_frame->f->linesize[2];
+                        ptrdiff_t stride;
                         int hshift = sps->hshift[2];
                         int vshift = sps->vshift[2];
                         const int16_t *coeffs_y = (int16_t*)lc->edge_emu_buffer;
                         int16_t *coeffs   = (int16_t*)lc->edge_emu_buffer2;
                         int size = 1 << log2_trafo_size_c;
 
-                        uint8_t *dst = &s->cur_frame->f->data[2][(y0 >> vshift) * stride +
-                                                          ((x0 >> hshift) << sps->pixel_shift)];
+                        uint8_t *dst = ff_hevc_recon_ptr(lc, sps, 2, x0 >> hshift,
+                                                         y0 >> vshift, &stride);
                         for (i = 0; i < (size * size); i++) {
                             coeffs[i] = ((lc->tu.res_scale_val * coeffs_y[i]) >> 3);
                         }
@@ -1658,12 +1666,10 @@ static int hls_pcm_sample(HEVCLocalContext *lc, const HEVCLayerContext *l,
     const HEVCSPS   *const sps = pps->sps;
     GetBitContext gb;
     int cb_size   = 1 << log2_cb_size;
-    ptrdiff_t stride0 = s->cur_frame->f->linesize[0];
-    ptrdiff_t stride1 = s->cur_frame->f->linesize[1];
-    ptrdiff_t stride2 = s->cur_frame->f->linesize[2];
-    uint8_t *dst0 = &s->cur_frame->f->data[0][y0 * stride0 + (x0 << sps->pixel_shift)];
-    uint8_t *dst1 = &s->cur_frame->f->data[1][(y0 >> sps->vshift[1]) * stride1 + ((x0 >> sps->hshift[1]) << sps->pixel_shift)];
-    uint8_t *dst2 = &s->cur_frame->f->data[2][(y0 >> sps->vshift[2]) * stride2 + ((x0 >> sps->hshift[2]) << sps->pixel_shift)];
+    ptrdiff_t stride0, stride1, stride2;
+    uint8_t *dst0 = ff_hevc_recon_ptr(lc, sps, 0, x0, y0, &stride0);
+    uint8_t *dst1 = ff_hevc_recon_ptr(lc, sps, 1, x0 >> sps->hshift[1], y0 >> sps->vshift[1], &stride1);
+    uint8_t *dst2 = ff_hevc_recon_ptr(lc, sps, 2, x0 >> sps->hshift[2], y0 >> sps->vshift[2], &stride2);
 
     int length         = cb_size * cb_size * sps->pcm.bit_depth +
                          (((cb_size >> sps->hshift[1]) * (cb_size >> sps->vshift[1])) +
@@ -2088,6 +2094,170 @@ static void hevc_luma_mv_mvp_mode(HEVCLocalContext *lc,
     }
 }
 
+static av_always_inline int pixel_get(const uint8_t *buf, int pixel_shift,
+                                      int index)
+{
+    return pixel_shift ? AV_RN16A(buf + 2 * index) : buf[index];
+}
+
+static av_always_inline void pixel_set(uint8_t *buf, int pixel_shift,
+                                       int index, int value)
+{
+    if (pixel_shift)
+        AV_WN16A(buf + 2 * index, value);
+    else
+        buf[index] = value;
+}
+
+/**
+ * Bilinear motion compensation of one plane of a prediction block at the
+ * reduced size, using the H.264 chroma MC functions.
+ *
+ * @param x,y position in units of 1 / (1 << frac_bits) reduced size samples
+ * @param pic_width,pic_height reduced size plane dimensions
+ */
+static void lowres_mc_plane(HEVCLocalContext *lc, const HEVCSPS *sps,
+                            uint8_t *dst, const uint8_t *src, ptrdiff_t srcstride,
+                            int pic_width, int pic_height,
+                            int x, int y, int frac_bits_x, int frac_bits_y,
+                            int block_w, int block_h, int avg)
+{
+    const HEVCContext *const s = lc->parent;
+    const h264_chroma_mc_func *op = avg ? s->h264chroma.avg_h264_chroma_pixels_tab :
+                                          s->h264chroma.put_h264_chroma_pixels_tab;
+    const int full_x = x >> frac_bits_x;
+    const int full_y = y >> frac_bits_y;
+    const int mx     = ((x & ((1 << frac_bits_x) - 1)) << 3) >> frac_bits_x;
+    const int my     = ((y & ((1 << frac_bits_y) - 1)) << 3) >> frac_bits_y;
+    /* the SIMD versions only handle even heights, the MC buffers are
+     * large enough for the extra row */
+    const int mc_h   = FFALIGN(block_h, 2);
+
+    /* always go through the edge emulation buffer, the MC functions use
+     * the same stride for source and destination */
+    s->vdsp.emulated_edge_mc(lc->edge_emu_buffer,
+                             src + full_y * srcstride + (full_x << sps->pixel_shift),
+                             HEVC_LOWRES_MC_STRIDE, srcstride,
+                             block_w + 1, mc_h + 1, full_x, full_y,
+                             pic_width, pic_height);
+
+    for (int i = 0; i < block_w;) {
+        const int w = 1 << FFMIN(av_log2(block_w - i), 3);
+
+        op[3 - av_log2(w)](dst + (i << sps->pixel_shift),
+                           lc->edge_emu_buffer + (i << sps->pixel_shift),
+                           HEVC_LOWRES_MC_STRIDE, mc_h, mx, my);
+        i += w;
+    }
+}
+
+/**
+ * Inter prediction of a prediction block at the reduced size. The result
+ * is upsampled into the full size reconstruction of the CTB, so that the
+ * residual can be added by the regular code.
+ */
+static void lowres_prediction_unit(HEVCLocalContext *lc,
+                                   const HEVCPPS *pps, const HEVCSPS *sps,
+                                   int x0, int y0, int nPbW, int nPbH,
+                                   const MvField *current_mv,
+                                   const HEVCFrame *ref0, const HEVCFrame *ref1)
+{
+    const HEVCContext *const s = lc->parent;
+    const int lowres      = s->avctx->lowres;
+    const int pixel_shift = sps->pixel_shift;
+    const int bit_depth   = sps->bit_depth;
+    const int weight_flag = (s->sh.slice_type == HEVC_SLICE_P && pps->weighted_pred_flag) ||
+                            (s->sh.slice_type == HEVC_SLICE_B && pps->weighted_bipred_flag);
+    const int bi          = current_mv->pred_flag == PF_BI;
+    uint8_t *mc0 = lc->lowres_scratch + 3 * HEVC_LOWRES_PLANE;
+    uint8_t *mc1 = mc0 + HEVC_LOWRES_MC_PLANE;
+
+    for (int c_idx = 0; c_idx < (sps->chroma_format_idc ? 3 : 1); c_idx++) {
+        const int hshift = sps->hshift[c_idx];
+        const int vshift = sps->vshift[c_idx];
+        const int xc     = x0   >> hshift;
+        const int yc     = y0   >> vshift;
+        const int wc     = nPbW >> hshift;
+        const int hc     = nPbH >> vshift;
+        const int lx     = xc >> lowres;
+        const int ly     = yc >> lowres;
+        const int lw     = ((xc + wc - 1) >> lowres) - lx + 1;
+        const int lh     = ((yc + hc - 1) >> lowres) - ly + 1;
+        ptrdiff_t linesize;
+        uint8_t *dst;
+
+        for (int list = 0; list < 2; list++) {
+            const HEVCFrame *ref = list ? ref1 : ref0;
+            const Mv *mv = &current_mv->mv[list];
+
+            if (!(current_mv->pred_flag & (1 << list)))
+                continue;
+
+            lowres_mc_plane(lc, sps, list && bi && weight_flag ? mc1 : mc0,
+                            ref->f->data[c_idx], ref->f->linesize[c_idx],
+                            AV_CEIL_RSHIFT(sps->width  >> hshift, lowres),
+                            AV_CEIL_RSHIFT(sps->height >> vshift, lowres),
+                            (lx << (lowres + 2 + hshift)) + mv->x,
+                            (ly << (lowres + 2 + vshift)) + mv->y,
+                            lowres + 2 + hshift, lowres + 2 + vshift,
+                            lw, lh, list && bi && !weight_flag);
+        }
+
+        if (weight_flag) {
+            const int denom = c_idx ? s->sh.chroma_log2_weight_denom :
+                                      s->sh.luma_log2_weight_denom;
+            const int ref_idx0 = current_mv->ref_idx[0];
+            const int ref_idx1 = current_mv->ref_idx[1];
+            int w0, w1, o0, o1;
+
+            if (c_idx) {
+                w0 = s->sh.chroma_weight_l0[ref_idx0][c_idx - 1];
+                w1 = s->sh.chroma_weight_l1[ref_idx1][c_idx - 1];
+                o0 = s->sh.chroma_offset_l0[ref_idx0][c_idx - 1];
+                o1 = s->sh.chroma_offset_l1[ref_idx1][c_idx - 1];
+            } else {
+                w0 = s->sh.luma_weight_l0[ref_idx0];
+                w1 = s->sh.luma_weight_l1[ref_idx1];
+                o0 = s->sh.luma_offset_l0[ref_idx0];
+                o1 = s->sh.luma_offset_l1[ref_idx1];
+            }
+            o0 *= 1 << (bit_depth - 8);
+            o1 *= 1 << (bit_depth - 8);
+
+            for (int y = 0; y < lh; y++) {
+                uint8_t *p0       = mc0 + y * HEVC_LOWRES_MC_STRIDE;
+                const uint8_t *p1 = mc1 + y * HEVC_LOWRES_MC_STRIDE;
+
+                for (int x = 0; x < lw; x++) {
+                    int v;
+
+                    if (bi) {
+                        v = (pixel_get(p0, pixel_shift, x) * w0 +
+                             pixel_get(p1, pixel_shift, x) * w1 +
+                             (o0 + o1 + 1) * (1 << denom)) >> (denom + 1);
+                    } else {
+                        const int w = current_mv->pred_flag == PF_L0 ? w0 : w1;
+                        const int o = current_mv->pred_flag == PF_L0 ? o0 : o1;
+
+                        v = ((pixel_get(p0, pixel_shift, x) * w +
+                              (denom ? 1 << (denom - 1) : 0)) >> denom) + o;
+                    }
+                    pixel_set(p0, pixel_shift, x, av_clip_uintp2(v, bit_depth));
+                }
+            }
+        }
+
+        dst = ff_hevc_recon_ptr(lc, sps, c_idx, xc, yc, &linesize);
+        for (int y = 0; y < hc; y++) {
+            const uint8_t *src = mc0 + (((yc + y) >> lowres) - ly) * HEVC_LOWRES_MC_STRIDE;
+
+            for (int x = 0; x < wc; x++)
+                pixel_set(dst + y * linesize, pixel_shift, x,
+                          pixel_get(src, pixel_shift, ((xc + x) >> lowres) - lx));
+        }
+    }
+}
+
 static void hls_prediction_unit(HEVCLocalContext *lc,
                                 const HEVCLayerContext *l,
                                 const HEVCPPS *pps, const HEVCSPS *sps,
@@ -2156,6 +2326,12 @@ static void hls_prediction_unit(HEVCLocalContext *lc,
         hevc_await_progress(s, ref1, &current_mv.mv[1], y0, nPbH);
     }
 
+    if (s->avctx->lowres) {
+        lowres_prediction_unit(lc, pps, sps, x0, y0, nPbW, nPbH,
+                               &current_mv, ref0, ref1);
+        return;
+    }
+
     if (current_mv.pred_flag == PF_L0) {
         int x0_c = x0 >> sps->hshift[1];
         int y0_c = y0 >> sps->vshift[1];
@@ -2744,6 +2920,108 @@ static void hls_decode_neighbour(HEVCLocalContext *lc,
     lc->ctb_up_left_flag = ((x_ctb > 0) && (y_ctb > 0)  && (ctb_addr_in_slice-1 >= sps->ctb_width) && (pps->tile_id[ctb_addr_ts] == pps->tile_id[pps->ctb_addr_rs_to_ts[ctb_addr_rs-1 - sps->ctb_width]]));
 }
 
+/**
+ * Prepare the full size reconstruction of a CTB for lowres decoding by
+ * upsampling the neighbouring samples that intra prediction may use from
+ * the reduced size frame.
+ */
+static int lowres_ctb_start(HEVCLocalContext *lc, const HEVCSPS *sps,
+                            int x_ctb, int y_ctb)
+{
+    const HEVCContext *const s = lc->parent;
+    const AVFrame *frame  = s->cur_frame->f;
+    const int lowres      = s->avctx->lowres;
+    const int pixel_shift = sps->pixel_shift;
+
+    av_fast_malloc(&lc->lowres_scratch, &lc->lowres_scratch_size,
+                   HEVC_LOWRES_SCRATCH_SIZE);
+    if (!lc->lowres_scratch)
+        return AVERROR(ENOMEM);
+
+    lc->lowres_ctb_x = x_ctb;
+    lc->lowres_ctb_y = y_ctb;
+
+    for (int c_idx = 0; c_idx < (sps->chroma_format_idc ? 3 : 1); c_idx++) {
+        const int hshift     = sps->hshift[c_idx];
+        const int vshift     = sps->vshift[c_idx];
+        const int ctb_w      = (1 << sps->log2_ctb_size) >> hshift;
+        const int ctb_h      = (1 << sps->log2_ctb_size) >> vshift;
+        const int x          = x_ctb >> hshift;
+        const int y          = y_ctb >> vshift;
+        const int width      = (sps->width  >> hshift) - x;
+        const int height     = FFMIN((sps->height >> vshift) - y, ctb_h);
+        const ptrdiff_t linesize = frame->linesize[c_idx];
+        const uint8_t *src   = frame->data[c_idx];
+        ptrdiff_t stride;
+        uint8_t *dst = ff_hevc_recon_ptr(lc, sps, c_idx, x, y, &stride);
+
+        if (y) {
+            const uint8_t *top = src + ((y - 1) >> lowres) * linesize;
+            const int mid      = FFMIN(ctb_w, width);
+            const int end      = FFMIN(2 * ctb_w, width);
+
+            if (lc->ctb_up_left_flag)
+                pixel_set(dst - stride, pixel_shift, -1,
+                          pixel_get(top, pixel_shift, (x - 1) >> lowres));
+            for (int i = 0; lc->ctb_up_flag && i < mid; i++)
+                pixel_set(dst - stride, pixel_shift, i,
+                          pixel_get(top, pixel_shift, (x + i) >> lowres));
+            for (int i = mid; lc->ctb_up_right_flag && i < end; i++)
+                pixel_set(dst - stride, pixel_shift, i,
+                          pixel_get(top, pixel_shift, (x + i) >> lowres));
+        }
+        if (lc->ctb_left_flag)
+            for (int j = 0; j < height; j++)
+                pixel_set(dst + j * stride, pixel_shift, -1,
+                          pixel_get(src + ((y + j) >> lowres) * linesize,
+                                    pixel_shift, (x - 1) >> lowres));
+    }
+
+    return 0;
+}
+
+/**
+ * Box filter the full size reconstruction of a CTB into the reduced size
+ * frame.
+ */
+static void lowres_ctb_end(HEVCLocalContext *lc, const HEVCSPS *sps,
+                           int x_ctb, int y_ctb)
+{
+    const HEVCContext *const s = lc->parent;
+    const AVFrame *frame  = s->cur_frame->f;
+    const int lowres      = s->avctx->lowres;
+    const int pixel_shift = sps->pixel_shift;
+
+    for (int c_idx = 0; c_idx < (sps->chroma_format_idc ? 3 : 1); c_idx++) {
+        const int hshift = sps->hshift[c_idx];
+        const int vshift = sps->vshift[c_idx];
+        const int x      = x_ctb >> hshift;
+        const int y      = y_ctb >> vshift;
+        const int width  = FFMIN((1 << sps->log2_ctb_size) >> hshift,
+                                 (sps->width  >> hshift) - x) >> lowres;
+        const int height = FFMIN((1 << sps->log2_ctb_size) >> vshift,
+                                 (sps->height >> vshift) - y) >> lowres;
+        const ptrdiff_t linesize = frame->linesize[c_idx];
+        uint8_t *dst = frame->data[c_idx] + (y >> lowres) * linesize +
+                       ((x >> lowres) << pixel_shift);
+        ptrdiff_t stride;
+        const uint8_t *recon = ff_hevc_recon_ptr(lc, sps, c_idx, x, y, &stride);
+
+        for (int j = 0; j < height; j++) {
+            for (int i = 0; i < width; i++) {
+                const uint8_t *src = recon + (j << lowres) * stride;
+                int sum = 0;
+
+                for (int k = 0; k < 1 << lowres; k++, src += stride)
+                    for (int l = 0; l < 1 << lowres; l++)
+                        sum += pixel_get(src, pixel_shift, (i << lowres) + l);
+                pixel_set(dst + j * linesize, pixel_shift, i,
+                          (sum + (1 << (2 * lowres - 1))) >> (2 * lowres));
+            }
+        }
+    }
+}
+
 static int hls_decode_entry(HEVCContext *s, GetBitContext *gb)
 {
     HEVCLocalContext *const lc = &s->local_ctx[0];
@@ -2779,12 +3057,22 @@ static int hls_decode_entry(HEVCContext *s, GetBitContext *gb)
         l->deblock[ctb_addr_rs].tc_offset   = s->sh.tc_offset;
         l->filter_slice_edges[ctb_addr_rs]  = s->sh.slice_loop_filter_across_slices_enabled_flag;
 
+        if (s->avctx->lowres) {
+            ret = lowres_ctb_start(lc, sps, x_ctb, y_ctb);
+            if (ret < 0) {
+                l->tab_slice_address[ctb_addr_rs] = -1;
+                return ret;
+            }
+        }
+
         more_data = hls_coding_quadtree(lc, l, pps, sps, x_ctb, y_ctb, sps->log2_ctb_size, 0);
         if (more_data < 0) {
             l->tab_slice_address[ctb_addr_rs] = -1;
             return more_data;
         }
 
+        if (s->avctx->lowres)
+            lowres_ctb_end(lc, sps, x_ctb, y_ctb);
 
         ctb_addr_ts++;
         ff_hevc_save_states(lc, pps, ctb_addr_ts);
@@ -2850,6 +3138,12 @@ static int hls_decode_entry_wpp(AVCodecContext *avctx, void *hevc_lclist,
         l->deblock[ctb_addr_rs].tc_offset   = s->sh.tc_offset;
         l->filter_slice_edges[ctb_addr_rs]  = s->sh.slice_loop_filter_across_slices_enabled_flag;
 
+        if (s->avctx->lowres) {
+            ret = lowres_ctb_start(lc, sps, x_ctb, y_ctb);
+            if (ret < 0)
+                goto error;
+        }
+
         more_data = hls_coding_quadtree(lc, l, pps, sps, x_ctb, y_ctb, sps->log2_ctb_size, 0);
 
         if (more_data < 0) {
@@ -2857,6 +3151,9 @@ static int hls_decode_entry_wpp(AVCodecContext *avctx, void *hevc_lclist,
             goto error;
         }
 
+        if (s->avctx->lowres)
+            lowres_ctb_end(lc, sps, x_ctb, y_ctb);
+
         ctb_addr_ts++;
 
         ff_hevc_save_states(lc, pps, ctb_addr_ts);
@@ -3377,7 +3674,9 @@ static int hevc_frame_start(HEVCContext *s, HEVCLayerContext *l,
 
     s->cur_frame->f->pict_type = 3 - s->sh.slice_type;
 
+    /* in keyframes-only mode every frame is output as soon as it is decoded */
     ret = ff_hevc_output_frames(s, s->layers_active_decode, s->layers_active_output,
+                                (s->avctx->flags2 & AV_CODEC_FLAG2_KEYFRAMES_ONLY) ? 0 :
                                 sps->temporal_layer[sps->max_sub_layers - 1].num_reorder_pics,
                                 sps->temporal_layer[sps->max_sub_layers - 1].max_dec_pic_buffering, 0);
     if (ret < 0)
@@ -3514,7 +3813,7 @@ static int hevc_frame_end(HEVCContext *s, HEVCLayerContext *l)
         }
     } else {
         if (s->avctx->err_recognition & AV_EF_CRCCHECK &&
-            s->sei.picture_hash.is_md5) {
+            s->sei.picture_hash.is_md5 && !s->avctx->lowres) {
             ret = verify_md5(s, out->f);
             if (ret < 0 && s->avctx->err_recognition & AV_EF_EXPLODE)
                 return ret;
@@ -3954,6 +4253,8 @@ static av_cold int hevc_decode_free(AVCodecContext *avctx)
     av_freep(&s->sh.offset);
     av_freep(&s->sh.size);
 
+    for (unsigned i = 0; i < s->nb_local_ctx; i++)
+        av_freep(&s->local_ctx[i].lowres_scratch);
     av_freep(&s->local_ctx);
 
     ff_h2645_packet_uninit(&s->pkt);
@@ -4193,6 +4494,7 @@ const FFCodec ff_hevc_decoder = {
     UPDATE_THREAD_CONTEXT(hevc_update_thread_context),
     .p.capabilities        = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
                              AV_CODEC_CAP_SLICE_THREADS | AV_CODEC_CAP_FRAME_THREADS,
+    .p.max_lowres          = 2,
     .caps_internal         = FF_CODEC_CAP_EXPORTS_CROPPING |
                              FF_CODEC_CAP_USES_PROGRESSFRAMES |
                              FF_CODEC_CAP_INIT_CLEANUP,
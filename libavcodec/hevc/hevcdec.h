@@ -34,6 +34,7 @@
 #include "libavcodec/dovi_rpu.h"
 #include "libavcodec/get_bits.h"
 #include "libavcodec/h2645_parse.h"
+#include "libavcodec/h264chroma.h"
 #include "libavcodec/h274.h"
 #include "libavcodec/progressframe.h"
 #include "libavcodec/videodsp.h"
@@ -67,6 +68,20 @@
 
 #define EDGE_EMU_BUFFER_STRIDE 80
 
+/**
+ * Layout of HEVCLocalContext.lowres_scratch: three full size CTB planes
+ * with one row above and room for the left and top right neighbours,
+ * followed by two reduced size motion compensation planes. Strides are in
+ * bytes and large enough for high bit depth.
+ */
+#define HEVC_LOWRES_STRIDE         (160 * 2)
+#define HEVC_LOWRES_PLANE          (65 * HEVC_LOWRES_STRIDE)
+#define HEVC_LOWRES_ORIGIN_X       32
+#define HEVC_LOWRES_MC_STRIDE      (64 * 2)
+#define HEVC_LOWRES_MC_PLANE       (34 * HEVC_LOWRES_MC_STRIDE)
+#define HEVC_LOWRES_SCRATCH_SIZE   (3 * HEVC_LOWRES_PLANE + \
+                                    2 * HEVC_LOWRES_MC_PLANE)
+
 /**
  * Value of the luma sample at position (x, y) in the 2D array tab.
  */
@@ -446,6 +461,15 @@ typedef struct HEVCLocalContext {
      * of the deblocking filter */
     int boundary_flags;
 
+    /**
+     * lowres decoding: full size reconstruction of the current CTB and
+     * reduced size motion compensation buffers, see lowres_ctb_start()
+     */
+    uint8_t     *lowres_scratch;
+    unsigned int lowres_scratch_size;
+    int          lowres_ctb_x;
+    int          lowres_ctb_y;
+
     // an array of these structs is used for per-thread state - pad its size
     // to avoid false sharing
     char padding[128];
@@ -536,6 +560,7 @@ typedef struct HEVCContext {
     HEVCPredContext hpc;
     HEVCDSPContext hevcdsp;
     VideoDSPContext vdsp;
+    H264ChromaContext h264chroma;
     BswapDSPContext bdsp;
     H274FilmGrainDatabase h274db;
 
@@ -586,6 +611,30 @@ typedef struct HEVCContext {
     DOVIContext dovi_ctx;       ///< Dolby Vision decoding context
 } HEVCContext;
 
+/**
+ * Get the address of the reconstructed sample (x, y) of component c_idx,
+ * in units of that component. With lowres, the current CTB is
+ * reconstructed at full size in the scratch buffer of the local context.
+ */
+static av_always_inline uint8_t *ff_hevc_recon_ptr(const HEVCLocalContext *lc,
+                                                   const HEVCSPS *sps, int c_idx,
+                                                   int x, int y, ptrdiff_t *linesize)
+{
+    const HEVCContext *s = lc->parent;
+
+    if (s->avctx->lowres) {
+        x -= lc->lowres_ctb_x >> sps->hshift[c_idx];
+        y -= lc->lowres_ctb_y >> sps->vshift[c_idx];
+        *linesize = HEVC_LOWRES_STRIDE;
+        return lc->lowres_scratch + c_idx * HEVC_LOWRES_PLANE +
+               (y + 1) * HEVC_LOWRES_STRIDE +
+               ((x + HEVC_LOWRES_ORIGIN_X) << sps->pixel_shift);
+    }
+
+    *linesize = s->cur_frame->f->linesize[c_idx];
+    return s->cur_frame->f->data[c_idx] + y * *linesize + (x << sps->pixel_shift);
+}
+
 /**
  * Mark all frames in DPB as unused for reference.
  */
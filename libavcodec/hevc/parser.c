@@ -21,6 +21,7 @@
  */
 
 #include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
 #include "libavutil/mem.h"
 
 #include "golomb.h"
@@ -30,6 +31,7 @@
 #include "sei.h"
 #include "h2645_parse.h"
 #include "parser.h"
+#include "startcode.h"
 
 #define START_CODE 0x000001 ///< start_code_prefix_one_3bytes
 
@@ -49,6 +51,8 @@ typedef struct HEVCParserContext {
 
     int poc;
     int pocTid0;
+
+    ff_startcode_find_candidate_fn find_candidate;
 } HEVCParserContext;
 
 static int hevc_parse_slice_header(AVCodecParserContext *s, H2645NAL *nal,
@@ -264,6 +268,19 @@ static int hevc_find_frame_end(AVCodecParserContext *s, const uint8_t *buf,
     for (i = 0; i < buf_size; i++) {
         int nut, layer_id;
 
+        // A start code can only be completed in the next 5 bytes if one of
+        // the last 5 bytes is zero, otherwise skip to the next zero byte.
+        if (i >= 8 && !((pc->state64 - 0x0101010101ULL) & ~pc->state64 &
+                        0x8080808080ULL)) {
+            int skip = ctx->find_candidate(buf + i, buf_size - i);
+            if (skip) {
+                i = FFMIN(i + skip, buf_size);
+                pc->state64 = AV_RB64(buf + i - 8);
+                if (i == buf_size)
+                    break;
+            }
+        }
+
         pc->state64 = (pc->state64 << 8) | buf[i];
 
         if (((pc->state64 >> 3 * 8) & 0xFFFFFF) != START_CODE)
@@ -341,6 +358,15 @@ static int hevc_parse(AVCodecParserContext *s, AVCodecContext *avctx,
     return next;
 }
 
+static av_cold int hevc_parser_init(AVCodecParserContext *s)
+{
+    HEVCParserContext *ctx = s->priv_data;
+
+    ctx->find_candidate = ff_startcode_find_candidate_get();
+
+    return 0;
+}
+
 static void hevc_parser_close(AVCodecParserContext *s)
 {
     HEVCParserContext *ctx = s->priv_data;
@@ -355,6 +381,7 @@ static void hevc_parser_close(AVCodecParserContext *s)
 const AVCodecParser ff_hevc_parser = {
     .codec_ids      = { AV_CODEC_ID_HEVC },
     .priv_data_size = sizeof(HEVCParserContext),
+    .parser_init    = hevc_parser_init,
     .parser_parse   = hevc_parse,
     .parser_close   = hevc_parser_close,
 };
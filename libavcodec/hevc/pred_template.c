@@ -90,8 +90,9 @@ do {                                  \
 
     int cur_tb_addr = MIN_TB_ADDR_ZS(x_tb, y_tb);
 
-    ptrdiff_t stride = s->cur_frame->f->linesize[c_idx] / sizeof(pixel);
-    pixel *src = (pixel*)s->cur_frame->f->data[c_idx] + x + y * stride;
+    ptrdiff_t linesize;
+    pixel *src = (pixel*)ff_hevc_recon_ptr(lc, sps, c_idx, x, y, &linesize);
+    ptrdiff_t stride = linesize / sizeof(pixel);
 
     int min_pu_width = sps->min_pu_width;
 
@@ -243,10 +243,21 @@ int ff_hevc_set_new_ref(HEVCContext *s, HEVCLayerContext *l, int poc)
         ref->flags = HEVC_FRAME_FLAG_SHORT_REF;
 
     ref->poc      = poc;
-    ref->f->crop_left   = l->sps->output_window.left_offset;
-    ref->f->crop_right  = l->sps->output_window.right_offset;
-    ref->f->crop_top    = l->sps->output_window.top_offset;
-    ref->f->crop_bottom = l->sps->output_window.bottom_offset;
+    if (s->avctx->lowres) {
+        const HEVCWindow *ow = &l->sps->output_window;
+        const int lowres     = s->avctx->lowres;
+
+        /* frames are allocated and cropped at the reduced size */
+        ref->f->crop_left   = ow->left_offset >> lowres;
+        ref->f->crop_top    = ow->top_offset  >> lowres;
+        ref->f->crop_right  = ref->f->width  - ref->f->crop_left - s->avctx->width;
+        ref->f->crop_bottom = ref->f->height - ref->f->crop_top  - s->avctx->height;
+    } else {
+        ref->f->crop_left   = l->sps->output_window.left_offset;
+        ref->f->crop_right  = l->sps->output_window.right_offset;
+        ref->f->crop_top    = l->sps->output_window.top_offset;
+        ref->f->crop_bottom = l->sps->output_window.bottom_offset;
+    }
 
     return 0;
 }
@@ -469,16 +480,18 @@ static HEVCFrame *generate_missing_ref(HEVCContext *s, HEVCLayerContext *l, int
         return NULL;
 
     if (!s->avctx->hwaccel) {
+        const int lowres = s->avctx->lowres;
+
         if (!l->sps->pixel_shift) {
             for (i = 0; frame->f->data[i]; i++)
                 memset(frame->f->data[i], 1 << (l->sps->bit_depth - 1),
-                       frame->f->linesize[i] * AV_CEIL_RSHIFT(l->sps->height, l->sps->vshift[i]));
+                       frame->f->linesize[i] * AV_CEIL_RSHIFT(l->sps->height, l->sps->vshift[i] + lowres));
         } else {
             for (i = 0; frame->f->data[i]; i++)
-                for (y = 0; y < (l->sps->height >> l->sps->vshift[i]); y++) {
+                for (y = 0; y < (l->sps->height >> (l->sps->vshift[i] + lowres)); y++) {
                     uint8_t *dst = frame->f->data[i] + y * frame->f->linesize[i];
                     AV_WN16(dst, 1 << (l->sps->bit_depth - 1));
-                    av_memcpy_backptr(dst + 2, 2, 2*(l->sps->width >> l->sps->hshift[i]) - 2);
+                    av_memcpy_backptr(dst + 2, 2, 2*(l->sps->width >> (l->sps->hshift[i] + lowres)) - 2);
                 }
         }
     }
@@ -109,6 +109,19 @@ typedef struct {
    double *layer_rates;
 } Jpeg2000Tile;
 
+/**
+ * One code-block of a tile, coded independently by the tier-1 coder.
+ */
+typedef struct Jpeg2000CblkJob {
+    Jpeg2000Tile *tile;
+    Jpeg2000Component *comp;
+    Jpeg2000Band *band;
+    Jpeg2000Cblk *cblk;
+    int xx0, yy0, xx1, yy1; ///< code-block coordinates in the transformed component
+    int bandpos;
+    int lev;
+} Jpeg2000CblkJob;
+
 typedef struct {
     AVClass *class;
     AVCodecContext *avctx;
@@ -135,6 +148,10 @@ typedef struct {
 
     Jpeg2000Tile *tile;
     int layer_rates[100];
+
+    Jpeg2000T1Context *t1;      ///< tier-1 coder state, one per slice thread
+    Jpeg2000CblkJob *cblk_jobs;
+    unsigned int cblk_jobs_size;
     uint8_t compression_rate_enc; ///< Is compression done using compression ratio?
 
     int format;
@@ -1402,20 +1419,76 @@ static void truncpasses(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile)
     }
 }
 
+static int dwt_encode_thread(AVCodecContext *avctx, void *arg, int compno, int threadnr)
+{
+    Jpeg2000Component *comp = (Jpeg2000Component *)arg + compno;
+
+    return ff_dwt_encode(&comp->dwt, comp->i_data);
+}
+
+static int encode_cblk_thread(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    Jpeg2000EncoderContext *s = avctx->priv_data;
+    const Jpeg2000CblkJob *job = s->cblk_jobs + jobnr;
+    const Jpeg2000Component *comp = job->comp;
+    Jpeg2000T1Context *t1 = s->t1 + threadnr;
+    int w = comp->coord[0][1] - comp->coord[0][0];
+    int y, x;
+
+    t1->stride = (1<<s->codsty.log2_cblk_width) + 2;
+
+    if (s->codsty.transform == FF_DWT53){
+        for (y = job->yy0; y < job->yy1; y++){
+            int *ptr = t1->data + (y-job->yy0)*t1->stride;
+            for (x = job->xx0; x < job->xx1; x++){
+                *ptr++ = comp->i_data[w * y + x] * (1 << NMSEDEC_FRACBITS);
+            }
+        }
+    } else{
+        int64_t scale = 16384 * 65536 / job->band->i_stepsize;
+        for (y = job->yy0; y < job->yy1; y++){
+            int *ptr = t1->data + (y-job->yy0)*t1->stride;
+            for (x = job->xx0; x < job->xx1; x++){
+                *ptr++ = comp->i_data[w * y + x] * scale >> 15 - NMSEDEC_FRACBITS;
+            }
+        }
+    }
+    encode_cblk(s, t1, job->cblk, job->tile, job->xx1 - job->xx0, job->yy1 - job->yy0,
+                job->bandpos, job->lev);
+    return 0;
+}
+
 static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno)
 {
     int compno, reslevelno, bandno, ret;
-    Jpeg2000T1Context t1;
+    int nb_jobs = 0;
+    Jpeg2000CblkJob *job;
     Jpeg2000CodingStyle *codsty = &s->codsty;
-    for (compno = 0; compno < s->ncomponents; compno++){
-        Jpeg2000Component *comp = s->tile[tileno].comp + compno;
+    AVCodecContext *avctx = s->avctx;
 
-        t1.stride = (1<<codsty->log2_cblk_width) + 2;
+    av_log(s->avctx, AV_LOG_DEBUG,"dwt\n");
+    ret = avctx->execute2(avctx, dwt_encode_thread, tile->comp, NULL, s->ncomponents);
+    if (ret < 0)
+        return ret;
+    av_log(s->avctx, AV_LOG_DEBUG,"after dwt -> tier1\n");
 
-        av_log(s->avctx, AV_LOG_DEBUG,"dwt\n");
-        if ((ret = ff_dwt_encode(&comp->dwt, comp->i_data)) < 0)
-            return ret;
-        av_log(s->avctx, AV_LOG_DEBUG,"after dwt -> tier1\n");
+    for (compno = 0; compno < s->ncomponents; compno++){
+        Jpeg2000Component *comp = tile->comp + compno;
+        for (reslevelno = 0; reslevelno < codsty->nreslevels; reslevelno++){
+            Jpeg2000ResLevel *reslevel = comp->reslevel + reslevelno;
+            for (bandno = 0; bandno < reslevel->nbands; bandno++){
+                Jpeg2000Prec *prec = reslevel->band[bandno].prec;
+                nb_jobs += prec->nb_codeblocks_width * prec->nb_codeblocks_height;
+            }
+        }
+    }
+    av_fast_malloc(&s->cblk_jobs, &s->cblk_jobs_size, nb_jobs * sizeof(*s->cblk_jobs));
+    if (!s->cblk_jobs)
+        return AVERROR(ENOMEM);
+    job = s->cblk_jobs;
+
+    for (compno = 0; compno < s->ncomponents; compno++){
+        Jpeg2000Component *comp = tile->comp + compno;
 
         for (reslevelno = 0; reslevelno < codsty->nreslevels; reslevelno++){
             Jpeg2000ResLevel *reslevel = comp->reslevel + reslevelno;
@@ -1444,32 +1517,25 @@ static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno
                                 band->coord[0][1]) - band->coord[0][0] + xx0;
 
                     for (cblkx = 0; cblkx < prec->nb_codeblocks_width; cblkx++, cblkno++){
-                        int y, x;
-                        if (codsty->transform == FF_DWT53){
-                            for (y = yy0; y < yy1; y++){
-                                int *ptr = t1.data + (y-yy0)*t1.stride;
-                                for (x = xx0; x < xx1; x++){
-                                    *ptr++ = comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x] * (1 << NMSEDEC_FRACBITS);
-                                }
-                            }
-                        } else{
-                            for (y = yy0; y < yy1; y++){
-                                int *ptr = t1.data + (y-yy0)*t1.stride;
-                                for (x = xx0; x < xx1; x++){
-                                    *ptr = (comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x]);
-                                    *ptr = (int64_t)*ptr * (int64_t)(16384 * 65536 / band->i_stepsize) >> 15 - NMSEDEC_FRACBITS;
-                                    ptr++;
-                                }
-                            }
-                        }
-                        if (!prec->cblk[cblkno].data)
-                            prec->cblk[cblkno].data = av_malloc(1 + 8192);
-                        if (!prec->cblk[cblkno].passes)
-                            prec->cblk[cblkno].passes = av_malloc_array(JPEG2000_MAX_PASSES, sizeof (*prec->cblk[cblkno].passes));
-                        if (!prec->cblk[cblkno].data || !prec->cblk[cblkno].passes)
+                        Jpeg2000Cblk *cblk = prec->cblk + cblkno;
+                        if (!cblk->data)
+                            cblk->data = av_malloc(1 + 8192);
+                        if (!cblk->passes)
+                            cblk->passes = av_malloc_array(JPEG2000_MAX_PASSES, sizeof (*cblk->passes));
+                        if (!cblk->data || !cblk->passes)
                             return AVERROR(ENOMEM);
-                        encode_cblk(s, &t1, prec->cblk + cblkno, tile, xx1 - xx0, yy1 - yy0,
-                                    bandpos, codsty->nreslevels - reslevelno - 1);
+                        *job++ = (Jpeg2000CblkJob) {
+                            .tile    = tile,
+                            .comp    = comp,
+                            .band    = band,
+                            .cblk    = cblk,
+                            .xx0     = xx0,
+                            .yy0     = yy0,
+                            .xx1     = xx1,
+                            .yy1     = yy1,
+                            .bandpos = bandpos,
+                            .lev     = codsty->nreslevels - reslevelno - 1,
+                        };
                         xx0 = xx1;
                         xx1 = FFMIN(xx1 + (1 << band->log2_cblk_width), band->coord[0][1] - band->coord[0][0] + x0);
                     }
@@ -1478,9 +1544,11 @@ static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno
                 }
             }
         }
-        av_log(s->avctx, AV_LOG_DEBUG, "after tier1\n");
     }
 
+    avctx->execute2(avctx, encode_cblk_thread, NULL, NULL, job - s->cblk_jobs);
+    av_log(s->avctx, AV_LOG_DEBUG, "after tier1\n");
+
     av_log(s->avctx, AV_LOG_DEBUG, "rate control\n");
     if (s->compression_rate_enc)
         makelayers(s, tile);
@@ -1785,6 +1853,10 @@ static av_cold int j2kenc_init(AVCodecContext *avctx)
 
     ff_thread_once(&init_static_once, init_luts);
 
+    s->t1 = av_calloc(FFMAX(avctx->thread_count, 1), sizeof(*s->t1));
+    if (!s->t1)
+        return AVERROR(ENOMEM);
+
     init_quantization(s);
     if ((ret=init_tiles(s)) < 0)
         return ret;
@@ -1799,6 +1871,8 @@ static int j2kenc_destroy(AVCodecContext *avctx)
     Jpeg2000EncoderContext *s = avctx->priv_data;
 
     cleanup(s);
+    av_freep(&s->t1);
+    av_freep(&s->cblk_jobs);
     return 0;
 }
 
@@ -1840,7 +1914,7 @@ const FFCodec ff_jpeg2000_encoder = {
     .p.type         = AVMEDIA_TYPE_VIDEO,
     .p.id           = AV_CODEC_ID_JPEG2000,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE |
-                      AV_CODEC_CAP_FRAME_THREADS,
+                      AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS,
     .priv_data_size = sizeof(Jpeg2000EncoderContext),
     .init           = j2kenc_init,
     FF_CODEC_ENCODE_CB(encode_frame),
@@ -2170,7 +2170,6 @@ static void dequantization_int_97(int x, int y, Jpeg2000Cblk *cblk,
     fscale *= (float)(1 << PRESCALE);
     fscale *= (float)(1 << (16 + I_PRESHIFT));
     scale = (int)(fscale + 0.5);
-    band->i_stepsize = scale;
     for (j = 0; j < (cblk->coord[1][1] - cblk->coord[1][0]); ++j) {
         int32_t *datap = &comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * (y + j) + x];
         int *src = t1->data + j*t1->stride;
@@ -2180,7 +2179,7 @@ static void dequantization_int_97(int x, int y, Jpeg2000Cblk *cblk,
                 val = -(val & INT32_MAX);
             // Shifting down to prevent overflow in dequantization
             val = (val + (1 << (PRESCALE - 1))) >> PRESCALE;
-            datap[i] = RSHIFT(val * (int64_t)band->i_stepsize, 16);
+            datap[i] = RSHIFT(val * (int64_t)scale, 16);
         }
     }
 }
@@ -2214,10 +2213,50 @@ static inline void mct_decode(const Jpeg2000DecoderContext *s, Jpeg2000Tile *til
 }
 
 
-static inline int tile_codeblocks(const Jpeg2000DecoderContext *s, Jpeg2000Tile *tile)
+static int decode_cblk_thread(AVCodecContext *avctx, void *arg,
+                              int jobnr, int threadnr)
 {
-    Jpeg2000T1Context t1;
+    const Jpeg2000DecoderContext *s = avctx->priv_data;
+    Jpeg2000CblkJob *job = s->cblk_jobs + jobnr;
+    Jpeg2000T1Context *t1 = s->t1 + threadnr;
+    Jpeg2000CodingStyle *codsty = job->codsty;
+    Jpeg2000Component *comp = job->comp;
+    Jpeg2000Band *band = job->band;
+    Jpeg2000Cblk *cblk = job->cblk;
+    int x, y, ret;
+
+    t1->stride = (1<<codsty->log2_cblk_width) + 2;
+
+    if (cblk->modes & JPEG2000_CTSY_HTJ2K_F)
+        ret = ff_jpeg2000_decode_htj2k(s, codsty, t1, cblk,
+                                       cblk->coord[0][1] - cblk->coord[0][0],
+                                       cblk->coord[1][1] - cblk->coord[1][0],
+                                       job->M_b, comp->roi_shift);
+    else
+        ret = decode_cblk(s, codsty, t1, cblk,
+                          cblk->coord[0][1] - cblk->coord[0][0],
+                          cblk->coord[1][1] - cblk->coord[1][0],
+                          job->bandpos, comp->roi_shift, job->M_b);
+
+    job->coded = !!ret;
+    if (!ret)
+        return 0;
+    x = cblk->coord[0][0] - band->coord[0][0];
+    y = cblk->coord[1][0] - band->coord[1][0];
 
+    if (codsty->transform == FF_DWT97)
+        dequantization_float(x, y, cblk, comp, t1, band, job->M_b);
+    else if (codsty->transform == FF_DWT97_INT)
+        dequantization_int_97(x, y, cblk, comp, t1, band, job->M_b);
+    else
+        dequantization_int(x, y, cblk, comp, t1, band, job->M_b);
+    return 0;
+}
+
+/* Queue the code-blocks of all components of a tile for decoding. */
+static int tile_codeblocks(Jpeg2000DecoderContext *s, Jpeg2000Tile *tile,
+                           int *nb_jobs)
+{
     int compno, reslevelno, bandno;
 
     /* Loop on tile components */
@@ -2226,11 +2265,8 @@ static inline int tile_codeblocks(const Jpeg2000DecoderContext *s, Jpeg2000Tile
         Jpeg2000CodingStyle *codsty  = tile->codsty + compno;
         Jpeg2000QuantStyle *quantsty = tile->qntsty + compno;
 
-        int coded = 0;
         int subbandno = 0;
 
-        t1.stride = (1<<codsty->log2_cblk_width) + 2;
-
         /* Loop on resolution levels */
         for (reslevelno = 0; reslevelno < codsty->nreslevels2decode; reslevelno++) {
             Jpeg2000ResLevel *rlevel = comp->reslevel + reslevelno;
@@ -2257,49 +2293,74 @@ static inline int tile_codeblocks(const Jpeg2000DecoderContext *s, Jpeg2000Tile
                 /* Loop on precincts */
                 for (precno = 0; precno < nb_precincts; precno++) {
                     Jpeg2000Prec *prec = band->prec + precno;
+                    int nb_cblks = prec->nb_codeblocks_width * prec->nb_codeblocks_height;
+                    Jpeg2000CblkJob *jobs;
+
+                    if (*nb_jobs > INT_MAX / sizeof(*jobs) - nb_cblks)
+                        return AVERROR(ENOMEM);
+                    jobs = av_fast_realloc(s->cblk_jobs, &s->cblk_jobs_size,
+                                           (*nb_jobs + nb_cblks) * sizeof(*jobs));
+                    if (!jobs)
+                        return AVERROR(ENOMEM);
+                    s->cblk_jobs = jobs;
 
                     /* Loop on codeblocks */
-                    for (cblkno = 0;
-                         cblkno < prec->nb_codeblocks_width * prec->nb_codeblocks_height;
-                         cblkno++) {
-                        int x, y, ret;
-
-                        Jpeg2000Cblk *cblk = prec->cblk + cblkno;
-
-                        if (cblk->modes & JPEG2000_CTSY_HTJ2K_F)
-                            ret = ff_jpeg2000_decode_htj2k(s, codsty, &t1, cblk,
-                                                           cblk->coord[0][1] - cblk->coord[0][0],
-                                                           cblk->coord[1][1] - cblk->coord[1][0],
-                                                           M_b, comp->roi_shift);
-                        else
-                            ret = decode_cblk(s, codsty, &t1, cblk,
-                                              cblk->coord[0][1] - cblk->coord[0][0],
-                                              cblk->coord[1][1] - cblk->coord[1][0],
-                                              bandpos, comp->roi_shift, M_b);
-
-                        if (ret)
-                            coded = 1;
-                        else
-                            continue;
-                        x = cblk->coord[0][0] - band->coord[0][0];
-                        y = cblk->coord[1][0] - band->coord[1][0];
-
-                        if (codsty->transform == FF_DWT97)
-                            dequantization_float(x, y, cblk, comp, &t1, band, M_b);
-                        else if (codsty->transform == FF_DWT97_INT)
-                            dequantization_int_97(x, y, cblk, comp, &t1, band, M_b);
-                        else
-                            dequantization_int(x, y, cblk, comp, &t1, band, M_b);
-                   } /* end cblk */
+                    for (cblkno = 0; cblkno < nb_cblks; cblkno++) {
+                        jobs[(*nb_jobs)++] = (Jpeg2000CblkJob) {
+                            .tile    = tile,
+                            .comp    = comp,
+                            .codsty  = codsty,
+                            .band    = band,
+                            .cblk    = prec->cblk + cblkno,
+                            .compno  = compno,
+                            .bandpos = bandpos,
+                            .M_b     = M_b,
+                        };
+                    } /* end cblk */
                 } /*end prec */
             } /* end band */
         } /* end reslevel */
+    } /*end comp */
+    return 0;
+}
+
+static int jpeg2000_decode_codeblocks(Jpeg2000DecoderContext *s)
+{
+    int tileno, nb_jobs = 0;
 
-        /* inverse DWT */
-        if (coded)
-            ff_dwt_decode(&comp->dwt, codsty->transform == FF_DWT97 ? (void*)comp->f_data : (void*)comp->i_data);
+    for (tileno = 0; tileno < s->numXtiles * s->numYtiles; tileno++) {
+        Jpeg2000Tile *tile = s->tile + tileno;
+        int nb_tile_jobs = nb_jobs;
 
-    } /*end comp */
+        memset(tile->coded, 0, sizeof(tile->coded));
+        tile->error = tile_codeblocks(s, tile, &nb_tile_jobs);
+        if (tile->error == AVERROR(ENOMEM))
+            return tile->error;
+        /* a tile that failed is not decoded at all */
+        if (!tile->error)
+            nb_jobs = nb_tile_jobs;
+    }
+
+    s->avctx->execute2(s->avctx, decode_cblk_thread, NULL, NULL, nb_jobs);
+
+    for (int i = 0; i < nb_jobs; i++)
+        s->cblk_jobs[i].tile->coded[s->cblk_jobs[i].compno] |= s->cblk_jobs[i].coded;
+
+    return 0;
+}
+
+static int jpeg2000_dwt_thread(AVCodecContext *avctx, void *arg,
+                               int jobnr, int threadnr)
+{
+    const Jpeg2000DecoderContext *s = avctx->priv_data;
+    Jpeg2000Tile *tile = s->tile + jobnr / s->ncomponents;
+    int compno = jobnr % s->ncomponents;
+    Jpeg2000Component *comp = tile->comp + compno;
+
+    /* inverse DWT */
+    if (!tile->error && tile->coded[compno])
+        return ff_dwt_decode(&comp->dwt, tile->codsty[compno].transform == FF_DWT97 ?
+                                         (void*)comp->f_data : (void*)comp->i_data);
     return 0;
 }
 
@@ -2377,9 +2438,8 @@ static int jpeg2000_decode_tile(AVCodecContext *avctx, void *td,
     AVFrame *picture = td;
     Jpeg2000Tile *tile = s->tile + jobnr;
 
-    int ret = tile_codeblocks(s, tile);
-    if (ret < 0)
-        return ret;
+    if (tile->error)
+        return tile->error;
 
     /* inverse MCT transformation */
     if (tile->codsty[0].mct)
@@ -2824,6 +2884,22 @@ static av_cold int jpeg2000_decode_init(AVCodecContext *avctx)
     ff_jpeg2000dsp_init(&s->dsp);
     ff_jpeg2000_init_tier1_luts();
 
+    s->t1 = av_calloc(avctx->active_thread_type & FF_THREAD_SLICE ? avctx->thread_count : 1,
+                      sizeof(*s->t1));
+    if (!s->t1)
+        return AVERROR(ENOMEM);
+
+    return 0;
+}
+
+static av_cold int jpeg2000_decode_close(AVCodecContext *avctx)
+{
+    Jpeg2000DecoderContext *s = avctx->priv_data;
+
+    av_freep(&s->t1);
+    av_freep(&s->cblk_jobs);
+    s->cblk_jobs_size = 0;
+
     return 0;
 }
 
@@ -2900,6 +2976,10 @@ static int jpeg2000_decode_frame(AVCodecContext *avctx, AVFrame *picture,
         if (++x == s->ncomponents)
             picture->flags |= AV_FRAME_FLAG_LOSSLESS;
 
+    if ((ret = jpeg2000_decode_codeblocks(s)) < 0)
+        goto end;
+    avctx->execute2(avctx, jpeg2000_dwt_thread, NULL, NULL,
+                    s->numXtiles * s->numYtiles * s->ncomponents);
     avctx->execute2(avctx, jpeg2000_decode_tile, picture, NULL, s->numXtiles * s->numYtiles);
 
     jpeg2000_dec_cleanup(s);
@@ -2940,9 +3020,11 @@ const FFCodec ff_jpeg2000_decoder = {
     .p.capabilities   = AV_CODEC_CAP_SLICE_THREADS | AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_DR1,
     .priv_data_size   = sizeof(Jpeg2000DecoderContext),
     .init             = jpeg2000_decode_init,
+    .close            = jpeg2000_decode_close,
     FF_CODEC_DECODE_CB(jpeg2000_decode_frame),
     .p.priv_class     = &jpeg2000_class,
     .p.max_lowres     = 5,
     .p.profiles       = NULL_IF_CONFIG_SMALL(ff_jpeg2000_profiles),
-    .caps_internal    = FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
+    .caps_internal    = FF_CODEC_CAP_INIT_CLEANUP |
+                        FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
 };
@@ -68,8 +68,23 @@ typedef struct Jpeg2000Tile {
     GetByteContext      packed_headers_stream;  // byte context corresponding to packed headers
     uint16_t tp_idx;                    // Tile-part index
     int coord[2][2];                    // border coordinates {{x0, x1}, {y0, y1}}
+    int                 error;                  // tier-1 decoding of the tile could not be set up
+    uint8_t             coded[4];               // whether a component has any decoded code-block
 } Jpeg2000Tile;
 
+/* One code-block, decoded and dequantized independently of the others */
+typedef struct Jpeg2000CblkJob {
+    Jpeg2000Tile        *tile;
+    Jpeg2000Component   *comp;
+    Jpeg2000CodingStyle *codsty;
+    Jpeg2000Band        *band;
+    Jpeg2000Cblk        *cblk;
+    int                 compno;
+    int                 bandpos;
+    int                 M_b;
+    int                 coded;
+} Jpeg2000CblkJob;
+
 typedef struct Jpeg2000DecoderContext {
     AVClass         *class;
     AVCodecContext  *avctx;
@@ -111,6 +126,10 @@ typedef struct Jpeg2000DecoderContext {
     Jpeg2000Tile    *tile;
     Jpeg2000DSPContext dsp;
 
+    Jpeg2000T1Context *t1;      // tier-1 decoder state, one per slice thread
+    Jpeg2000CblkJob *cblk_jobs;
+    unsigned int    cblk_jobs_size;
+
     uint8_t         isHT; // HTJ2K?
     uint8_t         Ccap15_b14_15; // HTONLY(= 0) or HTDECLARED(= 1) or MIXED(= 3) ?
     uint8_t         Ccap15_b12; // RGNFREE(= 0) or RGN(= 1)?
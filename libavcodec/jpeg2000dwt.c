@@ -25,11 +25,17 @@
  * Discrete wavelet transform
  */
 
+#include <string.h>
+
 #include "libavutil/error.h"
 #include "libavutil/macros.h"
 #include "libavutil/mem.h"
 #include "jpeg2000dwt.h"
 
+/* The vertical passes filter DWT_STRIP adjacent columns at once;
+ * row i of a strip is stored at p[i * DWT_STRIP]. */
+#define DWT_STRIP 16
+
 /* Defines for 9/7 DWT lifting parameters.
  * Parameters are in float. */
 #define F_LFTG_ALPHA  1.586134342059924f
@@ -92,11 +98,50 @@ static void sd_1d53(int *p, int i0, int i1)
         p[2*i] += (p[2*i-1] + p[2*i+1] + 2) >> 2;
 }
 
+/* Symmetric extension of a strip by len rows on each side, in the same
+ * order as extend53() / extend97_*(). */
+static void extend_strip(void *buf, int i0, int i1, int n, int len)
+{
+    int32_t *p = buf;
+    int i;
+
+    for (i = 1; i <= len; i++) {
+        memcpy(p + (i0 - i)     * DWT_STRIP, p + (i0 + i)     * DWT_STRIP, n * sizeof(*p));
+        memcpy(p + (i1 + i - 1) * DWT_STRIP, p + (i1 - i - 1) * DWT_STRIP, n * sizeof(*p));
+    }
+}
+
+static void sd_strip53(int *p, int i0, int i1, int n)
+{
+    int i, c;
+
+    if (i1 <= i0 + 1) {
+        if (i0 == 1)
+            for (c = 0; c < n; c++)
+                p[DWT_STRIP + c] *= 2;
+        return;
+    }
+
+    extend_strip(p, i0, i1, n, 2);
+
+    for (i = ((i0+1)>>1) - 1; i < (i1+1)>>1; i++) {
+        int *r = p + (2*i+1) * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] -= (r[c - DWT_STRIP] + r[c + DWT_STRIP]) >> 1;
+    }
+    for (i = ((i0+1)>>1); i < (i1+1)>>1; i++) {
+        int *r = p + 2*i * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] += (r[c - DWT_STRIP] + r[c + DWT_STRIP] + 2) >> 2;
+    }
+}
+
 static void dwt_encode53(DWTContext *s, int *t)
 {
     int lev,
         w = s->linelen[s->ndeclevels-1][0];
     int *line = s->i_linebuf;
+    int *strip = s->i_stripbuf + 3 * DWT_STRIP;
     line += 3;
 
     for (lev = s->ndeclevels-1; lev >= 0; lev--){
@@ -108,20 +153,20 @@ static void dwt_encode53(DWTContext *s, int *t)
         int *l;
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
+        l = strip + mv * DWT_STRIP;
+        for (lp = 0; lp < lh; lp += DWT_STRIP) {
+            int i, j = 0, n = FFMIN(DWT_STRIP, lh - lp);
 
             for (i = 0; i < lv; i++)
-                l[i] = t[w*i + lp];
+                memcpy(l + i * DWT_STRIP, t + w*i + lp, n * sizeof(*t));
 
-            sd_1d53(line, mv, mv + lv);
+            sd_strip53(strip, mv, mv + lv, n);
 
             // copy back and deinterleave
             for (i =   mv; i < lv; i+=2, j++)
-                t[w*j + lp] = l[i];
+                memcpy(t + w*j + lp, l + i * DWT_STRIP, n * sizeof(*t));
             for (i = 1-mv; i < lv; i+=2, j++)
-                t[w*j + lp] = l[i];
+                memcpy(t + w*j + lp, l + i * DWT_STRIP, n * sizeof(*t));
         }
 
         // HOR_SD
@@ -246,6 +291,48 @@ static void sd_1d97_int(int *p, int i0, int i1)
         p[2 * i]     += (I_LFTG_DELTA * (p[2 * i - 1] + p[2 * i + 1]) + (1 << 15)) >> 16;
 }
 
+static void sd_strip97_int(int *p, int i0, int i1, int n)
+{
+    int i, c;
+
+    if (i1 <= i0 + 1) {
+        if (i0 == 1)
+            for (c = 0; c < n; c++)
+                p[DWT_STRIP + c] = (p[DWT_STRIP + c] * I_LFTG_X + (1<<14)) >> 15;
+        else
+            for (c = 0; c < n; c++)
+                p[c] = (p[c] * I_LFTG_K + (1<<15)) >> 16;
+        return;
+    }
+
+    extend_strip(p, i0, i1, n, 4);
+    i0++; i1++;
+
+    for (i = (i0>>1) - 2; i < (i1>>1) + 1; i++) {
+        int *r = p + (2 * i + 1) * DWT_STRIP;
+        for (c = 0; c < n; c++) {
+            const int64_t sum = r[c - DWT_STRIP] + r[c + DWT_STRIP];
+            r[c] -= sum;
+            r[c] -= (I_LFTG_ALPHA_PRIME * sum + (1 << 15)) >> 16;
+        }
+    }
+    for (i = (i0>>1) - 1; i < (i1>>1) + 1; i++) {
+        int *r = p + 2 * i * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] -= (I_LFTG_BETA  * (r[c - DWT_STRIP] + r[c + DWT_STRIP]) + (1 << 15)) >> 16;
+    }
+    for (i = (i0>>1) - 1; i < (i1>>1); i++) {
+        int *r = p + (2 * i + 1) * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] += (I_LFTG_GAMMA * (r[c - DWT_STRIP] + r[c + DWT_STRIP]) + (1 << 15)) >> 16;
+    }
+    for (i = (i0>>1); i < (i1>>1); i++) {
+        int *r = p + 2 * i * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] += (I_LFTG_DELTA * (r[c - DWT_STRIP] + r[c + DWT_STRIP]) + (1 << 15)) >> 16;
+    }
+}
+
 static void dwt_encode97_int(DWTContext *s, int *t)
 {
     int lev;
@@ -253,6 +340,7 @@ static void dwt_encode97_int(DWTContext *s, int *t)
     int h = s->linelen[s->ndeclevels-1][1];
     int i;
     int *line = s->i_linebuf;
+    int *strip = s->i_stripbuf + 5 * DWT_STRIP;
     line += 5;
 
     for (i = 0; i < w * h; i++)
@@ -267,20 +355,20 @@ static void dwt_encode97_int(DWTContext *s, int *t)
         int *l;
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
+        l = strip + mv * DWT_STRIP;
+        for (lp = 0; lp < lh; lp += DWT_STRIP) {
+            int i, j = 0, n = FFMIN(DWT_STRIP, lh - lp);
 
             for (i = 0; i < lv; i++)
-                l[i] = t[w*i + lp];
+                memcpy(l + i * DWT_STRIP, t + w*i + lp, n * sizeof(*t));
 
-            sd_1d97_int(line, mv, mv + lv);
+            sd_strip97_int(strip, mv, mv + lv, n);
 
             // copy back and deinterleave
             for (i =   mv; i < lv; i+=2, j++)
-                t[w*j + lp] = l[i];
+                memcpy(t + w*j + lp, l + i * DWT_STRIP, n * sizeof(*t));
             for (i = 1-mv; i < lv; i+=2, j++)
-                t[w*j + lp] = l[i];
+                memcpy(t + w*j + lp, l + i * DWT_STRIP, n * sizeof(*t));
         }
 
         // HOR_SD
@@ -324,11 +412,37 @@ static void sr_1d53(unsigned *p, int i0, int i1)
         p[2 * i + 1] += (int)(p[2 * i] + p[2 * i + 2]) >> 1;
 }
 
+static void sr_strip53(unsigned *p, int i0, int i1, int n)
+{
+    int i, c;
+
+    if (i1 <= i0 + 1) {
+        if (i0 == 1)
+            for (c = 0; c < n; c++)
+                p[DWT_STRIP + c] = (int)p[DWT_STRIP + c] >> 1;
+        return;
+    }
+
+    extend_strip(p, i0, i1, n, 2);
+
+    for (i = (i0 >> 1); i < (i1 >> 1) + 1; i++) {
+        unsigned *r = p + 2 * i * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] -= (int)(r[c - DWT_STRIP] + r[c + DWT_STRIP] + 2) >> 2;
+    }
+    for (i = (i0 >> 1); i < (i1 >> 1); i++) {
+        unsigned *r = p + (2 * i + 1) * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] += (int)(r[c - DWT_STRIP] + r[c + DWT_STRIP]) >> 1;
+    }
+}
+
 static void dwt_decode53(DWTContext *s, int *t)
 {
     int lev;
     int w     = s->linelen[s->ndeclevels - 1][0];
     int32_t *line = s->i_linebuf;
+    int32_t *strip = s->i_stripbuf + 3 * DWT_STRIP;
     line += 3;
 
     for (lev = 0; lev < s->ndeclevels; lev++) {
@@ -356,19 +470,19 @@ static void dwt_decode53(DWTContext *s, int *t)
         }
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
+        l = strip + mv * DWT_STRIP;
+        for (lp = 0; lp < lh; lp += DWT_STRIP) {
+            int i, j = 0, n = FFMIN(DWT_STRIP, lh - lp);
             // copy with interleaving
             for (i = mv; i < lv; i += 2, j++)
-                l[i] = t[w * j + lp];
+                memcpy(l + i * DWT_STRIP, t + w * j + lp, n * sizeof(*t));
             for (i = 1 - mv; i < lv; i += 2, j++)
-                l[i] = t[w * j + lp];
+                memcpy(l + i * DWT_STRIP, t + w * j + lp, n * sizeof(*t));
 
-            sr_1d53(line, mv, mv + lv);
+            sr_strip53((unsigned *)strip, mv, mv + lv, n);
 
             for (i = 0; i < lv; i++)
-                t[w * i + lp] = l[i];
+                memcpy(t + w * i + lp, l + i * DWT_STRIP, n * sizeof(*t));
         }
     }
 }
@@ -400,11 +514,53 @@ static void sr_1d97_float(float *p, int i0, int i1)
         p[2 * i + 1] += F_LFTG_ALPHA * (p[2 * i]     + p[2 * i + 2]);
 }
 
+static void sr_strip97_float(float *p, int i0, int i1, int n)
+{
+    int i, c;
+
+    if (i1 <= i0 + 1) {
+        if (i0 == 1)
+            for (c = 0; c < n; c++)
+                p[DWT_STRIP + c] *= F_LFTG_K/2;
+        else
+            for (c = 0; c < n; c++)
+                p[c] *= F_LFTG_X;
+        return;
+    }
+
+    extend_strip(p, i0, i1, n, 4);
+
+    for (i = (i0 >> 1) - 1; i < (i1 >> 1) + 2; i++) {
+        float *r = p + 2 * i * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] -= F_LFTG_DELTA * (r[c - DWT_STRIP] + r[c + DWT_STRIP]);
+    }
+    /* step 4 */
+    for (i = (i0 >> 1) - 1; i < (i1 >> 1) + 1; i++) {
+        float *r = p + (2 * i + 1) * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] -= F_LFTG_GAMMA * (r[c - DWT_STRIP] + r[c + DWT_STRIP]);
+    }
+    /*step 5*/
+    for (i = (i0 >> 1); i < (i1 >> 1) + 1; i++) {
+        float *r = p + 2 * i * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] += F_LFTG_BETA  * (r[c - DWT_STRIP] + r[c + DWT_STRIP]);
+    }
+    /* step 6 */
+    for (i = (i0 >> 1); i < (i1 >> 1); i++) {
+        float *r = p + (2 * i + 1) * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] += F_LFTG_ALPHA * (r[c - DWT_STRIP] + r[c + DWT_STRIP]);
+    }
+}
+
 static void dwt_decode97_float(DWTContext *s, float *t)
 {
     int lev;
     int w       = s->linelen[s->ndeclevels - 1][0];
     float *line = s->f_linebuf;
+    float *strip = s->f_stripbuf + 5 * DWT_STRIP;
     float *data = t;
     /* position at index O of line range [0-5,w+5] cf. extend function */
     line += 5;
@@ -433,19 +589,19 @@ static void dwt_decode97_float(DWTContext *s, float *t)
         }
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
+        l = strip + mv * DWT_STRIP;
+        for (lp = 0; lp < lh; lp += DWT_STRIP) {
+            int i, j = 0, n = FFMIN(DWT_STRIP, lh - lp);
             // copy with interleaving
             for (i = mv; i < lv; i += 2, j++)
-                l[i] = data[w * j + lp];
+                memcpy(l + i * DWT_STRIP, data + w * j + lp, n * sizeof(*data));
             for (i = 1 - mv; i < lv; i += 2, j++)
-                l[i] = data[w * j + lp];
+                memcpy(l + i * DWT_STRIP, data + w * j + lp, n * sizeof(*data));
 
-            sr_1d97_float(line, mv, mv + lv);
+            sr_strip97_float(strip, mv, mv + lv, n);
 
             for (i = 0; i < lv; i++)
-                data[w * i + lp] = l[i];
+                memcpy(data + w * i + lp, l + i * DWT_STRIP, n * sizeof(*data));
         }
     }
 }
@@ -480,6 +636,50 @@ static void sr_1d97_int(int32_t *p, int i0, int i1)
     }
 }
 
+static void sr_strip97_int(int32_t *p, int i0, int i1, int n)
+{
+    int i, c;
+
+    if (i1 <= i0 + 1) {
+        if (i0 == 1)
+            for (c = 0; c < n; c++)
+                p[DWT_STRIP + c] = (p[DWT_STRIP + c] * I_LFTG_K + (1<<16)) >> 17;
+        else
+            for (c = 0; c < n; c++)
+                p[c] = (p[c] * I_LFTG_X + (1<<15)) >> 16;
+        return;
+    }
+
+    extend_strip(p, i0, i1, n, 4);
+
+    for (i = (i0 >> 1) - 1; i < (i1 >> 1) + 2; i++) {
+        int32_t *r = p + 2 * i * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] -= (I_LFTG_DELTA * (r[c - DWT_STRIP] + (int64_t)r[c + DWT_STRIP]) + (1 << 15)) >> 16;
+    }
+    /* step 4 */
+    for (i = (i0 >> 1) - 1; i < (i1 >> 1) + 1; i++) {
+        int32_t *r = p + (2 * i + 1) * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] -= (I_LFTG_GAMMA * (r[c - DWT_STRIP] + (int64_t)r[c + DWT_STRIP]) + (1 << 15)) >> 16;
+    }
+    /*step 5*/
+    for (i = (i0 >> 1); i < (i1 >> 1) + 1; i++) {
+        int32_t *r = p + 2 * i * DWT_STRIP;
+        for (c = 0; c < n; c++)
+            r[c] += (I_LFTG_BETA  * (r[c - DWT_STRIP] + (int64_t)r[c + DWT_STRIP]) + (1 << 15)) >> 16;
+    }
+    /* step 6 */
+    for (i = (i0 >> 1); i < (i1 >> 1); i++) {
+        int32_t *r = p + (2 * i + 1) * DWT_STRIP;
+        for (c = 0; c < n; c++) {
+            const int64_t sum = r[c - DWT_STRIP] + (int64_t)r[c + DWT_STRIP];
+            r[c] += sum;
+            r[c] += (I_LFTG_ALPHA_PRIME * sum + (1 << 15)) >> 16;
+        }
+    }
+}
+
 static void dwt_decode97_int(DWTContext *s, int32_t *t)
 {
     int lev;
@@ -487,6 +687,7 @@ static void dwt_decode97_int(DWTContext *s, int32_t *t)
     int h       = s->linelen[s->ndeclevels - 1][1];
     int i;
     int32_t *line = s->i_linebuf;
+    int32_t *strip = s->i_stripbuf + 5 * DWT_STRIP;
     int32_t *data = t;
     /* position at index O of line range [0-5,w+5] cf. extend function */
     line += 5;
@@ -515,19 +716,19 @@ static void dwt_decode97_int(DWTContext *s, int32_t *t)
         }
 
         // VER_SD
-        l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
-            int i, j = 0;
-            // interleaving
+        l = strip + mv * DWT_STRIP;
+        for (lp = 0; lp < lh; lp += DWT_STRIP) {
+            int i, j = 0, n = FFMIN(DWT_STRIP, lh - lp);
+            // copy with interleaving
             for (i = mv; i < lv; i += 2, j++)
-                l[i] = data[w * j + lp];
+                memcpy(l + i * DWT_STRIP, data + w * j + lp, n * sizeof(*data));
             for (i = 1 - mv; i < lv; i += 2, j++)
-                l[i] = data[w * j + lp];
+                memcpy(l + i * DWT_STRIP, data + w * j + lp, n * sizeof(*data));
 
-            sr_1d97_int(line, mv, mv + lv);
+            sr_strip97_int(strip, mv, mv + lv, n);
 
             for (i = 0; i < lv; i++)
-                data[w * i + lp] = l[i];
+                memcpy(data + w * i + lp, l + i * DWT_STRIP, n * sizeof(*data));
         }
     }
 
@@ -580,11 +781,32 @@ int ff_jpeg2000_dwt_init(DWTContext *s, int border[2][2],
     return 0;
 }
 
+static int alloc_stripbuf(DWTContext *s)
+{
+    size_t size = (s->linelen[s->ndeclevels-1][1] + 12) * DWT_STRIP * sizeof(int32_t);
+
+    if (s->type == FF_DWT97) {
+        av_fast_malloc(&s->f_stripbuf, &s->f_stripbuf_size, size);
+        if (!s->f_stripbuf)
+            return AVERROR(ENOMEM);
+    } else {
+        av_fast_malloc(&s->i_stripbuf, &s->i_stripbuf_size, size);
+        if (!s->i_stripbuf)
+            return AVERROR(ENOMEM);
+    }
+    return 0;
+}
+
 int ff_dwt_encode(DWTContext *s, void *t)
 {
+    int ret;
+
     if (s->ndeclevels == 0)
         return 0;
 
+    if (s->type != FF_DWT97 && (ret = alloc_stripbuf(s)) < 0)
+        return ret;
+
     switch(s->type){
         case FF_DWT97:
             dwt_encode97_float(s, t); break;
@@ -600,9 +822,14 @@ int ff_dwt_encode(DWTContext *s, void *t)
 
 int ff_dwt_decode(DWTContext *s, void *t)
 {
+    int ret;
+
     if (s->ndeclevels == 0)
         return 0;
 
+    if ((ret = alloc_stripbuf(s)) < 0)
+        return ret;
+
     switch (s->type) {
     case FF_DWT97:
         dwt_decode97_float(s, t);
@@ -623,4 +850,8 @@ void ff_dwt_destroy(DWTContext *s)
 {
     av_freep(&s->f_linebuf);
     av_freep(&s->i_linebuf);
+    av_freep(&s->i_stripbuf);
+    av_freep(&s->f_stripbuf);
+    s->i_stripbuf_size = 0;
+    s->f_stripbuf_size = 0;
 }
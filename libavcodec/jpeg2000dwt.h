@@ -49,6 +49,10 @@ typedef struct DWTContext {
     uint8_t type;                        ///< 0 for 9/7; 1 for 5/3
     int32_t *i_linebuf;                  ///< int buffer used by transform
     float   *f_linebuf;                  ///< float buffer used by transform
+    int32_t *i_stripbuf;                 ///< int buffer for column strips
+    unsigned int i_stripbuf_size;
+    float   *f_stripbuf;                 ///< float buffer for column strips
+    unsigned int f_stripbuf_size;
 } DWTContext;
 
 /**
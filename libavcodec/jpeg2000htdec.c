@@ -1315,18 +1315,25 @@ ff_jpeg2000_decode_htj2k(const Jpeg2000DecoderContext *s, Jpeg2000CodingStyle *c
                                        pLSB - 1, sample_buf, block_states);
 
     /* Reconstruct the sample values */
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int32_t sign;
-
-            n = x + (y * t1->stride);
-            val = sample_buf[x + (y * quad_buf_width)];
-            sign = val & INT32_MIN;
-            val &= INT32_MAX;
-            /* ROI shift, if necessary */
-            if (roi_shift && (((uint32_t)val & ~mask) == 0))
-                val <<= roi_shift;
-            t1->data[n] = val | sign; /* NOTE: Binary point for reconstruction value is located in 31 - M_b */
+    if (!roi_shift) {
+        /* sample_buf already holds sign-magnitude values, copy the rows */
+        for (int y = 0; y < height; y++)
+            memcpy(t1->data + y * t1->stride, sample_buf + y * quad_buf_width,
+                   width * sizeof(*t1->data));
+    } else {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int32_t sign;
+
+                n = x + (y * t1->stride);
+                val = sample_buf[x + (y * quad_buf_width)];
+                sign = val & INT32_MIN;
+                val &= INT32_MAX;
+                /* ROI shift, if necessary */
+                if (((uint32_t)val & ~mask) == 0)
+                    val <<= roi_shift;
+                t1->data[n] = val | sign; /* NOTE: Binary point for reconstruction value is located in 31 - M_b */
+            }
         }
     }
 free:
@@ -817,10 +817,11 @@ int ff_mjpeg_decode_sof(MJpegDecodeContext *s)
     return 0;
 }
 
-static inline int mjpeg_decode_dc(MJpegDecodeContext *s, int dc_index)
+static inline int mjpeg_decode_dc(MJpegDecodeContext *s, GetBitContext *gb,
+                                  int dc_index)
 {
     int code;
-    code = get_vlc2(&s->gb, s->vlcs[0][dc_index].table, 9, 2);
+    code = get_vlc2(gb, s->vlcs[0][dc_index].table, 9, 2);
     if (code < 0 || code > 16) {
         av_log(s->avctx, AV_LOG_WARNING,
                "mjpeg_decode_dc: bad vlc: %d:%d (%p)\n",
@@ -829,46 +830,47 @@ static inline int mjpeg_decode_dc(MJpegDecodeContext *s, int dc_index)
     }
 
     if (code)
-        return get_xbits(&s->gb, code);
+        return get_xbits(gb, code);
     else
         return 0;
 }
 
 /* decode block and dequantize */
-static int decode_block(MJpegDecodeContext *s, int16_t *block, int component,
+static int decode_block(MJpegDecodeContext *s, GetBitContext *gb, int *last_dc,
+                        int16_t *block, int component,
                         int dc_index, int ac_index, uint16_t *quant_matrix)
 {
     int code, i, j, level, val;
 
     /* DC coef */
-    val = mjpeg_decode_dc(s, dc_index);
+    val = mjpeg_decode_dc(s, gb, dc_index);
     if (val == 0xfffff) {
         av_log(s->avctx, AV_LOG_ERROR, "error dc\n");
         return AVERROR_INVALIDDATA;
     }
-    val = val * (unsigned)quant_matrix[0] + s->last_dc[component];
-    s->last_dc[component] = val;
+    val = val * (unsigned)quant_matrix[0] + last_dc[component];
+    last_dc[component] = val;
     block[0] = av_clip_int16(val);
     /* AC coefs */
     i = 0;
-    {OPEN_READER(re, &s->gb);
+    {OPEN_READER(re, gb);
     do {
-        UPDATE_CACHE(re, &s->gb);
-        GET_VLC(code, re, &s->gb, s->vlcs[1][ac_index].table, 9, 2);
+        UPDATE_CACHE(re, gb);
+        GET_VLC(code, re, gb, s->vlcs[1][ac_index].table, 9, 2);
 
         i += ((unsigned)code) >> 4;
             code &= 0xf;
         if (code) {
             if (code > MIN_CACHE_BITS - 16)
-                UPDATE_CACHE(re, &s->gb);
+                UPDATE_CACHE(re, gb);
 
             {
-                int cache = GET_CACHE(re, &s->gb);
+                int cache = GET_CACHE(re, gb);
                 int sign  = (~cache) >> 31;
                 level     = (NEG_USR32(sign ^ cache,code) ^ sign) - sign;
             }
 
-            LAST_SKIP_BITS(re, &s->gb, code);
+            LAST_SKIP_BITS(re, gb, code);
 
             if (i > 63) {
                 av_log(s->avctx, AV_LOG_ERROR, "error count: %d\n", i);
@@ -878,7 +880,7 @@ static int decode_block(MJpegDecodeContext *s, int16_t *block, int component,
             block[j] = level * quant_matrix[i];
         }
     } while (i < 63);
-    CLOSE_READER(re, &s->gb);}
+    CLOSE_READER(re, gb);}
 
     return 0;
 }
@@ -889,7 +891,7 @@ static int decode_dc_progressive(MJpegDecodeContext *s, int16_t *block,
 {
     unsigned val;
     s->bdsp.clear_block(block);
-    val = mjpeg_decode_dc(s, dc_index);
+    val = mjpeg_decode_dc(s, &s->gb, dc_index);
     if (val == 0xfffff) {
         av_log(s->avctx, AV_LOG_ERROR, "error dc\n");
         return AVERROR_INVALIDDATA;
@@ -1183,7 +1185,7 @@ static int ljpeg_decode_rgb_scan(MJpegDecodeContext *s, int nb_components, int p
                 topleft[i] = top[i];
                 top[i]     = buffer[mb_x][i];
 
-                dc = mjpeg_decode_dc(s, s->dc_index[i]);
+                dc = mjpeg_decode_dc(s, &s->gb, s->dc_index[i]);
                 if(dc == 0xFFFFF)
                     return -1;
 
@@ -1317,7 +1319,7 @@ static int ljpeg_decode_yuv_scan(MJpegDecodeContext *s, int predictor,
                     for(j=0; j<n; j++) {
                         int pred, dc;
 
-                        dc = mjpeg_decode_dc(s, s->dc_index[i]);
+                        dc = mjpeg_decode_dc(s, &s->gb, s->dc_index[i]);
                         if(dc == 0xFFFFF)
                             return -1;
                         if (   h * mb_x + x >= s->width
@@ -1388,7 +1390,7 @@ static int ljpeg_decode_yuv_scan(MJpegDecodeContext *s, int predictor,
                     for (j = 0; j < n; j++) {
                         int pred;
 
-                        dc = mjpeg_decode_dc(s, s->dc_index[i]);
+                        dc = mjpeg_decode_dc(s, &s->gb, s->dc_index[i]);
                         if(dc == 0xFFFFF)
                             return -1;
                         if (   h * mb_x + x >= s->width
@@ -1457,17 +1459,201 @@ static void shift_output(MJpegDecodeContext *s, uint8_t *ptr, int linesize)
     }
 }
 
+typedef struct MJpegScan {
+    uint8_t *data[MAX_COMPONENTS];
+    const uint8_t *reference_data[MAX_COMPONENTS];
+    int linesize[MAX_COMPONENTS];
+    int chroma_width, chroma_height;
+    int bytes_per_pixel;
+    int nb_components;
+    int Ah, Al;
+
+    /* restart interval segments, for slice threading */
+    const uint8_t *seg_start;
+    const uint8_t *seg_end;
+    int nb_segments;
+    int nb_jobs;
+} MJpegScan;
+
+static av_always_inline int decode_mcu(MJpegDecodeContext *s, const MJpegScan *scan,
+                                       GetBitContext *gb, int *last_dc, int16_t *block,
+                                       int mb_x, int mb_y, int copy_mb)
+{
+    const int *linesize = scan->linesize;
+    int i;
+
+    for (i = 0; i < scan->nb_components; i++) {
+        uint8_t *ptr;
+        int n, h, v, x, y, c, j;
+        int block_offset;
+        n = s->nb_blocks[i];
+        c = s->comp_index[i];
+        h = s->h_scount[i];
+        v = s->v_scount[i];
+        x = 0;
+        y = 0;
+        for (j = 0; j < n; j++) {
+            block_offset = (((linesize[c] * (v * mb_y + y) * 8) +
+                             (h * mb_x + x) * 8 * scan->bytes_per_pixel) >> s->avctx->lowres);
+
+            if (s->interlaced && s->bottom_field)
+                block_offset += linesize[c] >> 1;
+            if (   8*(h * mb_x + x) < ((c == 1) || (c == 2) ? scan->chroma_width  : s->width)
+                && 8*(v * mb_y + y) < ((c == 1) || (c == 2) ? scan->chroma_height : s->height)) {
+                ptr = scan->data[c] + block_offset;
+            } else
+                ptr = NULL;
+            if (!s->progressive) {
+                if (copy_mb) {
+                    if (ptr)
+                        mjpeg_copy_block(s, ptr, scan->reference_data[c] + block_offset,
+                                        linesize[c], s->avctx->lowres);
+
+                } else {
+                    s->bdsp.clear_block(block);
+                    if (decode_block(s, gb, last_dc, block, i,
+                                     s->dc_index[i], s->ac_index[i],
+                                     s->quant_matrixes[s->quant_sindex[i]]) < 0) {
+                        av_log(s->avctx, AV_LOG_ERROR,
+                               "error y=%d x=%d\n", mb_y, mb_x);
+                        return AVERROR_INVALIDDATA;
+                    }
+                    if (ptr && linesize[c]) {
+                        s->idsp.idct_put(ptr, linesize[c], block);
+                        if (s->bits & 7)
+                            shift_output(s, ptr, linesize[c]);
+                    }
+                }
+            } else {
+                int block_idx  = s->block_stride[c] * (v * mb_y + y) +
+                                 (h * mb_x + x);
+                int16_t *coefs = s->blocks[c][block_idx];
+                if (scan->Ah)
+                    coefs[0] += get_bits1(gb) *
+                                s->quant_matrixes[s->quant_sindex[i]][0] << scan->Al;
+                else if (decode_dc_progressive(s, coefs, i, s->dc_index[i],
+                                               s->quant_matrixes[s->quant_sindex[i]],
+                                               scan->Al) < 0) {
+                    av_log(s->avctx, AV_LOG_ERROR,
+                           "error y=%d x=%d\n", mb_y, mb_x);
+                    return AVERROR_INVALIDDATA;
+                }
+            }
+            ff_dlog(s->avctx, "mb: %d %d processed\n", mb_y, mb_x);
+            ff_dlog(s->avctx, "%d %d %d %d %d %d %d %d \n",
+                    mb_x, mb_y, x, y, c, s->bottom_field,
+                    (v * mb_y + y) * 8, (h * mb_x + x) * 8);
+            if (++x == h) {
+                x = 0;
+                y++;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Decode a range of the restart interval segments of a scan, each of which
+ * starts with a DC prediction reset and can be decoded independently.
+ */
+static int decode_scan_segments(AVCodecContext *avctx, void *arg,
+                                int jobnr, int threadnr)
+{
+    MJpegDecodeContext *s = avctx->priv_data;
+    const MJpegScan *scan = arg;
+    const int nb_mcus   = s->mb_width * s->mb_height;
+    const int seg_start = scan->nb_segments *  jobnr      / scan->nb_jobs;
+    const int seg_end   = scan->nb_segments * (jobnr + 1) / scan->nb_jobs;
+    LOCAL_ALIGNED_32(int16_t, block, [64]);
+    int last_dc[MAX_COMPONENTS];
+    GetBitContext gb;
+
+    for (int seg = seg_start; seg < seg_end; seg++) {
+        const uint8_t *start = seg ? s->buffer + s->rst_offsets[seg - 1] + 1 : scan->seg_start;
+        const uint8_t *end   = seg < s->nb_rst_offsets ? s->buffer + s->rst_offsets[seg] - 1
+                                                        : scan->seg_end;
+        const int mcu_end    = FFMIN((int64_t)(seg + 1) * s->restart_interval, nb_mcus);
+        int ret;
+
+        ret = init_get_bits8(&gb, start, FFMAX(end - start, 0));
+        if (ret < 0)
+            return ret;
+        for (int i = 0; i < scan->nb_components; i++)
+            last_dc[i] = 4 << s->bits;
+
+        for (int mcu = seg * s->restart_interval; mcu < mcu_end; mcu++) {
+            if (get_bits_left(&gb) < 0) {
+                av_log(avctx, AV_LOG_ERROR, "overread %d\n", -get_bits_left(&gb));
+                return AVERROR_INVALIDDATA;
+            }
+            ret = decode_mcu(s, scan, &gb, last_dc, block,
+                             mcu % s->mb_width, mcu / s->mb_width, 0);
+            if (ret < 0)
+                return ret;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Split a baseline scan at its RSTn markers and decode the segments with
+ * slice threads. Returns 0 if the scan is not suitable for it.
+ */
+static int decode_scan_threaded(MJpegDecodeContext *s, MJpegScan *scan)
+{
+    AVCodecContext *avctx = s->avctx;
+    const int nb_mcus     = s->mb_width * s->mb_height;
+    const int start       = get_bits_count(&s->gb) >> 3;
+    int64_t nb_segments;
+    int *rets, ret = 0;
+
+    if (!(avctx->active_thread_type & FF_THREAD_SLICE) || avctx->thread_count < 2 ||
+        !s->restart_interval || s->progressive || s->nb_rst_offsets <= 0 ||
+        s->gb.buffer != s->buffer || (get_bits_count(&s->gb) & 7))
+        return 0;
+
+    /* the markers must fit the restart interval exactly, anything else is
+     * left to the error resilience of the single threaded path */
+    nb_segments = (nb_mcus + (int64_t)s->restart_interval - 1) / s->restart_interval;
+    if (nb_segments < 2 || s->nb_rst_offsets < nb_segments - 1 ||
+        s->rst_offsets[0] <= start)
+        return 0;
+
+    scan->seg_start   = s->buffer + start;
+    scan->seg_end     = s->gb.buffer_end;
+    scan->nb_segments = nb_segments;
+    scan->nb_jobs     = FFMIN(nb_segments, avctx->thread_count);
+
+    rets = av_malloc_array(scan->nb_jobs, sizeof(*rets));
+    if (!rets)
+        return AVERROR(ENOMEM);
+    avctx->execute2(avctx, decode_scan_segments, scan, rets, scan->nb_jobs);
+    for (int i = 0; i < scan->nb_jobs; i++)
+        if (rets[i] < 0)
+            ret = rets[i];
+    av_free(rets);
+    if (ret < 0)
+        return ret;
+
+    /* continue after the last segment, like the single threaded path */
+    if (nb_segments <= s->nb_rst_offsets)
+        skip_bits_long(&s->gb, 8 * (s->rst_offsets[nb_segments - 1] - 1) - get_bits_count(&s->gb));
+    else
+        skip_bits_long(&s->gb, get_bits_left(&s->gb));
+    return 1;
+}
+
 static int mjpeg_decode_scan(MJpegDecodeContext *s, int nb_components, int Ah,
                              int Al, const uint8_t *mb_bitmask,
                              int mb_bitmask_size,
                              const AVFrame *reference)
 {
-    int i, mb_x, mb_y, chroma_h_shift, chroma_v_shift, chroma_width, chroma_height;
-    uint8_t *data[MAX_COMPONENTS];
-    const uint8_t *reference_data[MAX_COMPONENTS];
-    int linesize[MAX_COMPONENTS];
+    int i, mb_x, mb_y, chroma_h_shift, chroma_v_shift, ret;
+    MJpegScan scan = { .nb_components = nb_components, .Ah = Ah, .Al = Al };
     GetBitContext mb_bitmask_gb = {0}; // initialize to silence gcc warning
-    int bytes_per_pixel = 1 + (s->bits > 8);
+
+    scan.bytes_per_pixel = 1 + (s->bits > 8);
 
     if (mb_bitmask) {
         if (mb_bitmask_size != (s->mb_width * s->mb_height + 7)>>3) {
@@ -1481,17 +1667,23 @@ static int mjpeg_decode_scan(MJpegDecodeContext *s, int nb_components, int Ah,
 
     av_pix_fmt_get_chroma_sub_sample(s->avctx->pix_fmt, &chroma_h_shift,
                                      &chroma_v_shift);
-    chroma_width  = AV_CEIL_RSHIFT(s->width,  chroma_h_shift);
-    chroma_height = AV_CEIL_RSHIFT(s->height, chroma_v_shift);
+    scan.chroma_width  = AV_CEIL_RSHIFT(s->width,  chroma_h_shift);
+    scan.chroma_height = AV_CEIL_RSHIFT(s->height, chroma_v_shift);
 
     for (i = 0; i < nb_components; i++) {
         int c   = s->comp_index[i];
-        data[c] = s->picture_ptr->data[c];
-        reference_data[c] = reference ? reference->data[c] : NULL;
-        linesize[c] = s->linesize[c];
+        scan.data[c] = s->picture_ptr->data[c];
+        scan.reference_data[c] = reference ? reference->data[c] : NULL;
+        scan.linesize[c] = s->linesize[c];
         s->coefs_finished[c] |= 1;
     }
 
+    if (!mb_bitmask && s->avctx->codec_id != AV_CODEC_ID_THP) {
+        ret = decode_scan_threaded(s, &scan);
+        if (ret)
+            return FFMIN(ret, 0);
+    }
+
     for (mb_y = 0; mb_y < s->mb_height; mb_y++) {
         for (mb_x = 0; mb_x < s->mb_width; mb_x++) {
             const int copy_mb = mb_bitmask && !get_bits1(&mb_bitmask_gb);
@@ -1504,73 +1696,10 @@ static int mjpeg_decode_scan(MJpegDecodeContext *s, int nb_components, int Ah,
                        -get_bits_left(&s->gb));
                 return AVERROR_INVALIDDATA;
             }
-            for (i = 0; i < nb_components; i++) {
-                uint8_t *ptr;
-                int n, h, v, x, y, c, j;
-                int block_offset;
-                n = s->nb_blocks[i];
-                c = s->comp_index[i];
-                h = s->h_scount[i];
-                v = s->v_scount[i];
-                x = 0;
-                y = 0;
-                for (j = 0; j < n; j++) {
-                    block_offset = (((linesize[c] * (v * mb_y + y) * 8) +
-                                     (h * mb_x + x) * 8 * bytes_per_pixel) >> s->avctx->lowres);
-
-                    if (s->interlaced && s->bottom_field)
-                        block_offset += linesize[c] >> 1;
-                    if (   8*(h * mb_x + x) < ((c == 1) || (c == 2) ? chroma_width  : s->width)
-                        && 8*(v * mb_y + y) < ((c == 1) || (c == 2) ? chroma_height : s->height)) {
-                        ptr = data[c] + block_offset;
-                    } else
-                        ptr = NULL;
-                    if (!s->progressive) {
-                        if (copy_mb) {
-                            if (ptr)
-                                mjpeg_copy_block(s, ptr, reference_data[c] + block_offset,
-                                                linesize[c], s->avctx->lowres);
-
-                        } else {
-                            s->bdsp.clear_block(s->block);
-                            if (decode_block(s, s->block, i,
-                                             s->dc_index[i], s->ac_index[i],
-                                             s->quant_matrixes[s->quant_sindex[i]]) < 0) {
-                                av_log(s->avctx, AV_LOG_ERROR,
-                                       "error y=%d x=%d\n", mb_y, mb_x);
-                                return AVERROR_INVALIDDATA;
-                            }
-                            if (ptr && linesize[c]) {
-                                s->idsp.idct_put(ptr, linesize[c], s->block);
-                                if (s->bits & 7)
-                                    shift_output(s, ptr, linesize[c]);
-                            }
-                        }
-                    } else {
-                        int block_idx  = s->block_stride[c] * (v * mb_y + y) +
-                                         (h * mb_x + x);
-                        int16_t *block = s->blocks[c][block_idx];
-                        if (Ah)
-                            block[0] += get_bits1(&s->gb) *
-                                        s->quant_matrixes[s->quant_sindex[i]][0] << Al;
-                        else if (decode_dc_progressive(s, block, i, s->dc_index[i],
-                                                       s->quant_matrixes[s->quant_sindex[i]],
-                                                       Al) < 0) {
-                            av_log(s->avctx, AV_LOG_ERROR,
-                                   "error y=%d x=%d\n", mb_y, mb_x);
-                            return AVERROR_INVALIDDATA;
-                        }
-                    }
-                    ff_dlog(s->avctx, "mb: %d %d processed\n", mb_y, mb_x);
-                    ff_dlog(s->avctx, "%d %d %d %d %d %d %d %d \n",
-                            mb_x, mb_y, x, y, c, s->bottom_field,
-                            (v * mb_y + y) * 8, (h * mb_x + x) * 8);
-                    if (++x == h) {
-                        x = 0;
-                        y++;
-                    }
-                }
-            }
+            ret = decode_mcu(s, &scan, &s->gb, s->last_dc, s->block,
+                             mb_x, mb_y, copy_mb);
+            if (ret < 0)
+                return ret;
 
             handle_rstn(s, nb_components);
         }
@@ -2210,6 +2339,31 @@ static int mjpeg_decode_com(MJpegDecodeContext *s)
     return 0;
 }
 
+/**
+ * Record the position of an RSTn marker code in the unescaped scan data.
+ * Markers out of sequence disable slice threading for the scan.
+ */
+static void add_rst_offset(MJpegDecodeContext *s, int offset, int n)
+{
+    int *offsets;
+
+    if (s->nb_rst_offsets < 0)
+        return;
+    if (n != (s->nb_rst_offsets & 7)) {
+        s->nb_rst_offsets = -1;
+        return;
+    }
+
+    offsets = av_fast_realloc(s->rst_offsets, &s->rst_offsets_size,
+                              (s->nb_rst_offsets + 1) * sizeof(*offsets));
+    if (!offsets) {
+        s->nb_rst_offsets = -1;
+        return;
+    }
+    s->rst_offsets = offsets;
+    s->rst_offsets[s->nb_rst_offsets++] = offset;
+}
+
 /* return the 8 bit start code value and update the search
    state. Return -1 if no start code found */
 static int find_marker(const uint8_t **pbuf_ptr, const uint8_t *buf_end)
@@ -2264,6 +2418,8 @@ int ff_mjpeg_find_marker(MJpegDecodeContext *s,
             }                                         \
         } while (0)
 
+        s->nb_rst_offsets = 0;
+
         if (s->avctx->codec_id == AV_CODEC_ID_THP) {
             ptr = buf_end;
             copy_data_segment(0);
@@ -2292,7 +2448,8 @@ int ff_mjpeg_find_marker(MJpegDecodeContext *s,
                         copy_data_segment(1);
                         if (x)
                             break;
-                    }
+                    } else
+                        add_rst_offset(s, (dst - s->buffer) + (ptr - 1 - src), x - RST0);
                 }
             }
             if (src < ptr)
@@ -2960,6 +3117,7 @@ av_cold int ff_mjpeg_decode_end(AVCodecContext *avctx)
     av_frame_free(&s->smv_frame);
 
     av_freep(&s->buffer);
+    av_freep(&s->rst_offsets);
     av_freep(&s->stereo3d);
     av_freep(&s->ljpeg_buffer);
     s->ljpeg_buffer_size = 0;
@@ -3017,7 +3175,7 @@ const FFCodec ff_mjpeg_decoder = {
     .close          = ff_mjpeg_decode_end,
     FF_CODEC_DECODE_CB(ff_mjpeg_decode_frame),
     .flush          = decode_flush,
-    .p.capabilities = AV_CODEC_CAP_DR1,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_SLICE_THREADS,
     .p.max_lowres   = 3,
     .p.priv_class   = &mjpegdec_class,
     .p.profiles     = NULL_IF_CONFIG_SMALL(ff_mjpeg_profiles),
@@ -123,6 +123,9 @@ typedef struct MJpegDecodeContext {
 
     int restart_interval;
     int restart_count;
+    int *rst_offsets;       ///< offsets of the RSTn marker codes in the unescaped scan
+    unsigned int rst_offsets_size;
+    int nb_rst_offsets;     ///< number of RSTn markers in the scan, < 0 if unusable
 
     int buggy_avid;
     int cs_itu601;
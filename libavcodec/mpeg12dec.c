@@ -1070,7 +1070,8 @@ static void mpeg_decode_sequence_extension(Mpeg1Context *s1)
     s->avctx->rc_buffer_size += get_bits(&s->gb, 8) * 1024 * 16 << 10;
 
     s->low_delay = get_bits1(&s->gb);
-    if (s->avctx->flags & AV_CODEC_FLAG_LOW_DELAY)
+    if (s->avctx->flags  & AV_CODEC_FLAG_LOW_DELAY ||
+        s->avctx->flags2 & AV_CODEC_FLAG2_KEYFRAMES_ONLY)
         s->low_delay = 1;
 
     s1->frame_rate_ext.num = get_bits(&s->gb, 2) + 1;
@@ -1836,7 +1837,8 @@ static int mpeg1_decode_sequence(AVCodecContext *avctx,
     s->chroma_format        = CHROMA_420;
     s->codec_id             =
     s->avctx->codec_id      = AV_CODEC_ID_MPEG1VIDEO;
-    if (s->avctx->flags & AV_CODEC_FLAG_LOW_DELAY)
+    if (s->avctx->flags  & AV_CODEC_FLAG_LOW_DELAY ||
+        s->avctx->flags2 & AV_CODEC_FLAG2_KEYFRAMES_ONLY)
         s->low_delay = 1;
 
     if (s->avctx->debug & FF_DEBUG_PICT_INFO)
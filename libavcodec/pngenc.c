@@ -41,6 +41,7 @@
 #include <zlib.h>
 
 #define IOBUF_SIZE 4096
+#define DICT_SIZE  32768
 
 typedef struct APNGFctlChunk {
     uint32_t sequence_number;
@@ -50,6 +51,24 @@ typedef struct APNGFctlChunk {
     uint8_t dispose_op, blend_op;
 } APNGFctlChunk;
 
+/**
+ * Per-thread state for compressing a horizontal slice of the image into
+ * a raw deflate stream.
+ */
+typedef struct PNGEncThread {
+    FFZStream zstream;
+    uint8_t *crow_base;
+    uint8_t *dict;               ///< filtered rows preceding the slice
+} PNGEncThread;
+
+typedef struct PNGEncSlice {
+    uint8_t *buf;                ///< compressed data of the slice
+    unsigned int buf_size;
+    size_t len;
+    uLong adler;                 ///< Adler-32 of the uncompressed slice data
+    z_off_t in_len;
+} PNGEncSlice;
+
 typedef struct PNGEncContext {
     AVClass *class;
     LLVidEncDSPContext llvidencdsp;
@@ -59,6 +78,7 @@ typedef struct PNGEncContext {
     uint8_t *bytestream_end;
 
     int filter_type;
+    int compression_level;
 
     FFZStream zstream;
     uint8_t buf[IOBUF_SIZE];
@@ -70,6 +90,13 @@ typedef struct PNGEncContext {
     int color_type;
     int bits_per_pixel;
 
+    // parallel deflate
+    int nb_slices;
+    PNGEncSlice *slices;
+    int *slice_ret;
+    PNGEncThread *threads;
+    int nb_threads;
+
     // APNG
     uint32_t palette_checksum;   // Used to ensure a single unique palette
     uint32_t sequence_number;
@@ -506,6 +533,167 @@ static int encode_headers(AVCodecContext *avctx, const AVFrame *pict)
     return 0;
 }
 
+static int png_slice_deflate(PNGEncSlice *sl, z_stream *zstream,
+                             const uint8_t *data, int size, int flush)
+{
+    int ret;
+
+    zstream->next_in  = data;
+    zstream->avail_in = size;
+    for (;;) {
+        if (!zstream->avail_out) {
+            uint8_t *buf = av_fast_realloc(sl->buf, &sl->buf_size,
+                                           sl->buf_size + IOBUF_SIZE);
+            if (!buf)
+                return AVERROR(ENOMEM);
+            sl->buf = buf;
+            zstream->next_out  = sl->buf + sl->len;
+            zstream->avail_out = sl->buf_size - sl->len;
+        }
+        ret = deflate(zstream, flush);
+        sl->len = zstream->next_out - sl->buf;
+        if (ret != Z_OK && ret != Z_STREAM_END)
+            return AVERROR_EXTERNAL;
+        if (flush == Z_FINISH ? ret == Z_STREAM_END :
+            !zstream->avail_in && (flush == Z_NO_FLUSH || zstream->avail_out))
+            return 0;
+    }
+}
+
+/**
+ * Filter and compress the rows of one slice into a raw deflate stream.
+ * All slices but the last one end with a sync flush, so that their
+ * concatenation forms a single valid deflate stream.
+ */
+static int encode_slice(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    PNGEncContext *s        = avctx->priv_data;
+    const AVFrame *const p  = arg;
+    PNGEncThread *const t   = &s->threads[threadnr];
+    PNGEncSlice *const sl   = &s->slices[jobnr];
+    z_stream *const zstream = &t->zstream.zstream;
+    const int row_size = (p->width * s->bits_per_pixel + 7) >> 3;
+    const int bpp      = s->bits_per_pixel >> 3;
+    const int y0       = p->height *  jobnr      / s->nb_slices;
+    const int y1       = p->height * (jobnr + 1) / s->nb_slices;
+    const int flush    = jobnr < s->nb_slices - 1 ? Z_SYNC_FLUSH : Z_FINISH;
+    // pixel data should be aligned, but there's a control byte before it
+    uint8_t *crow_buf  = t->crow_base + 15;
+    uLong bound;
+    int y, ret;
+
+    deflateReset(zstream);
+    sl->len    = 0;
+    sl->adler  = adler32(0, Z_NULL, 0);
+    sl->in_len = (z_off_t)(y1 - y0) * (row_size + 1);
+
+    if (y0 > 0) {
+        /* Prime the window with the data the previous slice ends with,
+         * so that splitting the image costs as little compression as
+         * possible. */
+        int dict_rows = FFMIN(y0, (DICT_SIZE + row_size) / (row_size + 1));
+        int dict_len  = 0, dict_start;
+
+        for (y = y0 - dict_rows; y < y0; y++) {
+            const uint8_t *ptr = p->data[0] + y * p->linesize[0];
+            const uint8_t *top = y ? ptr - p->linesize[0] : NULL;
+            const uint8_t *crow = png_choose_filter(s, crow_buf, ptr, top,
+                                                    row_size, bpp);
+            memcpy(t->dict + dict_len, crow, row_size + 1);
+            dict_len += row_size + 1;
+        }
+        dict_start = FFMAX(dict_len - DICT_SIZE, 0);
+        if (deflateSetDictionary(zstream, t->dict + dict_start,
+                                 dict_len - dict_start) != Z_OK)
+            return AVERROR_EXTERNAL;
+    }
+
+    /* deflateBound() does not account for the sync flush marker */
+    bound = deflateBound(zstream, sl->in_len) + 16;
+    if (bound > INT_MAX)
+        return AVERROR(ENOMEM);
+    av_fast_malloc(&sl->buf, &sl->buf_size, bound);
+    if (!sl->buf)
+        return AVERROR(ENOMEM);
+    zstream->next_out  = sl->buf;
+    zstream->avail_out = sl->buf_size;
+
+    for (y = y0; y < y1; y++) {
+        const uint8_t *ptr = p->data[0] + y * p->linesize[0];
+        const uint8_t *top = y ? ptr - p->linesize[0] : NULL;
+        uint8_t *crow = png_choose_filter(s, crow_buf, ptr, top, row_size, bpp);
+
+        sl->adler = adler32(sl->adler, crow, row_size + 1);
+        ret = png_slice_deflate(sl, zstream, crow, row_size + 1,
+                                y < y1 - 1 ? Z_NO_FLUSH : flush);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static void png_write_image_stream(AVCodecContext *avctx, int *fill,
+                                   const uint8_t *data, size_t size)
+{
+    PNGEncContext *s = avctx->priv_data;
+
+    while (size > 0) {
+        int len = FFMIN(size, IOBUF_SIZE - *fill);
+
+        memcpy(s->buf + *fill, data, len);
+        *fill += len;
+        data  += len;
+        size  -= len;
+        if (*fill == IOBUF_SIZE) {
+            if (s->bytestream_end - s->bytestream > IOBUF_SIZE + 100)
+                png_write_image_data(avctx, s->buf, IOBUF_SIZE);
+            *fill = 0;
+        }
+    }
+}
+
+/**
+ * Compress the slices in parallel and join them into one zlib stream:
+ * the header, the concatenated raw deflate data and the Adler-32
+ * checksum combined from those of the slices.
+ */
+static int encode_frame_slices(AVCodecContext *avctx, const AVFrame *pict)
+{
+    PNGEncContext *s = avctx->priv_data;
+    const int level  = s->compression_level == Z_DEFAULT_COMPRESSION ?
+                       6 : s->compression_level;
+    uLong adler      = adler32(0, Z_NULL, 0);
+    unsigned header;
+    uint8_t buf[4];
+    int fill = 0;
+
+    avctx->execute2(avctx, encode_slice, (void *)pict, s->slice_ret, s->nb_slices);
+    for (int i = 0; i < s->nb_slices; i++)
+        if (s->slice_ret[i] < 0)
+            return s->slice_ret[i];
+
+    /* the header deflate() would write for this level and the default strategy */
+    header  = (Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8;
+    header |= (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+    header += 31 - header % 31;
+    AV_WB16(buf, header);
+    png_write_image_stream(avctx, &fill, buf, 2);
+
+    for (int i = 0; i < s->nb_slices; i++) {
+        const PNGEncSlice *sl = &s->slices[i];
+        png_write_image_stream(avctx, &fill, sl->buf, sl->len);
+        adler = adler32_combine(adler, sl->adler, sl->in_len);
+    }
+
+    AV_WB32(buf, adler);
+    png_write_image_stream(avctx, &fill, buf, 4);
+    if (fill > 0 && s->bytestream_end - s->bytestream > fill + 100)
+        png_write_image_data(avctx, s->buf, fill);
+
+    return 0;
+}
+
 static int encode_frame(AVCodecContext *avctx, const AVFrame *pict)
 {
     PNGEncContext *s       = avctx->priv_data;
@@ -518,6 +706,9 @@ static int encode_frame(AVCodecContext *avctx, const AVFrame *pict)
     uint8_t *progressive_buf = NULL;
     uint8_t *top_buf         = NULL;
 
+    if (s->nb_slices > 1)
+        return encode_frame_slices(avctx, pict);
+
     row_size = (pict->width * s->bits_per_pixel + 7) >> 3;
 
     crow_base = av_malloc((row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED));
@@ -1184,6 +1375,40 @@ static av_cold int png_enc_init(AVCodecContext *avctx)
     compression_level = avctx->compression_level == FF_COMPRESSION_DEFAULT
                       ? Z_DEFAULT_COMPRESSION
                       : av_clip(avctx->compression_level, 0, 9);
+    s->compression_level = compression_level;
+
+    if (avctx->slices > 1 && s->is_progressive) {
+        av_log(avctx, AV_LOG_WARNING,
+               "Slices are not supported with interlacing, ignoring.\n");
+    } else if (avctx->slices > 1) {
+        const int row_size = (avctx->width * s->bits_per_pixel + 7) >> 3;
+
+        s->nb_slices  = FFMIN(avctx->slices, avctx->height);
+        s->nb_threads = avctx->active_thread_type & FF_THREAD_SLICE ?
+                        avctx->thread_count : 1;
+        s->slices     = av_calloc(s->nb_slices, sizeof(*s->slices));
+        s->slice_ret  = av_calloc(s->nb_slices, sizeof(*s->slice_ret));
+        s->threads    = av_calloc(s->nb_threads, sizeof(*s->threads));
+        if (!s->slices || !s->slice_ret || !s->threads)
+            return AVERROR(ENOMEM);
+
+        for (int i = 0; i < s->nb_threads; i++) {
+            PNGEncThread *t = &s->threads[i];
+            int ret;
+
+            t->crow_base = av_malloc((row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED));
+            /* APNG encodes cropped frames with shorter rows, which need
+             * more of them to fill the window; DICT_SIZE + row_size bounds
+             * the dictionary for any row size up to the full width. */
+            t->dict      = av_malloc(DICT_SIZE + row_size);
+            if (!t->crow_base || !t->dict)
+                return AVERROR(ENOMEM);
+            ret = ff_deflate_init2(&t->zstream, compression_level, -MAX_WBITS, avctx);
+            if (ret < 0)
+                return ret;
+        }
+    }
+
     return ff_deflate_init(&s->zstream, compression_level, avctx);
 }
 
@@ -1192,6 +1417,18 @@ static av_cold int png_enc_close(AVCodecContext *avctx)
     PNGEncContext *s = avctx->priv_data;
 
     ff_deflate_end(&s->zstream);
+    for (int i = 0; i < s->nb_threads; i++) {
+        ff_deflate_end(&s->threads[i].zstream);
+        av_freep(&s->threads[i].crow_base);
+        av_freep(&s->threads[i].dict);
+    }
+    av_freep(&s->threads);
+    s->nb_threads = 0;
+    for (int i = 0; i < s->nb_slices; i++)
+        av_freep(&s->slices[i].buf);
+    av_freep(&s->slices);
+    av_freep(&s->slice_ret);
+    s->nb_slices = 0;
     av_frame_free(&s->last_frame);
     av_frame_free(&s->prev_frame);
     av_freep(&s->last_frame_packet);
@@ -1228,6 +1465,7 @@ const FFCodec ff_png_encoder = {
     .p.type         = AVMEDIA_TYPE_VIDEO,
     .p.id           = AV_CODEC_ID_PNG,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                      AV_CODEC_CAP_SLICE_THREADS |
                       AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE,
     .priv_data_size = sizeof(PNGEncContext),
     .init           = png_enc_init,
@@ -1240,7 +1478,7 @@ const FFCodec ff_png_encoder = {
                   AV_PIX_FMT_GRAY16BE, AV_PIX_FMT_YA16BE,
                   AV_PIX_FMT_MONOBLACK),
     .p.priv_class   = &pngenc_class,
-    .caps_internal  = FF_CODEC_CAP_ICC_PROFILES,
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP | FF_CODEC_CAP_ICC_PROFILES,
 };
 
 const FFCodec ff_apng_encoder = {
@@ -1249,6 +1487,7 @@ const FFCodec ff_apng_encoder = {
     .p.type         = AVMEDIA_TYPE_VIDEO,
     .p.id           = AV_CODEC_ID_APNG,
     .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                      AV_CODEC_CAP_SLICE_THREADS |
                       AV_CODEC_CAP_ENCODER_REORDERED_OPAQUE,
     .priv_data_size = sizeof(PNGEncContext),
     .init           = png_enc_init,
@@ -1260,5 +1499,5 @@ const FFCodec ff_apng_encoder = {
                   AV_PIX_FMT_GRAY8, AV_PIX_FMT_GRAY8A,
                   AV_PIX_FMT_GRAY16BE, AV_PIX_FMT_YA16BE),
     .p.priv_class   = &pngenc_class,
-    .caps_internal  = FF_CODEC_CAP_ICC_PROFILES,
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP | FF_CODEC_CAP_ICC_PROFILES,
 };
@@ -56,3 +56,14 @@ int ff_startcode_find_candidate_c(const uint8_t *buf, int size)
             break;
     return i;
 }
+
+ff_startcode_find_candidate_fn ff_startcode_find_candidate_get(void)
+{
+    ff_startcode_find_candidate_fn find_candidate = ff_startcode_find_candidate_c;
+
+#if ARCH_X86
+    ff_startcode_init_x86(&find_candidate);
+#endif
+
+    return find_candidate;
+}
@@ -31,6 +31,25 @@ const uint8_t *avpriv_find_start_code(const uint8_t *p,
                                       const uint8_t *end,
                                       uint32_t *state);
 
+/**
+ * Search buf for the first zero byte, which may start a start code.
+ *
+ * The buffer must be padded by AV_INPUT_BUFFER_PADDING_SIZE bytes,
+ * which may be read.
+ *
+ * @return the offset of the zero byte, or a value >= size if there is
+ *         none in the first size bytes
+ */
+typedef int (*ff_startcode_find_candidate_fn)(const uint8_t *buf, int size);
+
 int ff_startcode_find_candidate_c(const uint8_t *buf, int size);
 
+/**
+ * Get the fastest startcode_find_candidate implementation for the
+ * running CPU.
+ */
+ff_startcode_find_candidate_fn ff_startcode_find_candidate_get(void);
+
+void ff_startcode_init_x86(ff_startcode_find_candidate_fn *find_candidate);
+
 #endif /* AVCODEC_STARTCODE_H */
@@ -30,6 +30,7 @@
 #include "libavutil/intreadwrite.h"
 #include "libavutil/libm.h"
 
+#include "config.h"
 #include "texturedsp.h"
 
 #define RGBA(r, g, b, a) (((uint8_t)(r) <<  0) | \
@@ -654,6 +655,10 @@ av_cold void ff_texturedsp_init(TextureDSPContext *c)
     c->rgtc2s_block       = rgtc2s_block;
     c->rgtc2u_block       = rgtc2u_block;
     c->dxn3dc_block       = dxn3dc_block;
+
+#if ARCH_X86
+    ff_texturedsp_init_x86(c);
+#endif
 }
 
 #define TEXTUREDSP_FUNC_NAME ff_texturedsp_exec_decompress_threads
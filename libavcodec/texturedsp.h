@@ -88,6 +88,8 @@ typedef struct TextureDSPThreadContext {
 void ff_texturedsp_init(TextureDSPContext *c);
 void ff_texturedspenc_init(TextureDSPEncContext *c);
 
+void ff_texturedsp_init_x86(TextureDSPContext *c);
+
 struct AVCodecContext;
 int ff_texturedsp_exec_decompress_threads(struct AVCodecContext *avctx,
                                           TextureDSPThreadContext *ctx);
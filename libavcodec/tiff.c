@@ -56,6 +56,24 @@
 #include "thread.h"
 #include "get_bits.h"
 
+/**
+ * Scratch state of one strip decoder, one per slice thread.
+ */
+typedef struct TiffStripContext {
+    LZWState *lzw;
+
+    uint8_t *deinvert_buf;
+    int deinvert_buf_size;
+    uint8_t *yuv_line;
+    unsigned int yuv_line_size;
+    uint8_t *pred_buf;
+    unsigned int pred_buf_size;
+} TiffStripContext;
+
+typedef struct TiffStrip {
+    unsigned offset, size;
+} TiffStrip;
+
 typedef struct TiffContext {
     AVClass *class;
     AVCodecContext *avctx;
@@ -108,7 +126,6 @@ typedef struct TiffContext {
     int strips, rps, sstype;
     int sot;
     int stripsizesoff, stripsize, stripoff, strippos;
-    LZWState *lzw;
 
     /* Tile support */
     int is_tiled;
@@ -117,10 +134,12 @@ typedef struct TiffContext {
 
     int is_jpeg;
 
-    uint8_t *deinvert_buf;
-    int deinvert_buf_size;
-    uint8_t *yuv_line;
-    unsigned int yuv_line_size;
+    TiffStripContext *strip_ctx;        ///< per-thread strip decoding state
+    int nb_strip_ctx;
+    TiffStrip *strip_list;
+    unsigned int strip_list_size;
+    int *strip_ret;
+    unsigned int strip_ret_size;
 
     int geotag_count;
     TiffGeoTag *geotags;
@@ -439,15 +458,15 @@ static void av_always_inline horizontal_fill(TiffContext *s,
     }
 }
 
-static int deinvert_buffer(TiffContext *s, const uint8_t *src, int size)
+static int deinvert_buffer(TiffStripContext *sc, const uint8_t *src, int size)
 {
     int i;
 
-    av_fast_padded_malloc(&s->deinvert_buf, &s->deinvert_buf_size, size);
-    if (!s->deinvert_buf)
+    av_fast_padded_malloc(&sc->deinvert_buf, &sc->deinvert_buf_size, size);
+    if (!sc->deinvert_buf)
         return AVERROR(ENOMEM);
     for (i = 0; i < size; i++)
-        s->deinvert_buf[i] = ff_reverse[src[i]];
+        sc->deinvert_buf[i] = ff_reverse[src[i]];
 
     return 0;
 }
@@ -516,8 +535,8 @@ static int tiff_uncompress(uint8_t *dst, unsigned long *len, const uint8_t *src,
     return zret == Z_STREAM_END ? Z_OK : zret;
 }
 
-static int tiff_unpack_zlib(TiffContext *s, AVFrame *p, uint8_t *dst, int stride,
-                            const uint8_t *src, int size, int width, int lines,
+static int tiff_unpack_zlib(TiffContext *s, TiffStripContext *sc, AVFrame *p,
+                            uint8_t *dst, int stride, const uint8_t *src, int size, int width, int lines,
                             int strip_start, int is_yuv)
 {
     uint8_t *zbuf;
@@ -528,11 +547,11 @@ static int tiff_unpack_zlib(TiffContext *s, AVFrame *p, uint8_t *dst, int stride
     if (!zbuf)
         return AVERROR(ENOMEM);
     if (s->fill_order) {
-        if ((ret = deinvert_buffer(s, src, size)) < 0) {
+        if ((ret = deinvert_buffer(sc, src, size)) < 0) {
             av_free(zbuf);
             return ret;
         }
-        src = s->deinvert_buf;
+        src = sc->deinvert_buf;
     }
     ret = tiff_uncompress(zbuf, &outlen, src, size);
     if (ret != Z_OK) {
@@ -583,8 +602,8 @@ static int tiff_uncompress_lzma(uint8_t *dst, uint64_t *len, const uint8_t *src,
     return ret == LZMA_STREAM_END ? LZMA_OK : ret;
 }
 
-static int tiff_unpack_lzma(TiffContext *s, AVFrame *p, uint8_t *dst, int stride,
-                            const uint8_t *src, int size, int width, int lines,
+static int tiff_unpack_lzma(TiffContext *s, TiffStripContext *sc, AVFrame *p,
+                            uint8_t *dst, int stride, const uint8_t *src, int size, int width, int lines,
                             int strip_start, int is_yuv)
 {
     uint64_t outlen = width * (uint64_t)lines;
@@ -593,11 +612,11 @@ static int tiff_unpack_lzma(TiffContext *s, AVFrame *p, uint8_t *dst, int stride
     if (!buf)
         return AVERROR(ENOMEM);
     if (s->fill_order) {
-        if ((ret = deinvert_buffer(s, src, size)) < 0) {
+        if ((ret = deinvert_buffer(sc, src, size)) < 0) {
             av_free(buf);
             return ret;
         }
-        src = s->deinvert_buf;
+        src = sc->deinvert_buf;
     }
     ret = tiff_uncompress_lzma(buf, &outlen, src, size);
     if (ret != LZMA_OK) {
@@ -626,16 +645,17 @@ static int tiff_unpack_lzma(TiffContext *s, AVFrame *p, uint8_t *dst, int stride
 }
 #endif
 
-static int tiff_unpack_fax(TiffContext *s, uint8_t *dst, int stride,
+static int tiff_unpack_fax(TiffContext *s, TiffStripContext *sc,
+                           uint8_t *dst, int stride,
                            const uint8_t *src, int size, int width, int lines)
 {
     int line;
     int ret;
 
     if (s->fill_order) {
-        if ((ret = deinvert_buffer(s, src, size)) < 0)
+        if ((ret = deinvert_buffer(sc, src, size)) < 0)
             return ret;
-        src = s->deinvert_buf;
+        src = sc->deinvert_buf;
     }
     ret = ff_ccitt_unpack(s->avctx, src, size, dst, lines, stride,
                           s->compr, s->fax_opts);
@@ -737,9 +757,11 @@ static int dng_decode_jpeg(AVCodecContext *avctx, AVFrame *frame,
     return 0;
 }
 
-static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int stride,
+static int tiff_unpack_strip(TiffContext *s, TiffStripContext *sc, AVFrame *p,
+                             uint8_t *dst, int stride,
                              const uint8_t *src, int size, int strip_start, int lines)
 {
+    GetByteContext gb;
     PutByteContext pb;
     int c, line, pixels, code, ret;
     const uint8_t *ssrc = src;
@@ -759,12 +781,12 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
     if (is_yuv) {
         int bytes_per_row = (((s->width - 1) / s->subsampling[0] + 1) * s->bpp *
                             s->subsampling[0] * s->subsampling[1] + 7) >> 3;
-        av_fast_padded_malloc(&s->yuv_line, &s->yuv_line_size, bytes_per_row);
-        if (s->yuv_line == NULL) {
+        av_fast_padded_malloc(&sc->yuv_line, &sc->yuv_line_size, bytes_per_row);
+        if (sc->yuv_line == NULL) {
             av_log(s->avctx, AV_LOG_ERROR, "Not enough memory\n");
             return AVERROR(ENOMEM);
         }
-        dst = s->yuv_line;
+        dst = sc->yuv_line;
         stride = 0;
 
         width = (s->width - 1) / s->subsampling[0] + 1;
@@ -777,18 +799,18 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
     }
     av_assert0(!(s->is_bayer && is_yuv));
     if (p->format == AV_PIX_FMT_GRAY12) {
-        av_fast_padded_malloc(&s->yuv_line, &s->yuv_line_size, width);
-        if (s->yuv_line == NULL) {
+        av_fast_padded_malloc(&sc->yuv_line, &sc->yuv_line_size, width);
+        if (sc->yuv_line == NULL) {
             av_log(s->avctx, AV_LOG_ERROR, "Not enough memory\n");
             return AVERROR(ENOMEM);
         }
-        dst = s->yuv_line;
+        dst = sc->yuv_line;
         stride = 0;
     }
 
     if (s->compr == TIFF_DEFLATE || s->compr == TIFF_ADOBE_DEFLATE) {
 #if CONFIG_ZLIB
-        return tiff_unpack_zlib(s, p, dst, stride, src, size, width, lines,
+        return tiff_unpack_zlib(s, sc, p, dst, stride, src, size, width, lines,
                                 strip_start, is_yuv);
 #else
         av_log(s->avctx, AV_LOG_ERROR,
@@ -799,7 +821,7 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
     }
     if (s->compr == TIFF_LZMA) {
 #if CONFIG_LZMA
-        return tiff_unpack_lzma(s, p, dst, stride, src, size, width, lines,
+        return tiff_unpack_lzma(s, sc, p, dst, stride, src, size, width, lines,
                                 strip_start, is_yuv);
 #else
         av_log(s->avctx, AV_LOG_ERROR,
@@ -809,19 +831,19 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
     }
     if (s->compr == TIFF_LZW) {
         if (s->fill_order) {
-            if ((ret = deinvert_buffer(s, src, size)) < 0)
+            if ((ret = deinvert_buffer(sc, src, size)) < 0)
                 return ret;
-            ssrc = src = s->deinvert_buf;
+            ssrc = src = sc->deinvert_buf;
         }
         if (size > 1 && !src[0] && (src[1]&1)) {
             av_log(s->avctx, AV_LOG_ERROR, "Old style LZW is unsupported\n");
         }
-        if ((ret = ff_lzw_decode_init(s->lzw, 8, src, size, FF_LZW_TIFF)) < 0) {
+        if ((ret = ff_lzw_decode_init(sc->lzw, 8, src, size, FF_LZW_TIFF)) < 0) {
             av_log(s->avctx, AV_LOG_ERROR, "Error initializing LZW decoder\n");
             return ret;
         }
         for (line = 0; line < lines; line++) {
-            pixels = ff_lzw_decode(s->lzw, dst, width);
+            pixels = ff_lzw_decode(sc->lzw, dst, width);
             if (pixels < width) {
                 av_log(s->avctx, AV_LOG_ERROR, "Decoded only %i bytes of %i\n",
                        pixels, width);
@@ -845,11 +867,11 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
         if (is_yuv || p->format == AV_PIX_FMT_GRAY12)
             return AVERROR_INVALIDDATA;
 
-        return tiff_unpack_fax(s, dst, stride, src, size, width, lines);
+        return tiff_unpack_fax(s, sc, dst, stride, src, size, width, lines);
     }
 
-    bytestream2_init(&s->gb, src, size);
-    bytestream2_init_writer(&pb, dst, is_yuv ? s->yuv_line_size : (stride * lines));
+    bytestream2_init(&gb, src, size);
+    bytestream2_init_writer(&pb, dst, is_yuv ? sc->yuv_line_size : (stride * lines));
 
     is_dng = (s->tiff_type == TIFF_TYPE_DNG || s->tiff_type == TIFF_TYPE_CINEMADNG);
 
@@ -861,6 +883,7 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
         }
         if (!s->is_bayer)
             return AVERROR_PATCHWELCOME;
+        bytestream2_init(&s->gb, src, size);
         if ((ret = dng_decode_jpeg(s->avctx, p, s->stripsize, 0, 0, s->width, s->height)) < 0)
             return ret;
         return 0;
@@ -875,7 +898,7 @@ static int tiff_unpack_strip(TiffContext *s, AVFrame *p, uint8_t *dst, int strid
             return AVERROR_INVALIDDATA;
         }
 
-        if (bytestream2_get_bytes_left(&s->gb) == 0 || bytestream2_get_eof(&pb))
+        if (bytestream2_get_bytes_left(&gb) == 0 || bytestream2_get_eof(&pb))
             break;
         bytestream2_seek_p(&pb, stride * line, SEEK_SET);
         switch (s->compr) {
@@ -1922,6 +1945,146 @@ static void camera_xyz_coeff(TiffContext *s,
     }
 }
 
+/* Undo the horizontal predictor on the decoded lines of one strip. */
+static int tiff_predict(TiffContext *s, TiffStripContext *sc,
+                        uint8_t *dst, int stride, int lines)
+{
+    int i, j, soff, ssize;
+
+    if (s->predictor == 2) {
+        soff  = s->bpp >> 3;
+        if (s->planar)
+            soff  = FFMAX(soff / s->bppcount, 1);
+        ssize = s->width * soff;
+        if (s->avctx->pix_fmt == AV_PIX_FMT_RGB48LE ||
+            s->avctx->pix_fmt == AV_PIX_FMT_RGBA64LE ||
+            s->avctx->pix_fmt == AV_PIX_FMT_GRAY16LE ||
+            s->avctx->pix_fmt == AV_PIX_FMT_YA16LE ||
+            s->avctx->pix_fmt == AV_PIX_FMT_GBRP16LE ||
+            s->avctx->pix_fmt == AV_PIX_FMT_GBRAP16LE) {
+            for (i = 0; i < lines; i++) {
+                for (j = soff; j < ssize; j += 2)
+                    AV_WL16(dst + j, AV_RL16(dst + j) + AV_RL16(dst + j - soff));
+                dst += stride;
+            }
+        } else if (s->avctx->pix_fmt == AV_PIX_FMT_RGB48BE ||
+                   s->avctx->pix_fmt == AV_PIX_FMT_RGBA64BE ||
+                   s->avctx->pix_fmt == AV_PIX_FMT_GRAY16BE ||
+                   s->avctx->pix_fmt == AV_PIX_FMT_YA16BE ||
+                   s->avctx->pix_fmt == AV_PIX_FMT_GBRP16BE ||
+                   s->avctx->pix_fmt == AV_PIX_FMT_GBRAP16BE) {
+            for (i = 0; i < lines; i++) {
+                for (j = soff; j < ssize; j += 2)
+                    AV_WB16(dst + j, AV_RB16(dst + j) + AV_RB16(dst + j - soff));
+                dst += stride;
+            }
+        } else {
+            for (i = 0; i < lines; i++) {
+                for (j = soff; j < ssize; j++)
+                    dst[j] += dst[j - soff];
+                dst += stride;
+            }
+        }
+    }
+
+    /* Floating point predictor
+       TIFF Technical Note 3 http://chriscox.org/TIFFTN3d1.pdf */
+    if (s->predictor == 3) {
+        int channels = s->bppcount;
+        int group_size;
+        uint8_t *tmpbuf;
+        int bpc;
+
+        soff  = s->bpp >> 3;
+        if (s->planar) {
+            soff  = FFMAX(soff / s->bppcount, 1);
+            channels = 1;
+        }
+        ssize = s->width * soff;
+        bpc = FFMAX(soff / s->bppcount, 1); /* Bytes per component */
+        group_size = s->width * channels;
+
+        av_fast_malloc(&sc->pred_buf, &sc->pred_buf_size, ssize);
+        if (!sc->pred_buf)
+            return AVERROR(ENOMEM);
+        tmpbuf = sc->pred_buf;
+
+        if (s->avctx->pix_fmt == AV_PIX_FMT_RGBF32LE ||
+            s->avctx->pix_fmt == AV_PIX_FMT_RGBAF32LE) {
+            for (i = 0; i < lines; i++) {
+                /* Copy first sample byte for each channel */
+                for (j = 0; j < channels; j++)
+                    tmpbuf[j] = dst[j];
+
+                /* Decode horizontal differences */
+                for (j = channels; j < ssize; j++)
+                    tmpbuf[j] = dst[j] + tmpbuf[j-channels];
+
+                /* Combine shuffled bytes from their separate groups. Each
+                   byte of every floating point value in a row of pixels is
+                   split and combined into separate groups. A group of all
+                   the sign/exponents bytes in the row and groups for each
+                   of the upper, mid, and lower mantissa bytes in the row. */
+                for (j = 0; j < group_size; j++) {
+                    for (int k = 0; k < bpc; k++) {
+                        dst[bpc * j + k] = tmpbuf[(bpc - k - 1) * group_size + j];
+                    }
+                }
+                dst += stride;
+            }
+        } else if (s->avctx->pix_fmt == AV_PIX_FMT_RGBF32BE ||
+                   s->avctx->pix_fmt == AV_PIX_FMT_RGBAF32BE) {
+            /* Same as LE only the shuffle at the end is reversed */
+            for (i = 0; i < lines; i++) {
+                for (j = 0; j < channels; j++)
+                    tmpbuf[j] = dst[j];
+
+                for (j = channels; j < ssize; j++)
+                    tmpbuf[j] = dst[j] + tmpbuf[j-channels];
+
+                for (j = 0; j < group_size; j++) {
+                    for (int k = 0; k < bpc; k++) {
+                        dst[bpc * j + k] = tmpbuf[k * group_size + j];
+                    }
+                }
+                dst += stride;
+            }
+        }
+    }
+    return 0;
+}
+
+typedef struct TiffStripJob {
+    AVFrame *p;
+    uint8_t *dst;           ///< first line of the plane
+    int stride;
+    const uint8_t *data;    ///< packet data the strip offsets refer to
+    int predict;
+} TiffStripJob;
+
+static int decode_strip_thread(AVCodecContext *avctx, void *arg,
+                               int jobnr, int threadnr)
+{
+    TiffContext *s = avctx->priv_data;
+    const TiffStripJob *job = arg;
+    TiffStripContext *sc = &s->strip_ctx[threadnr];
+    const TiffStrip *strip = &s->strip_list[jobnr];
+    int strip_start = jobnr * s->rps;
+    int lines = FFMIN(s->rps, s->height - strip_start);
+    uint8_t *dst = job->dst + (ptrdiff_t)strip_start * job->stride;
+    int ret;
+
+    ret = tiff_unpack_strip(s, sc, job->p, dst, job->stride,
+                            job->data + strip->offset, strip->size,
+                            strip_start, lines);
+    if (ret < 0)
+        return ret;
+
+    if (job->predict)
+        return tiff_predict(s, sc, dst, job->stride, lines);
+    return 0;
+}
+
 static int decode_frame(AVCodecContext *avctx, AVFrame *p,
                         int *got_frame, AVPacket *avpkt)
 {
@@ -1936,6 +2099,7 @@ static int decode_frame(AVCodecContext *avctx, AVFrame *p,
     int retry_for_subifd, retry_for_page;
     int is_dng;
     int has_tile_bits, has_strip_bits;
+    int predict;
 
     bytestream2_init(&s->gb, avpkt->data, avpkt->size);
 
@@ -2181,11 +2345,26 @@ again:
 
     /* Handle TIFF images and DNG images with uncompressed strips (non-tiled) */
 
+    if (s->predictor == 2 && s->photometric == TIFF_PHOTOMETRIC_YCBCR) {
+        av_log(s->avctx, AV_LOG_ERROR, "predictor == 2 with YUV is unsupported");
+        return AVERROR_PATCHWELCOME;
+    }
+    predict = s->predictor == 2;
+    if (s->predictor == 3) {
+        predict = s->avctx->pix_fmt == AV_PIX_FMT_RGBF32LE  ||
+                  s->avctx->pix_fmt == AV_PIX_FMT_RGBAF32LE ||
+                  s->avctx->pix_fmt == AV_PIX_FMT_RGBF32BE  ||
+                  s->avctx->pix_fmt == AV_PIX_FMT_RGBAF32BE;
+        if (!predict)
+            av_log(s->avctx, AV_LOG_ERROR, "unsupported floating point pixel format\n");
+    }
+
     planes = s->planar ? s->bppcount : 1;
     for (plane = 0; plane < planes; plane++) {
         uint8_t *five_planes = NULL;
         int remaining = avpkt->size;
-        int decoded_height;
+        int nb_strips, invalid_strip = 0;
+        TiffStripJob job;
         stride = p->linesize[plane];
         dst = p->data[plane];
         if (s->photometric == TIFF_PHOTOMETRIC_SEPARATED &&
@@ -2196,9 +2375,9 @@ again:
             if (!dst)
                 return AVERROR(ENOMEM);
         }
-        for (i = 0; i < s->height; i += s->rps) {
-            if (i)
-                dst += s->rps * stride;
+        for (i = 0, nb_strips = 0; i < s->height; i += s->rps, nb_strips++) {
+            TiffStrip *strips;
+
             if (s->stripsizesoff)
                 ssize = ff_tget(&stripsizes, s->sstype, le);
             else
@@ -2209,132 +2388,57 @@ again:
             else
                 soff = s->stripoff;
 
+            /* only fatal if all previous strips decode */
             if (soff > avpkt->size || ssize > avpkt->size - soff || ssize > remaining) {
-                av_log(avctx, AV_LOG_ERROR, "Invalid strip size/offset\n");
-                av_freep(&five_planes);
-                return AVERROR_INVALIDDATA;
-            }
-            remaining -= ssize;
-            if ((ret = tiff_unpack_strip(s, p, dst, stride, avpkt->data + soff, ssize, i,
-                                         FFMIN(s->rps, s->height - i))) < 0) {
-                if (avctx->err_recognition & AV_EF_EXPLODE) {
-                    av_freep(&five_planes);
-                    return ret;
-                }
+                invalid_strip = 1;
                 break;
             }
-        }
-        decoded_height = FFMIN(i, s->height);
+            remaining -= ssize;
 
-        if (s->predictor == 2) {
-            if (s->photometric == TIFF_PHOTOMETRIC_YCBCR) {
-                av_log(s->avctx, AV_LOG_ERROR, "predictor == 2 with YUV is unsupported");
-                return AVERROR_PATCHWELCOME;
-            }
-            dst   = five_planes ? five_planes : p->data[plane];
-            soff  = s->bpp >> 3;
-            if (s->planar)
-                soff  = FFMAX(soff / s->bppcount, 1);
-            ssize = s->width * soff;
-            if (s->avctx->pix_fmt == AV_PIX_FMT_RGB48LE ||
-                s->avctx->pix_fmt == AV_PIX_FMT_RGBA64LE ||
-                s->avctx->pix_fmt == AV_PIX_FMT_GRAY16LE ||
-                s->avctx->pix_fmt == AV_PIX_FMT_YA16LE ||
-                s->avctx->pix_fmt == AV_PIX_FMT_GBRP16LE ||
-                s->avctx->pix_fmt == AV_PIX_FMT_GBRAP16LE) {
-                for (i = 0; i < decoded_height; i++) {
-                    for (j = soff; j < ssize; j += 2)
-                        AV_WL16(dst + j, AV_RL16(dst + j) + AV_RL16(dst + j - soff));
-                    dst += stride;
-                }
-            } else if (s->avctx->pix_fmt == AV_PIX_FMT_RGB48BE ||
-                       s->avctx->pix_fmt == AV_PIX_FMT_RGBA64BE ||
-                       s->avctx->pix_fmt == AV_PIX_FMT_GRAY16BE ||
-                       s->avctx->pix_fmt == AV_PIX_FMT_YA16BE ||
-                       s->avctx->pix_fmt == AV_PIX_FMT_GBRP16BE ||
-                       s->avctx->pix_fmt == AV_PIX_FMT_GBRAP16BE) {
-                for (i = 0; i < decoded_height; i++) {
-                    for (j = soff; j < ssize; j += 2)
-                        AV_WB16(dst + j, AV_RB16(dst + j) + AV_RB16(dst + j - soff));
-                    dst += stride;
-                }
-            } else {
-                for (i = 0; i < decoded_height; i++) {
-                    for (j = soff; j < ssize; j++)
-                        dst[j] += dst[j - soff];
-                    dst += stride;
-                }
+            strips = av_fast_realloc(s->strip_list, &s->strip_list_size,
+                                     (nb_strips + 1) * sizeof(*strips));
+            if (!strips) {
+                av_freep(&five_planes);
+                return AVERROR(ENOMEM);
             }
+            s->strip_list = strips;
+            strips[nb_strips] = (TiffStrip){ .offset = soff, .size = ssize };
         }
 
-        /* Floating point predictor
-           TIFF Technical Note 3 http://chriscox.org/TIFFTN3d1.pdf */
-        if (s->predictor == 3) {
-            int channels = s->bppcount;
-            int group_size;
-            uint8_t *tmpbuf;
-            int bpc;
-
-            dst   = five_planes ? five_planes : p->data[plane];
-            soff  = s->bpp >> 3;
-            if (s->planar) {
-                soff  = FFMAX(soff / s->bppcount, 1);
-                channels = 1;
-            }
-            ssize = s->width * soff;
-            bpc = FFMAX(soff / s->bppcount, 1); /* Bytes per component */
-            group_size = s->width * channels;
+        av_fast_malloc(&s->strip_ret, &s->strip_ret_size, FFMAX(nb_strips, 1) * sizeof(*s->strip_ret));
+        if (!s->strip_ret) {
+            av_freep(&five_planes);
+            return AVERROR(ENOMEM);
+        }
 
-            tmpbuf = av_malloc(ssize);
-            if (!tmpbuf) {
-                av_free(five_planes);
-                return AVERROR(ENOMEM);
-            }
+        job = (TiffStripJob) {
+            .p       = p,
+            .dst     = dst,
+            .stride  = stride,
+            .data    = avpkt->data,
+            .predict = predict,
+        };
+        if (is_dng && s->compr == TIFF_NEWJPEG) {
+            /* all jobs share the MJPEG decoder context, run them in order */
+            for (i = 0; i < nb_strips; i++)
+                s->strip_ret[i] = decode_strip_thread(avctx, &job, i, 0);
+        } else
+            avctx->execute2(avctx, decode_strip_thread, &job, s->strip_ret, nb_strips);
 
-            if (s->avctx->pix_fmt == AV_PIX_FMT_RGBF32LE ||
-                s->avctx->pix_fmt == AV_PIX_FMT_RGBAF32LE) {
-                for (i = 0; i < decoded_height; i++) {
-                    /* Copy first sample byte for each channel */
-                    for (j = 0; j < channels; j++)
-                        tmpbuf[j] = dst[j];
-
-                    /* Decode horizontal differences */
-                    for (j = channels; j < ssize; j++)
-                        tmpbuf[j] = dst[j] + tmpbuf[j-channels];
-
-                    /* Combine shuffled bytes from their separate groups. Each
-                       byte of every floating point value in a row of pixels is
-                       split and combined into separate groups. A group of all
-                       the sign/exponents bytes in the row and groups for each
-                       of the upper, mid, and lower mantissa bytes in the row. */
-                    for (j = 0; j < group_size; j++) {
-                        for (int k = 0; k < bpc; k++) {
-                            dst[bpc * j + k] = tmpbuf[(bpc - k - 1) * group_size + j];
-                        }
-                    }
-                    dst += stride;
-                }
-            } else if (s->avctx->pix_fmt == AV_PIX_FMT_RGBF32BE ||
-                       s->avctx->pix_fmt == AV_PIX_FMT_RGBAF32BE) {
-                /* Same as LE only the shuffle at the end is reversed */
-                for (i = 0; i < decoded_height; i++) {
-                    for (j = 0; j < channels; j++)
-                        tmpbuf[j] = dst[j];
-
-                    for (j = channels; j < ssize; j++)
-                        tmpbuf[j] = dst[j] + tmpbuf[j-channels];
-
-                    for (j = 0; j < group_size; j++) {
-                        for (int k = 0; k < bpc; k++) {
-                            dst[bpc * j + k] = tmpbuf[k * group_size + j];
-                        }
-                    }
-                    dst += stride;
-                }
-            } else {
-                av_log(s->avctx, AV_LOG_ERROR, "unsupported floating point pixel format\n");
+        for (i = 0; i < nb_strips; i++) {
+            ret = s->strip_ret[i];
+            if (ret < 0 &&
+                (ret == AVERROR(ENOMEM) || avctx->err_recognition & AV_EF_EXPLODE)) {
+                av_freep(&five_planes);
+                return ret;
             }
-            av_free(tmpbuf);
+            if (ret < 0)
+                break;
+        }
+        if (i == nb_strips && invalid_strip) {
+            av_log(avctx, AV_LOG_ERROR, "Invalid strip size/offset\n");
+            av_freep(&five_planes);
+            return AVERROR_INVALIDDATA;
         }
 
         if (s->photometric == TIFF_PHOTOMETRIC_WHITE_IS_ZERO) {
@@ -2417,9 +2521,17 @@ static av_cold int tiff_init(AVCodecContext *avctx)
     s->subsampling[0] =
     s->subsampling[1] = 1;
     s->avctx  = avctx;
-    ff_lzw_decode_open(&s->lzw);
-    if (!s->lzw)
+
+    s->strip_ctx = av_calloc(avctx->active_thread_type & FF_THREAD_SLICE ? avctx->thread_count : 1,
+                             sizeof(*s->strip_ctx));
+    if (!s->strip_ctx)
         return AVERROR(ENOMEM);
+    s->nb_strip_ctx = avctx->active_thread_type & FF_THREAD_SLICE ? avctx->thread_count : 1;
+    for (int i = 0; i < s->nb_strip_ctx; i++) {
+        ff_lzw_decode_open(&s->strip_ctx[i].lzw);
+        if (!s->strip_ctx[i].lzw)
+            return AVERROR(ENOMEM);
+    }
     ff_ccitt_unpack_init();
 
     /* Allocate JPEG frame */
@@ -2451,11 +2563,18 @@ static av_cold int tiff_end(AVCodecContext *avctx)
 
     free_geotags(s);
 
-    ff_lzw_decode_close(&s->lzw);
-    av_freep(&s->deinvert_buf);
-    s->deinvert_buf_size = 0;
-    av_freep(&s->yuv_line);
-    s->yuv_line_size = 0;
+    for (int i = 0; i < s->nb_strip_ctx; i++) {
+        TiffStripContext *sc = &s->strip_ctx[i];
+
+        ff_lzw_decode_close(&sc->lzw);
+        av_freep(&sc->deinvert_buf);
+        av_freep(&sc->yuv_line);
+        av_freep(&sc->pred_buf);
+    }
+    av_freep(&s->strip_ctx);
+    s->nb_strip_ctx = 0;
+    av_freep(&s->strip_list);
+    av_freep(&s->strip_ret);
     av_frame_free(&s->jpgframe);
     av_packet_free(&s->jpkt);
     avcodec_free_context(&s->avctx_mjpeg);
@@ -2486,7 +2605,8 @@ const FFCodec ff_tiff_decoder = {
     .init           = tiff_init,
     .close          = tiff_end,
     FF_CODEC_DECODE_CB(decode_frame),
-    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP | FF_CODEC_CAP_ICC_PROFILES |
                       FF_CODEC_CAP_SKIP_FRAME_FILL_PARAM,
     .p.priv_class   = &tiff_decoder_class,
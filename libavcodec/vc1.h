@@ -23,10 +23,12 @@
 #ifndef AVCODEC_VC1_H
 #define AVCODEC_VC1_H
 
+#include "config.h"
 #include "avcodec.h"
 #include "h264chroma.h"
 #include "mpegvideo.h"
 #include "intrax8.h"
+#include "threadprogress.h"
 #include "vc1_common.h"
 #include "vc1dsp.h"
 
@@ -404,6 +406,19 @@ typedef struct VC1Context{
     int resync_marker;           ///< could this stream contain resync markers
 } VC1Context;
 
+/**
+ * Wait until the reference picture has been decoded far enough to read its
+ * luma line y when decoding with frame threads. Only progressive pictures wait
+ * for single rows, interlaced ones wait for the whole reference.
+ */
+static av_always_inline void ff_vc1_await_ref(const VC1Context *v,
+                                              const MPVWorkPicture *ref, int y)
+{
+    if (HAVE_THREADS && v->s.avctx->active_thread_type & FF_THREAD_FRAME && ref->ptr)
+        ff_thread_progress_await(&ref->ptr->progress,
+                                 v->fcm == PROGRESSIVE ? y >> 4 : INT_MAX);
+}
+
 /**
  * Decode Simple/Main Profiles sequence header
  * @see Figure 7-8, p16-17
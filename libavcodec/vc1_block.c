@@ -74,6 +74,18 @@ static inline void update_block_index(MpegEncContext *s)
 
 /** @} */ //Bitplane group
 
+/** Report the rows of the current picture that are final to frame threads
+ * waiting on it. The delayed block output and the overlap and loop filters
+ * still modify pixels up to two MB rows above the current one.
+ */
+static inline void vc1_report_decode_progress(VC1Context *v)
+{
+    MpegEncContext *s = &v->s;
+
+    if (!v->field_mode && s->pict_type != AV_PICTURE_TYPE_B && !s->er.error_occurred)
+        ff_thread_progress_report(&s->cur_pic.ptr->progress, s->mb_y - 3);
+}
+
 static void vc1_put_blocks_clamped(VC1Context *v, int put_signed)
 {
     MpegEncContext *s = &v->s;
@@ -2256,6 +2268,7 @@ static int vc1_decode_b_mb_intfr(VC1Context *v)
         if (direct) {
             if (s->next_pic.ptr->field_picture)
                 av_log(s->avctx, AV_LOG_WARNING, "Mixed frame/field direct mode not supported\n");
+            ff_vc1_await_ref(v, &s->next_pic, INT_MAX);
             s->mv[0][0][0] = s->cur_pic.motion_val[0][s->block_index[0]][0] = scale_mv(s->next_pic.motion_val[1][s->block_index[0]][0], v->bfraction, 0, s->quarter_sample);
             s->mv[0][0][1] = s->cur_pic.motion_val[0][s->block_index[0]][1] = scale_mv(s->next_pic.motion_val[1][s->block_index[0]][1], v->bfraction, 0, s->quarter_sample);
             s->mv[1][0][0] = s->cur_pic.motion_val[1][s->block_index[0]][0] = scale_mv(s->next_pic.motion_val[1][s->block_index[0]][0], v->bfraction, 1, s->quarter_sample);
@@ -2612,6 +2625,7 @@ static void vc1_decode_i_blocks(VC1Context *v)
         }
 
         s->first_slice_line = 0;
+        vc1_report_decode_progress(v);
     }
 
     /* This is intentionally mb_height and not end_mb_y - unlike in advanced
@@ -2749,6 +2763,7 @@ static int vc1_decode_i_blocks_adv(VC1Context *v)
             inc_blk_idx(v->cur_blk_idx);
         }
         s->first_slice_line = 0;
+        vc1_report_decode_progress(v);
     }
 
     ff_er_add_slice(&s->er, 0, s->start_mb_y << v->field_mode, s->mb_width - 1,
@@ -2840,6 +2855,7 @@ static void vc1_decode_p_blocks(VC1Context *v)
                 v->luma_mv - s->mb_stride,
                 sizeof(v->luma_mv_base[0]) * 2 * s->mb_stride);
         s->first_slice_line = 0;
+        vc1_report_decode_progress(v);
     }
     ff_er_add_slice(&s->er, 0, s->start_mb_y << v->field_mode, s->mb_width - 1,
                     (s->end_mb_y << v->field_mode) - 1, ER_MB_END);
@@ -2936,10 +2952,12 @@ static void vc1_decode_skip_blocks(VC1Context *v)
         s->mb_x = 0;
         init_block_index(v);
         update_block_index(s);
+        ff_vc1_await_ref(v, &s->last_pic, s->mb_y * 16 + 15);
         memcpy(s->dest[0], s->last_pic.data[0] + s->mb_y * 16 * s->linesize,   s->linesize   * 16);
         memcpy(s->dest[1], s->last_pic.data[1] + s->mb_y *  8 * s->uvlinesize, s->uvlinesize *  8);
         memcpy(s->dest[2], s->last_pic.data[2] + s->mb_y *  8 * s->uvlinesize, s->uvlinesize *  8);
         s->first_slice_line = 0;
+        vc1_report_decode_progress(v);
     }
 }
 
@@ -272,6 +272,9 @@ void ff_vc1_mc_1mv(VC1Context *v, int dir)
         }
     }
 
+    ff_vc1_await_ref(v, dir ? &s->next_pic : &s->last_pic,
+                     FFMAX(src_y + 19, 2 * uvsrc_y + 19));
+
     srcY += src_y   * s->linesize   + src_x;
     srcU += uvsrc_y * s->uvlinesize + uvsrc_x;
     srcV += uvsrc_y * s->uvlinesize + uvsrc_x;
@@ -553,6 +556,8 @@ void ff_vc1_mc_4mv_luma(VC1Context *v, int n, int dir, int avg)
             src_y = av_clip(src_y, -18, s->avctx->coded_height + 1);
     }
 
+    ff_vc1_await_ref(v, dir ? &s->next_pic : &s->last_pic, src_y + 11);
+
     srcY += src_y * s->linesize + src_x;
     if (v->field_mode && v->ref_field_type[dir])
         srcY += linesize;
@@ -696,6 +701,8 @@ void ff_vc1_mc_4mv_chroma(VC1Context *v, int dir)
         uvsrc_y = av_clip(uvsrc_y, -8, s->avctx->coded_height >> 1);
     }
 
+    ff_vc1_await_ref(v, dir ? &s->next_pic : &s->last_pic, 2 * uvsrc_y + 19);
+
     if (!dir) {
         if (v->field_mode && (v->cur_field_type != chroma_ref_type) && v->second_field) {
             srcU = s->cur_pic.data[1];
@@ -879,6 +886,8 @@ void ff_vc1_mc_4mv_chroma4(VC1Context *v, int dir, int dir2, int avg)
             uvsrc_y = av_clip(uvsrc_y, -8 + (uvsrc_y & 1), (s->avctx->coded_height >> 1) + (uvsrc_y & 1));
         else
             uvsrc_y = av_clip(uvsrc_y, -8, s->avctx->coded_height >> 1);
+        ff_vc1_await_ref(v, (i < 2 ? dir : dir2) ? &s->next_pic : &s->last_pic,
+                         2 * uvsrc_y + 11);
         if (i < 2 ? dir : dir2) {
             srcU = s->next_pic.data[1];
             srcV = s->next_pic.data[2];
@@ -1056,6 +1065,8 @@ void ff_vc1_interp_mc(VC1Context *v)
         }
     }
 
+    ff_vc1_await_ref(v, &s->next_pic, FFMAX(src_y + 19, 2 * uvsrc_y + 19));
+
     srcY += src_y   * s->linesize   + src_x;
     srcU += uvsrc_y * s->uvlinesize + uvsrc_x;
     srcV += uvsrc_y * s->uvlinesize + uvsrc_x;
@@ -722,6 +722,7 @@ void ff_vc1_pred_b_mv(VC1Context *v, int dmv_x[2], int dmv_y[2],
     if (direct && s->next_pic.ptr->field_picture)
         av_log(s->avctx, AV_LOG_WARNING, "Mixed frame/field direct mode not supported\n");
 
+    ff_vc1_await_ref(v, &s->next_pic, s->mb_y * 16 + 15);
     s->mv[0][0][0] = scale_mv(s->next_pic.motion_val[1][xy][0], v->bfraction, 0, s->quarter_sample);
     s->mv[0][0][1] = scale_mv(s->next_pic.motion_val[1][xy][1], v->bfraction, 0, s->quarter_sample);
     s->mv[1][0][0] = scale_mv(s->next_pic.motion_val[1][xy][0], v->bfraction, 1, s->quarter_sample);
@@ -895,6 +896,7 @@ void ff_vc1_pred_b_mv_intfi(VC1Context *v, int n, int *dmv_x, int *dmv_y,
 
     if (v->bmvtype == BMV_TYPE_DIRECT) {
         int total_opp, k, f;
+        ff_vc1_await_ref(v, &s->next_pic, INT_MAX);
         if (s->next_pic.mb_type[mb_pos + v->mb_off] != MB_TYPE_INTRA) {
             s->mv[0][0][0] = scale_mv(s->next_pic.motion_val[1][s->block_index[0] + v->blocks_off][0],
                                       v->bfraction, 0, s->quarter_sample);
@@ -42,6 +42,8 @@
 #include "msmpeg4_vc1_data.h"
 #include "profiles.h"
 #include "simple_idct.h"
+#include "thread.h"
+#include "threadprogress.h"
 #include "vc1.h"
 #include "vc1data.h"
 #include "vc1_vlc_data.h"
@@ -769,7 +771,11 @@ static av_cold int vc1_decode_init(AVCodecContext *avctx)
             return AVERROR_PATCHWELCOME;
         }
     }
-    return 0;
+
+    /* The rest of the MpegEncContext is only set up once the first frame
+     * size is known, but the picture pool has to be shared between frame
+     * threads from the start. */
+    return ff_mpv_decode_init(s, avctx);
 }
 
 static av_cold void vc1_decode_reset(AVCodecContext *avctx)
@@ -810,6 +816,82 @@ av_cold int ff_vc1_decode_end(AVCodecContext *avctx)
     return ff_mpv_decode_close(avctx);
 }
 
+#if HAVE_THREADS
+static int vc1_update_thread_context(AVCodecContext *dst,
+                                     const AVCodecContext *src)
+{
+    VC1Context *const v        = dst->priv_data;
+    const VC1Context *const v1 = src->priv_data;
+    MpegEncContext *const s        = &v->s;
+    const MpegEncContext *const s1 = &v1->s;
+    int initialized, ret;
+
+    if (dst == src)
+        return 0;
+
+    /* drop the old tables if the size changed, they are reallocated below */
+    if (s->context_initialized &&
+        (!s1->context_initialized ||
+         s->width != s1->width || s->height != s1->height))
+        vc1_decode_reset(dst);
+    initialized = s->context_initialized;
+
+    ret = ff_mpeg_update_thread_context(dst, src);
+    if (ret < 0)
+        return ret;
+    if (!s1->context_initialized)
+        return 0;
+
+    if (!initialized) {
+        ret = vc1_decode_init_alloc_tables(v);
+        if (ret < 0) {
+            vc1_decode_reset(dst);
+            return ret;
+        }
+    }
+
+    s->h_edge_pos  = s1->h_edge_pos;
+    s->v_edge_pos  = s1->v_edge_pos;
+    s->loop_filter = s1->loop_filter;
+
+    /* entry point header */
+    v->broken_link      = v1->broken_link;
+    v->closed_entry     = v1->closed_entry;
+    v->panscanflag      = v1->panscanflag;
+    v->refdist_flag     = v1->refdist_flag;
+    v->fastuvmc         = v1->fastuvmc;
+    v->extended_mv      = v1->extended_mv;
+    v->extended_dmv     = v1->extended_dmv;
+    v->dquant           = v1->dquant;
+    v->vstransform      = v1->vstransform;
+    v->overlap          = v1->overlap;
+    v->quantizer_mode   = v1->quantizer_mode;
+    v->range_mapy_flag  = v1->range_mapy_flag;
+    v->range_mapy       = v1->range_mapy;
+    v->range_mapuv_flag = v1->range_mapuv_flag;
+    v->range_mapuv      = v1->range_mapuv;
+
+    /* state of the last anchor picture used by the following ones */
+    v->refdist     = v1->refdist;
+    v->rnd         = v1->rnd;
+    v->qs_last     = v1->qs_last;
+    v->last_use_ic = v1->last_use_ic;
+    v->next_use_ic = v1->next_use_ic;
+    memcpy(v->last_luty,  v1->last_luty,  sizeof(v->last_luty));
+    memcpy(v->last_lutuv, v1->last_lutuv, sizeof(v->last_lutuv));
+    memcpy(v->next_luty,  v1->next_luty,  sizeof(v->next_luty));
+    memcpy(v->next_lutuv, v1->next_lutuv, sizeof(v->next_lutuv));
+
+    /* field MV types of the last field-coded anchor, for B-field direct
+     * prediction; both halves are allocated together and may be swapped
+     * with mv_f, so copy from wherever the first one points to */
+    memcpy(v->mv_f_next[0] - s->b8_stride - 1, v1->mv_f_next[0] - s1->b8_stride - 1,
+           2 * (v->mv_f_next[1] - v->mv_f_next[0]));
+
+    return 0;
+}
+#endif
+
 /** Decode a VC1/WMV3 frame
  * @todo TODO: Handle VC-1 IDUs (Transport level?)
  */
@@ -822,7 +904,7 @@ static int vc1_decode_frame(AVCodecContext *avctx, AVFrame *pict,
     MpegEncContext *s = &v->s;
     uint8_t *buf2 = NULL;
     const uint8_t *buf_start = buf, *buf_start_second_field = NULL;
-    int mb_height, n_slices1=-1;
+    int mb_height, n_slices1=-1, frame_started = 0;
     struct {
         uint8_t *buf;
         GetBitContext gb;
@@ -1063,6 +1145,7 @@ static int vc1_decode_frame(AVCodecContext *avctx, AVFrame *pict,
     if ((ret = ff_mpv_frame_start(s, avctx)) < 0) {
         goto err;
     }
+    frame_started = 1;
 
     v->s.cur_pic.ptr->field_picture = v->field_mode;
     v->s.cur_pic.ptr->f->flags |= AV_FRAME_FLAG_INTERLACED * (v->fcm != PROGRESSIVE);
@@ -1081,6 +1164,12 @@ static int vc1_decode_frame(AVCodecContext *avctx, AVFrame *pict,
         s->cur_pic.ptr->f->repeat_pict = v->rptfrm * 2;
     }
 
+    /* Field pictures and additional slice headers can still update the
+     * intensity compensation and field MV state that the next picture
+     * depends on, so only let the next thread start early without them. */
+    if (avctx->hwaccel || (!v->field_mode && !n_slices))
+        ff_thread_finish_setup(avctx);
+
     if (avctx->hwaccel) {
         const FFHWAccel *hwaccel = ffhwaccel(avctx->hwaccel);
         s->mb_y = 0;
@@ -1326,6 +1415,8 @@ static int vc1_decode_frame(AVCodecContext *avctx, AVFrame *pict,
                 get_bits_count(&s->gb), s->gb.size_in_bits);
 //  if (get_bits_count(&s->gb) > buf_size * 8)
 //      return -1;
+        if (v->field_mode || n_slices)
+            ff_thread_finish_setup(avctx);
         if(s->er.error_occurred && s->pict_type == AV_PICTURE_TYPE_B) {
             ret = AVERROR_INVALIDDATA;
             goto err;
@@ -1378,6 +1469,9 @@ end:
     return buf_size;
 
 err:
+    /* do not leave frame threads waiting on a picture that was not finished */
+    if (frame_started)
+        ff_thread_progress_report(&s->cur_pic.ptr->progress, INT_MAX);
     av_free(buf2);
     for (i = 0; i < n_slices; i++)
         av_free(slices[i].buf);
@@ -1396,7 +1490,9 @@ const FFCodec ff_vc1_decoder = {
     .close          = ff_vc1_decode_end,
     FF_CODEC_DECODE_CB(vc1_decode_frame),
     .flush          = ff_mpeg_flush,
-    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                      AV_CODEC_CAP_FRAME_THREADS,
+    UPDATE_THREAD_CONTEXT(vc1_update_thread_context),
     .hw_configs     = (const AVCodecHWConfigInternal *const []) {
 #if CONFIG_VC1_DXVA2_HWACCEL
                         HWACCEL_DXVA2(vc1),
@@ -1435,7 +1531,9 @@ const FFCodec ff_wmv3_decoder = {
     .close          = ff_vc1_decode_end,
     FF_CODEC_DECODE_CB(vc1_decode_frame),
     .flush          = ff_mpeg_flush,
-    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY,
+    .p.capabilities = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                      AV_CODEC_CAP_FRAME_THREADS,
+    UPDATE_THREAD_CONTEXT(vc1_update_thread_context),
     .hw_configs     = (const AVCodecHWConfigInternal *const []) {
 #if CONFIG_WMV3_DXVA2_HWACCEL
                         HWACCEL_DXVA2(wmv3),
@@ -20,10 +20,12 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include "libavutil/intreadwrite.h"
 #include "libavutil/mem.h"
 #include "cbs.h"
 #include "cbs_h266.h"
 #include "parser.h"
+#include "startcode.h"
 
 #define START_CODE 0x000001 ///< start_code_prefix_one_3bytes
 #define IS_IDR(nut)   (nut == VVC_IDR_W_RADL || nut == VVC_IDR_N_LP)
@@ -55,6 +57,8 @@ typedef struct VVCParserContext {
     AuDetector au_detector;
 
     int parsed_extradata;
+
+    ff_startcode_find_candidate_fn find_candidate;
 } VVCParserContext;
 
 static const enum AVPixelFormat pix_fmts_8bit[] = {
@@ -92,6 +96,19 @@ static int find_frame_end(AVCodecParserContext *s, const uint8_t *buf,
     for (i = 0; i < buf_size; i++) {
         int nut, code_len;
 
+        // A start code can only be completed in the next 5 bytes if one of
+        // the last 5 bytes is zero, otherwise skip to the next zero byte.
+        if (i >= 8 && !((pc->state64 - 0x0101010101ULL) & ~pc->state64 &
+                        0x8080808080ULL)) {
+            int skip = ctx->find_candidate(buf + i, buf_size - i);
+            if (skip) {
+                i = FFMIN(i + skip, buf_size);
+                pc->state64 = AV_RB64(buf + i - 8);
+                if (i == buf_size)
+                    break;
+            }
+        }
+
         pc->state64 = (pc->state64 << 8) | buf[i];
 
         if (((pc->state64 >> 3 * 8) & 0xFFFFFF) != START_CODE)
@@ -486,6 +503,7 @@ static av_cold int vvc_parser_init(AVCodecParserContext *s)
     if (ret < 0)
         return ret;
     au_detector_init(&ctx->au_detector);
+    ctx->find_candidate = ff_startcode_find_candidate_get();
 
     ctx->cbc->decompose_unit_types    = decompose_unit_types;
     ctx->cbc->nb_decompose_unit_types = FF_ARRAY_ELEMS(decompose_unit_types);
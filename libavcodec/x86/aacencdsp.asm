@@ -22,9 +22,9 @@
 
 %include "libavutil/x86/x86util.asm"
 
-SECTION_RODATA
+SECTION_RODATA 32
 
-float_abs_mask: times 4 dd 0x7fffffff
+float_abs_mask: times 8 dd 0x7fffffff
 
 SECTION .text
 
@@ -48,6 +48,36 @@ cglobal abs_pow34, 3, 3, 3, out, in, size
     jl    .loop
     RET
 
+; Band sizes are only guaranteed to be multiples of 4 and bands are only
+; 16-byte aligned, so use unaligned stores and finish with one xmm step.
+INIT_YMM avx2
+cglobal abs_pow34, 3, 3, 3, out, in, size
+    mova   m2, [float_abs_mask]
+    shl    sized, 2
+    add    inq, sizeq
+    add    outq, sizeq
+    neg    sizeq
+    add    sizeq, mmsize
+    jg    .tail
+.loop:
+    andps  m0, m2, [inq+sizeq-mmsize]
+    sqrtps m1, m0
+    mulps  m0, m1
+    sqrtps m0, m0
+    movu   [outq+sizeq-mmsize], m0
+    add    sizeq, mmsize
+    jle   .loop
+.tail:
+    cmp    sizeq, mmsize
+    je    .end
+    andps  xm0, xm2, [inq+sizeq-mmsize]
+    sqrtps xm1, xm0
+    mulps  xm0, xm1
+    sqrtps xm0, xm0
+    movu   [outq+sizeq-mmsize], xm0
+.end:
+    RET
+
 ;*******************************************************************
 ;void ff_aac_quantize_bands(int *out, const float *in, const float *scaled,
 ;                           int size, int is_signed, int maxval, const float Q34,
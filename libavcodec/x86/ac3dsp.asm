@@ -35,27 +35,31 @@ pw_bap_mul2: dw 5, 7, 0, 7, 5, 7, 0, 7
 cextern pd_1
 pd_151: times 4 dd 151
 
+; used in ff_ac3_bit_alloc_calc_bap()
+cextern ac3_bin_to_band_tab
+pb_63: times 16 db 63
+
 SECTION .text
 
 ;-----------------------------------------------------------------------------
 ; void ff_ac3_exponent_min(uint8_t *exp, int num_reuse_blocks, int nb_coefs)
 ;-----------------------------------------------------------------------------
 
-%macro AC3_EXPONENT_MIN 0
+%macro AC3_EXPONENT_MIN 1 ; mov instruction for exponents
 cglobal ac3_exponent_min, 3, 4, 2, exp, reuse_blks, expn, offset
     shl  reuse_blksd, 8
     jz .end
     LOOP_ALIGN
 .nextexp:
     mov      offsetq, reuse_blksq
-    mova          m0, [expq+offsetq]
+    %1            m0, [expq+offsetq]
     sub      offsetq, 256
     LOOP_ALIGN
 .nextblk:
     PMINUB        m0, [expq+offsetq], m1
     sub      offsetq, 256
     jae .nextblk
-    mova      [expq], m0
+    %1        [expq], m0
     add         expq, mmsize
     sub        expnd, mmsize
     jg .nextexp
@@ -66,7 +70,12 @@ cglobal ac3_exponent_min, 3, 4, 2, exp, reuse_blks, expn, offset
 %define LOOP_ALIGN ALIGN 16
 %if HAVE_SSE2_EXTERNAL
 INIT_XMM sse2
-AC3_EXPONENT_MIN
+AC3_EXPONENT_MIN mova
+%endif
+; exponents are only guaranteed to be 16-byte aligned
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+AC3_EXPONENT_MIN movu
 %endif
 %undef LOOP_ALIGN
 
@@ -256,3 +265,159 @@ AC3_EXTRACT_EXPONENTS
 INIT_XMM ssse3
 AC3_EXTRACT_EXPONENTS
 %endif
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+cglobal ac3_extract_exponents, 3, 3, 4, exp, coef, len
+    movsxdifnidn lenq, lend
+    add     expq, lenq
+    lea    coefq, [coefq+4*lenq]
+    neg     lenq
+    vpbroadcastd m2, [pd_1]
+    vpbroadcastd m3, [pd_151]
+.loop:
+    pabsd     m0, [coefq+4*lenq]
+    pabsd     m1, [coefq+4*lenq+mmsize]
+    pslld     m0, 1
+    pslld     m1, 1
+    por       m0, m2
+    por       m1, m2
+    cvtdq2ps  m0, m0
+    cvtdq2ps  m1, m1
+    psrld     m0, 23
+    psrld     m1, 23
+    psubd     m0, m3, m0
+    psubd     m1, m3, m1
+    ; packssdw works within lanes, so restore the coefficient order
+    ; before packing down to bytes; see the note above about packuswb
+    packssdw  m0, m1
+    vpermq    m0, m0, q3120
+    vextracti128 xm1, m0, 1
+    packuswb  xm0, xm1
+    movu [expq+lenq], xm0
+
+    add     lenq, 16
+    jl .loop
+    RET
+%endif
+
+;------------------------------------------------------------------------------
+; void ff_ac3_bit_alloc_calc_bap(int16_t *mask, int16_t *psd, int start, int end,
+;                                int snr_offset, int floor,
+;                                const uint8_t *bap_tab, uint8_t *bap)
+;------------------------------------------------------------------------------
+
+; compute bap[start] to bap[start + 15]
+%macro BAP16 0
+    vpmovzxbd      m0, [b2bq+startq]
+    vpmovzxbd      m1, [b2bq+startq+8]
+    pcmpeqd        m2, m2
+    vpgatherdd     m4, [rsp+m0*4], m2
+    pcmpeqd        m3, m3
+    vpgatherdd     m5, [rsp+m1*4], m3
+    vpmovsxwd      m0, [psdq+startq*2]
+    vpmovsxwd      m1, [psdq+startq*2+16]
+    psubd          m0, m4
+    psubd          m1, m5
+    psrad          m0, 5
+    psrad          m1, 5
+    ; saturate to words and bytes in bin order, then clip to 63
+    packssdw       m0, m1
+    vpermq         m0, m0, q3120
+    vextracti128  xm1, m0, 1
+    packuswb      xm0, xm1
+    pminub        xm0, xm7
+    ; look up the 64-entry table 16 entries at a time,
+    ; selecting on bits 4 and 5 of the address
+    psllw         xm1, xm0, 3
+    psllw         xm2, xm0, 2
+    pshufb        xm3, xm8, xm0
+    pshufb        xm4, xm9, xm0
+    vpblendvb     xm3, xm3, xm4, xm1
+    pshufb        xm4, xm10, xm0
+    pshufb        xm5, xm11, xm0
+    vpblendvb     xm4, xm4, xm5, xm1
+    vpblendvb     xm3, xm3, xm4, xm2
+    movu [bapq+startq], xm3
+%endmacro
+
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+cglobal ac3_bit_alloc_calc_bap, 8, 13, 12, 64*4, mask, psd, start, end, snr_offset, \
+                                                 floor, bap_tab, bap, b2b, band, last, \
+                                                 tmp, zero
+    cmp        snr_offsetd, -960
+    je .zero
+    movsxdifnidn startq, startd
+    movsxdifnidn   endq, endd
+    cmp         startq, endq
+    jge .end
+    lea           b2bq, [ac3_bin_to_band_tab]
+    xor          zerod, zerod
+
+    ; masking value of each band in the range, one dword per band
+    neg    snr_offsetd
+    sub    snr_offsetd, floord
+    movzx        bandd, byte [b2bq+startq]
+    movzx        lastd, byte [b2bq+endq-1]
+.band:
+    movsx         tmpd, word [maskq+bandq*2]
+    add           tmpd, snr_offsetd
+    cmovs         tmpd, zerod
+    and           tmpd, 0x1FE0
+    add           tmpd, floord
+    mov  [rsp+bandq*4], tmpd
+    inc          bandd
+    cmp          bandd, lastd
+    jle .band
+
+    lea           tmpq, [startq+16]
+    cmp           tmpq, endq
+    jg .scalar
+    movu           xm8, [bap_tabq]
+    movu           xm9, [bap_tabq+16]
+    movu          xm10, [bap_tabq+32]
+    movu          xm11, [bap_tabq+48]
+    mova           xm7, [pb_63]
+
+    ; 16 bins at a time, the last group overlapping the previous one
+.loop:
+    BAP16
+    add         startq, 16
+    lea           tmpq, [startq+16]
+    cmp           tmpq, endq
+    jle .loop
+    cmp         startq, endq
+    je .end
+    lea         startq, [endq-16]
+    BAP16
+.end:
+    RET
+
+.zero:
+    pxor           m0, m0
+%assign i 0
+%rep 256 / mmsize
+    movu    [bapq+i], m0
+%assign i i+mmsize
+%endrep
+    RET
+
+.scalar:
+    mov          lastd, 63
+.scalar_loop:
+    movzx        bandd, byte [b2bq+startq]
+    movsx         tmpd, word [psdq+startq*2]
+    sub           tmpd, [rsp+bandq*4]
+    sar           tmpd, 5
+    cmp           tmpd, zerod
+    cmovl         tmpd, zerod
+    cmp           tmpd, lastd
+    cmovg         tmpd, lastd
+    movzx         tmpd, byte [bap_tabq+tmpq]
+    mov  [bapq+startq], tmpb
+    inc         startq
+    cmp         startq, endq
+    jl .scalar_loop
+    RET
+%endif
@@ -25,6 +25,7 @@
 #include "libavcodec/ac3dsp.h"
 
 void ff_ac3_exponent_min_sse2  (uint8_t *exp, int num_reuse_blocks, int nb_coefs);
+void ff_ac3_exponent_min_avx2  (uint8_t *exp, int num_reuse_blocks, int nb_coefs);
 
 void ff_float_to_fixed24_sse2 (int32_t *dst, const float *src, size_t len);
 void ff_float_to_fixed24_avx  (int32_t *dst, const float *src, size_t len);
@@ -33,6 +34,11 @@ int ff_ac3_compute_mantissa_size_sse2(uint16_t mant_cnt[6][16]);
 
 void ff_ac3_extract_exponents_sse2 (uint8_t *exp, int32_t *coef, int nb_coefs);
 void ff_ac3_extract_exponents_ssse3(uint8_t *exp, int32_t *coef, int nb_coefs);
+void ff_ac3_extract_exponents_avx2 (uint8_t *exp, int32_t *coef, int nb_coefs);
+
+void ff_ac3_bit_alloc_calc_bap_avx2(int16_t *mask, int16_t *psd, int start, int end,
+                                    int snr_offset, int floor,
+                                    const uint8_t *bap_tab, uint8_t *bap);
 
 av_cold void ff_ac3dsp_init_x86(AC3DSPContext *c)
 {
@@ -52,6 +58,14 @@ av_cold void ff_ac3dsp_init_x86(AC3DSPContext *c)
     if (EXTERNAL_AVX_FAST(cpu_flags)) {
         c->float_to_fixed24 = ff_float_to_fixed24_avx;
     }
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        c->ac3_exponent_min  = ff_ac3_exponent_min_avx2;
+        c->extract_exponents = ff_ac3_extract_exponents_avx2;
+#if ARCH_X86_64
+        if (!(cpu_flags & AV_CPU_FLAG_SLOW_GATHER))
+            c->bit_alloc_calc_bap = ff_ac3_bit_alloc_calc_bap_avx2;
+#endif
+    }
 }
 
 #define DOWNMIX_FUNC_OPT(ch, opt)                                       \
@@ -178,6 +178,32 @@ cglobal hevc_add_residual_32_8, 3, 5, 7
     RET
 %endif ;HAVE_AVX2_EXTERNAL
 
+%if HAVE_AVX512ICL_EXTERNAL
+%macro ADD_RES_AVX512_32_8 2
+    vpmovzxbw            m1, [%2]
+    paddsw               m1, [r1+%1]
+    pmaxsw               m1, m0
+    vpmovuswb          [%2], m1
+%endmacro
+
+INIT_ZMM avx512icl
+; void ff_hevc_add_residual_32_8_avx512icl(uint8_t *dst, const int16_t *res, ptrdiff_t stride)
+cglobal hevc_add_residual_32_8, 3, 5, 2
+    pxor                 m0, m0
+    lea                  r3, [r2*3]
+    mov                 r4d, 8
+.loop:
+    ADD_RES_AVX512_32_8   0, r0
+    ADD_RES_AVX512_32_8  64, r0+r2
+    ADD_RES_AVX512_32_8 128, r0+r2*2
+    ADD_RES_AVX512_32_8 192, r0+r3
+    add                  r1, 256
+    lea                  r0, [r0+r2*4]
+    dec                 r4d
+    jg .loop
+    RET
+%endif ;HAVE_AVX512ICL_EXTERNAL
+
 %macro ADD_RES_SSE_8_10 4
     mova              m0, [%4]
     mova              m1, [%4+16]
@@ -367,3 +393,41 @@ cglobal hevc_add_residual_32_10, 3, 5, 6
     jg .loop
     RET
 %endif ;HAVE_AVX2_EXTERNAL
+
+%if HAVE_AVX512ICL_EXTERNAL
+%macro ADD_RES_AVX512_32_10 4
+    movu              m0, [%4]
+    movu              m1, [%4+64]
+    movu              m2, [%4+128]
+    movu              m3, [%4+192]
+
+    paddw             m0, [%1+0]
+    paddw             m1, [%1+%2]
+    paddw             m2, [%1+%2*2]
+    paddw             m3, [%1+%3]
+
+    CLIPW             m0, m4, m5
+    CLIPW             m1, m4, m5
+    CLIPW             m2, m4, m5
+    CLIPW             m3, m4, m5
+    movu          [%1+0], m0
+    movu         [%1+%2], m1
+    movu       [%1+%2*2], m2
+    movu         [%1+%3], m3
+%endmacro
+
+INIT_ZMM avx512icl
+cglobal hevc_add_residual_32_10, 3, 5, 6
+    pxor               m4, m4
+    vpbroadcastd       m5, [max_pixels_10]
+    lea                r3, [r2*3]
+
+    mov               r4d, 8
+.loop:
+    ADD_RES_AVX512_32_10 r0, r2, r3, r1
+    lea                r0, [r0+r2*4]
+    add                r1, 256
+    dec               r4d
+    jg .loop
+    RET
+%endif ;HAVE_AVX512ICL_EXTERNAL
@@ -35,6 +35,13 @@ typedef void bi_pel_func(uint8_t *_dst, ptrdiff_t _dststride,
 #define BI_PEL_PROTOTYPE(name, W, D, opt) \
 bi_pel_func ff_hevc_put_bi_ ## name ## W ## _ ## D ## _##opt
 
+typedef void uni_pel_func(uint8_t *_dst, ptrdiff_t _dststride,
+                          const uint8_t *_src, ptrdiff_t _srcstride,
+                          int height, intptr_t mx, intptr_t my, int width);
+
+#define UNI_PEL_PROTOTYPE(name, W, D, opt) \
+uni_pel_func ff_hevc_put_uni_ ## name ## W ## _ ## D ## _##opt
+
 ///////////////////////////////////////////////////////////////////////////////
 // MC functions
 ///////////////////////////////////////////////////////////////////////////////
@@ -162,6 +169,13 @@ void ff_hevc_put_qpel_h16_8_avx512icl(int16_t *dst, const uint8_t *_src, ptrdiff
 void ff_hevc_put_qpel_h32_8_avx512icl(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my, int width);
 void ff_hevc_put_qpel_h64_8_avx512icl(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my, int width);
 void ff_hevc_put_qpel_hv8_8_avx512icl(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my, int width);
+BI_PEL_PROTOTYPE(qpel_h,   8,  8, avx512icl);
+BI_PEL_PROTOTYPE(qpel_h,  16,  8, avx512icl);
+BI_PEL_PROTOTYPE(qpel_h,  32,  8, avx512icl);
+BI_PEL_PROTOTYPE(qpel_h,  64,  8, avx512icl);
+UNI_PEL_PROTOTYPE(qpel_h,   8,  8, avx512icl);
+UNI_PEL_PROTOTYPE(qpel_h,  16,  8, avx512icl);
+void ff_hevc_put_epel_h16_8_avx512icl(int16_t *dst, const uint8_t *_src, ptrdiff_t _srcstride, int height, intptr_t mx, intptr_t my, int width);
 
 ///////////////////////////////////////////////////////////////////////////////
 // TRANSFORM_ADD
@@ -178,6 +192,8 @@ void ff_hevc_add_residual_32_8_avx(uint8_t *dst, const int16_t *res, ptrdiff_t s
 
 void ff_hevc_add_residual_32_8_avx2(uint8_t *dst, const int16_t *res, ptrdiff_t stride);
 
+void ff_hevc_add_residual_32_8_avx512icl(uint8_t *dst, const int16_t *res, ptrdiff_t stride);
+
 void ff_hevc_add_residual_4_10_mmxext(uint8_t *dst, const int16_t *res, ptrdiff_t stride);
 void ff_hevc_add_residual_8_10_sse2(uint8_t *dst, const int16_t *res, ptrdiff_t stride);
 void ff_hevc_add_residual_16_10_sse2(uint8_t *dst, const int16_t *res, ptrdiff_t stride);
@@ -186,4 +202,6 @@ void ff_hevc_add_residual_32_10_sse2(uint8_t *dst, const int16_t *res, ptrdiff_t
 void ff_hevc_add_residual_16_10_avx2(uint8_t *dst, const int16_t *res, ptrdiff_t stride);
 void ff_hevc_add_residual_32_10_avx2(uint8_t *dst, const int16_t *res, ptrdiff_t stride);
 
+void ff_hevc_add_residual_32_10_avx512icl(uint8_t *dst, const int16_t *res, ptrdiff_t stride);
+
 #endif // AVCODEC_X86_HEVC_DSP_H
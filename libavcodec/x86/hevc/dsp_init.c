@@ -994,6 +994,18 @@ void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
             c->put_hevc_qpel[7][0][1] = ff_hevc_put_qpel_h32_8_avx512icl;
             c->put_hevc_qpel[9][0][1] = ff_hevc_put_qpel_h64_8_avx512icl;
             c->put_hevc_qpel[3][1][1] = ff_hevc_put_qpel_hv8_8_avx512icl;
+
+            c->put_hevc_qpel_bi[3][0][1] = ff_hevc_put_bi_qpel_h8_8_avx512icl;
+            c->put_hevc_qpel_bi[5][0][1] = ff_hevc_put_bi_qpel_h16_8_avx512icl;
+            c->put_hevc_qpel_bi[7][0][1] = ff_hevc_put_bi_qpel_h32_8_avx512icl;
+            c->put_hevc_qpel_bi[9][0][1] = ff_hevc_put_bi_qpel_h64_8_avx512icl;
+
+            c->put_hevc_qpel_uni[3][0][1] = ff_hevc_put_uni_qpel_h8_8_avx512icl;
+            c->put_hevc_qpel_uni[5][0][1] = ff_hevc_put_uni_qpel_h16_8_avx512icl;
+
+            c->put_hevc_epel[5][0][1] = ff_hevc_put_epel_h16_8_avx512icl;
+
+            c->add_residual[3] = ff_hevc_add_residual_32_8_avx512icl;
         }
     } else if (bit_depth == 10) {
         if (EXTERNAL_MMXEXT(cpu_flags)) {
@@ -1217,6 +1229,9 @@ void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
             c->add_residual[3] = ff_hevc_add_residual_32_10_avx2;
         }
 #endif /* HAVE_AVX2_EXTERNAL */
+        if (EXTERNAL_AVX512ICL(cpu_flags) && ARCH_X86_64) {
+            c->add_residual[3] = ff_hevc_add_residual_32_10_avx512icl;
+        }
     } else if (bit_depth == 12) {
         if (EXTERNAL_MMXEXT(cpu_flags)) {
             c->idct_dc[0] = ff_hevc_idct_4x4_dc_12_mmxext;
@@ -94,6 +94,8 @@ QPEL_TABLE 16, 1, b, avx512icl_h
 QPEL_TABLE 32, 1, b, avx512icl_h
 QPEL_TABLE 64, 1, b, avx512icl_h
 
+EPEL_TABLE  8, 1, b, avx512icl_h
+
 pb_qpel_shuffle_index: db  0,  1,  2,  3
                        db  1,  2,  3,  4
                        db  2,  3,  4,  5
@@ -1280,6 +1282,18 @@ HEVC_PUT_HEVC_QPEL_HV 16, 10
     vpbroadcastd m%4, [FILTER + %2q + 1*%%offset]
 %endmacro
 
+%macro EPEL_FILTER_H 4
+%define %%table hevc_epel_filters_avx512icl_h_%1
+    dec %2q
+    shl %2q, 2
+%if PIC
+    lea %4q, [%%table]
+    vpbroadcastd m%3, [%4q + %2q]
+%else
+    vpbroadcastd m%3, [%%table + %2q]
+%endif
+%endmacro
+
 %macro QPEL_FILTER_V 5
     vpbroadcastd m%3, [%5 + %2q + 4*%4]
 %endmacro
@@ -1310,6 +1324,21 @@ HEVC_PUT_HEVC_QPEL_HV 16, 10
     vpdpbusd        m%1, m4, m1
 %endmacro
 
+; required: m0, m2
+; %1: dst register index
+; %2: name for src
+; %3: optional offset
+%macro EPEL_H_LOAD_COMPUTE 2-3 0
+    pxor            m%1, m%1
+%if mmsize == 64
+    movu            ym4, [%2q + %3 - 1]
+%else
+    movu            xm4, [%2q + %3 - 1]
+%endif
+    vpermb           m5, m2, m4
+    vpdpbusd        m%1, m5, m0
+%endmacro
+
 %macro HEVC_PUT_HEVC_QPEL_AVX512ICL 2
 cglobal hevc_put_qpel_h%1_%2, 5, 6, 8, dst, src, srcstride, height, mx, tmp
     QPEL_FILTER_H   %1, mx, 0, 1, tmp
@@ -1336,6 +1365,87 @@ cglobal hevc_put_qpel_h%1_%2, 5, 6, 8, dst, src, srcstride, height, mx, tmp
     RET
 %endmacro
 
+; %1: dst offset in pixels
+; %2: index of the register holding the filtered pixels as dwords
+; %3: put, bi or uni; bi and uni require m8 = rounding factor, m9 = 0
+%macro PEL_H_STORE_AVX512ICL 3
+%ifidn %3, put
+    vpmovdw [dstq + 2*%1], m%2
+%else
+%if mmsize == 64
+    %define %%h  ym %+ %2
+    %define %%r  ym8
+    %define %%z  ym9
+%else
+    %define %%h  xm %+ %2
+    %define %%r  xm8
+    %define %%z  xm9
+%endif
+    vpmovdw             %%h, m%2
+%ifidn %3, bi
+    paddsw              %%h, [src2q + 2*%1]
+%endif
+    pmulhrsw            %%h, %%r
+    pmaxsw              %%h, %%z
+    vpmovuswb   [dstq + %1], %%h
+%endif
+%endmacro
+
+; %1: qpel or epel
+; %2: put, bi or uni
+; %3: width
+; %4: bitdepth
+%macro HEVC_PUT_HEVC_PEL_H_AVX512ICL 4
+%ifidn %2, put
+cglobal hevc_put_%1_h%3_%4, 5, 6, 8, dst, src, srcstride, height, mx, tmp
+%elifidn %2, bi
+cglobal hevc_put_bi_%1_h%3_%4, 7, 8, 10, dst, dststride, src, srcstride, src2, height, mx, tmp
+%else
+cglobal hevc_put_uni_%1_h%3_%4, 6, 7, 10, dst, dststride, src, srcstride, height, mx, tmp
+%endif
+%ifidn %1, qpel
+    QPEL_FILTER_H   %3, mx, 0, 1, tmp
+    QPEL_LOAD_SHUF   2, 3
+    %define %%compute QPEL_H_LOAD_COMPUTE
+%else
+    EPEL_FILTER_H   %4, mx, 0, tmp
+    movu                 m2, [pb_qpel_shuffle_index]
+    %define %%compute EPEL_H_LOAD_COMPUTE
+%endif
+%ifidn %2, bi
+    vpbroadcastd         m8, [pw_bi_%4]
+    pxor                 m9, m9
+%elifidn %2, uni
+    vpbroadcastd         m8, [pw_%4]
+    pxor                 m9, m9
+%endif
+.loop:
+    %%compute             6, src
+    PEL_H_STORE_AVX512ICL  0, 6, %2
+%if %3 > 16
+    %%compute             7, src, 16
+    PEL_H_STORE_AVX512ICL 16, 7, %2
+%endif
+%if %3 > 32
+    %%compute             6, src, 32
+    %%compute             7, src, 48
+    PEL_H_STORE_AVX512ICL 32, 6, %2
+    PEL_H_STORE_AVX512ICL 48, 7, %2
+%endif
+%ifidn %2, put
+    LOOP_END            dst, src, srcstride
+%else
+    add                dstq, dststrideq
+    add                srcq, srcstrideq
+%ifidn %2, bi
+    add               src2q, 2*MAX_PB_SIZE
+%endif
+    dec             heightd
+    jnz .loop
+%endif
+    RET
+%endmacro
+
 %macro HEVC_PUT_HEVC_QPEL_HV_AVX512ICL 2
 cglobal hevc_put_qpel_hv%1_%2, 6, 7, 27, dst, src, srcstride, height, mx, my, tmp
 %assign %%shift 6
@@ -1405,11 +1515,18 @@ HEVC_PUT_HEVC_QPEL_AVX512ICL 4, 8
 INIT_YMM avx512icl
 HEVC_PUT_HEVC_QPEL_AVX512ICL 8, 8
 HEVC_PUT_HEVC_QPEL_HV_AVX512ICL 8, 8
+HEVC_PUT_HEVC_PEL_H_AVX512ICL qpel,  bi, 8, 8
+HEVC_PUT_HEVC_PEL_H_AVX512ICL qpel, uni, 8, 8
 
 INIT_ZMM avx512icl
 HEVC_PUT_HEVC_QPEL_AVX512ICL 16, 8
 HEVC_PUT_HEVC_QPEL_AVX512ICL 32, 8
 HEVC_PUT_HEVC_QPEL_AVX512ICL 64, 8
+HEVC_PUT_HEVC_PEL_H_AVX512ICL qpel,  bi, 16, 8
+HEVC_PUT_HEVC_PEL_H_AVX512ICL qpel, uni, 16, 8
+HEVC_PUT_HEVC_PEL_H_AVX512ICL epel, put, 16, 8
+HEVC_PUT_HEVC_PEL_H_AVX512ICL qpel,  bi, 32, 8
+HEVC_PUT_HEVC_PEL_H_AVX512ICL qpel,  bi, 64, 8
 
 %endif
 %endif
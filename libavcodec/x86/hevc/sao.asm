@@ -23,6 +23,13 @@
 
 %include "libavutil/x86/x86util.asm"
 
+; the VVC decoder includes this file with its own function prefix and
+; block size, which also adds the 80 to 128 pixel wide versions
+%ifndef SAO_CODEC
+%define SAO_CODEC   hevc
+%define MAX_PB_SIZE 64
+%endif
+
 SECTION_RODATA 32
 
 pb_edge_shuffle: times 2 db 1, 2, 0, 3, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
@@ -119,10 +126,10 @@ DEFINE_ARGS dst, src, dststride, srcstride, offset, height
 %endif ; ARCH
 %endmacro
 
-;void ff_hevc_sao_band_filter_<width>_8_<opt>(uint8_t *_dst, const uint8_t *_src, ptrdiff_t _stride_dst, ptrdiff_t _stride_src,
+;void ff_<codec>_sao_band_filter_<width>_8_<opt>(uint8_t *_dst, const uint8_t *_src, ptrdiff_t _stride_dst, ptrdiff_t _stride_src,
 ;                                             int16_t *sao_offset_val, int sao_left_class, int width, int height);
 %macro HEVC_SAO_BAND_FILTER 2
-cglobal hevc_sao_band_filter_%1_8, 6, 6, 15, 7*mmsize*ARCH_X86_32, dst, src, dststride, srcstride, offset, left
+cglobal SAO_CODEC %+ _sao_band_filter_%1_8, 6, 6, 15, 7*mmsize*ARCH_X86_32, dst, src, dststride, srcstride, offset, left
     HEVC_SAO_BAND_FILTER_INIT
 
 align 16
@@ -147,7 +154,7 @@ align 16
 %assign i i+mmsize
 %endrep
 
-%if %1 == 48
+%if %1 > 16 && (%1 & 31) == 16
 INIT_XMM cpuname
 
     mova             m13, [srcq + i]
@@ -176,6 +183,12 @@ HEVC_SAO_BAND_FILTER 16, 1
 HEVC_SAO_BAND_FILTER 32, 2
 HEVC_SAO_BAND_FILTER 48, 2
 HEVC_SAO_BAND_FILTER 64, 4
+%if MAX_PB_SIZE > 64
+HEVC_SAO_BAND_FILTER 80, 4
+HEVC_SAO_BAND_FILTER 96, 6
+HEVC_SAO_BAND_FILTER 112, 6
+HEVC_SAO_BAND_FILTER 128, 8
+%endif
 %endmacro
 
 INIT_XMM sse2
@@ -191,13 +204,18 @@ INIT_YMM avx2
 HEVC_SAO_BAND_FILTER 32, 1
 HEVC_SAO_BAND_FILTER 48, 1
 HEVC_SAO_BAND_FILTER 64, 2
+%if MAX_PB_SIZE > 64
+HEVC_SAO_BAND_FILTER 80, 2
+HEVC_SAO_BAND_FILTER 96, 3
+HEVC_SAO_BAND_FILTER 112, 3
+HEVC_SAO_BAND_FILTER 128, 4
+%endif
 %endif
 
 ;******************************************************************************
 ;SAO Edge Filter
 ;******************************************************************************
 
-%define MAX_PB_SIZE  64
 %define PADDING_SIZE 64 ; AV_INPUT_BUFFER_PADDING_SIZE
 %define EDGE_SRCSTRIDE 2 * MAX_PB_SIZE + PADDING_SIZE
 
@@ -249,17 +267,17 @@ HEVC_SAO_BAND_FILTER 64, 2
 %endif
 %endmacro
 
-;void ff_hevc_sao_edge_filter_<width>_8_<opt>(uint8_t *_dst, uint8_t *_src, ptrdiff_t stride_dst, int16_t *sao_offset_val,
+;void ff_<codec>_sao_edge_filter_<width>_8_<opt>(uint8_t *_dst, uint8_t *_src, ptrdiff_t stride_dst, int16_t *sao_offset_val,
 ;                                             int eo, int width, int height);
 %macro HEVC_SAO_EDGE_FILTER 2-3
 %if ARCH_X86_64
-cglobal hevc_sao_edge_filter_%1_8, 4, 9, 8, dst, src, dststride, offset, eo, a_stride, b_stride, height, tmp
+cglobal SAO_CODEC %+ _sao_edge_filter_%1_8, 4, 9, 8, dst, src, dststride, offset, eo, a_stride, b_stride, height, tmp
 %define tmp2q heightq
     HEVC_SAO_EDGE_FILTER_INIT
     mov          heightd, r6m
 
 %else ; ARCH_X86_32
-cglobal hevc_sao_edge_filter_%1_8, 1, 6, 8, dst, src, dststride, a_stride, b_stride, height
+cglobal SAO_CODEC %+ _sao_edge_filter_%1_8, 1, 6, 8, dst, src, dststride, a_stride, b_stride, height
 %define eoq   srcq
 %define tmpq  heightq
 %define tmp2q dststrideq
@@ -305,7 +323,7 @@ align 16
 %assign i i+mmsize
 %endrep
 
-%if %1 == 48
+%if %1 > 16 && (%1 & 31) == 16
 INIT_XMM cpuname
 
     mova              m1, [srcq + i]
@@ -331,10 +349,22 @@ HEVC_SAO_EDGE_FILTER 16, 1, a
 HEVC_SAO_EDGE_FILTER 32, 2, a
 HEVC_SAO_EDGE_FILTER 48, 2, a
 HEVC_SAO_EDGE_FILTER 64, 4, a
+%if MAX_PB_SIZE > 64
+HEVC_SAO_EDGE_FILTER 80, 4, a
+HEVC_SAO_EDGE_FILTER 96, 6, a
+HEVC_SAO_EDGE_FILTER 112, 6, a
+HEVC_SAO_EDGE_FILTER 128, 8, a
+%endif
 
 %if HAVE_AVX2_EXTERNAL
 INIT_YMM avx2
 HEVC_SAO_EDGE_FILTER 32, 1, a
 HEVC_SAO_EDGE_FILTER 48, 1, u
 HEVC_SAO_EDGE_FILTER 64, 2, a
+%if MAX_PB_SIZE > 64
+HEVC_SAO_EDGE_FILTER 80, 2, u
+HEVC_SAO_EDGE_FILTER 96, 3, a
+HEVC_SAO_EDGE_FILTER 112, 3, u
+HEVC_SAO_EDGE_FILTER 128, 4, a
+%endif
 %endif
@@ -23,6 +23,13 @@
 
 %include "libavutil/x86/x86util.asm"
 
+; the VVC decoder includes this file with its own function prefix and
+; block size, which also adds the 80 to 128 pixel wide versions
+%ifndef SAO_CODEC
+%define SAO_CODEC   hevc
+%define MAX_PB_SIZE 64
+%endif
+
 SECTION_RODATA 32
 
 pw_m2:     times 16 dw -2
@@ -92,10 +99,10 @@ DEFINE_ARGS dst, src, dststride, srcstride, offset, height
     mov          heightd, r7m
 %endmacro
 
-;void ff_hevc_sao_band_filter_<width>_<depth>_<opt>(uint8_t *_dst, const uint8_t *_src, ptrdiff_t _stride_dst, ptrdiff_t _stride_src,
+;void ff_<codec>_sao_band_filter_<width>_<depth>_<opt>(uint8_t *_dst, const uint8_t *_src, ptrdiff_t _stride_dst, ptrdiff_t _stride_src,
 ;                                                   int16_t *sao_offset_val, int sao_left_class, int width, int height);
 %macro HEVC_SAO_BAND_FILTER 3
-cglobal hevc_sao_band_filter_%2_%1, 6, 6, 15, 7*mmsize*ARCH_X86_32, dst, src, dststride, srcstride, offset, left
+cglobal SAO_CODEC %+ _sao_band_filter_%2_%1, 6, 6, 15, 7*mmsize*ARCH_X86_32, dst, src, dststride, srcstride, offset, left
     HEVC_SAO_BAND_FILTER_INIT %1
 
 align 16
@@ -154,12 +161,24 @@ HEVC_SAO_BAND_FILTER 10, 16, 2
 HEVC_SAO_BAND_FILTER 10, 32, 4
 HEVC_SAO_BAND_FILTER 10, 48, 6
 HEVC_SAO_BAND_FILTER 10, 64, 8
+%if MAX_PB_SIZE > 64
+HEVC_SAO_BAND_FILTER 10, 80, 10
+HEVC_SAO_BAND_FILTER 10, 96, 12
+HEVC_SAO_BAND_FILTER 10, 112, 14
+HEVC_SAO_BAND_FILTER 10, 128, 16
+%endif
 
 HEVC_SAO_BAND_FILTER 12,  8, 1
 HEVC_SAO_BAND_FILTER 12, 16, 2
 HEVC_SAO_BAND_FILTER 12, 32, 4
 HEVC_SAO_BAND_FILTER 12, 48, 6
 HEVC_SAO_BAND_FILTER 12, 64, 8
+%if MAX_PB_SIZE > 64
+HEVC_SAO_BAND_FILTER 12, 80, 10
+HEVC_SAO_BAND_FILTER 12, 96, 12
+HEVC_SAO_BAND_FILTER 12, 112, 14
+HEVC_SAO_BAND_FILTER 12, 128, 16
+%endif
 %endmacro
 
 INIT_XMM sse2
@@ -175,6 +194,12 @@ HEVC_SAO_BAND_FILTER 10, 16, 1
 HEVC_SAO_BAND_FILTER 10, 32, 2
 HEVC_SAO_BAND_FILTER 10, 48, 3
 HEVC_SAO_BAND_FILTER 10, 64, 4
+%if MAX_PB_SIZE > 64
+HEVC_SAO_BAND_FILTER 10, 80, 5
+HEVC_SAO_BAND_FILTER 10, 96, 6
+HEVC_SAO_BAND_FILTER 10, 112, 7
+HEVC_SAO_BAND_FILTER 10, 128, 8
+%endif
 
 INIT_XMM avx2
 HEVC_SAO_BAND_FILTER 12,  8, 1
@@ -183,13 +208,18 @@ HEVC_SAO_BAND_FILTER 12, 16, 1
 HEVC_SAO_BAND_FILTER 12, 32, 2
 HEVC_SAO_BAND_FILTER 12, 48, 3
 HEVC_SAO_BAND_FILTER 12, 64, 4
+%if MAX_PB_SIZE > 64
+HEVC_SAO_BAND_FILTER 12, 80, 5
+HEVC_SAO_BAND_FILTER 12, 96, 6
+HEVC_SAO_BAND_FILTER 12, 112, 7
+HEVC_SAO_BAND_FILTER 12, 128, 8
+%endif
 %endif
 
 ;******************************************************************************
 ;SAO Edge Filter
 ;******************************************************************************
 
-%define MAX_PB_SIZE  64
 %define PADDING_SIZE 64 ; AV_INPUT_BUFFER_PADDING_SIZE
 %define EDGE_SRCSTRIDE 2 * MAX_PB_SIZE + PADDING_SIZE
 
@@ -221,11 +251,11 @@ HEVC_SAO_BAND_FILTER 12, 64, 4
     add        b_strideq, tmpq
 %endmacro
 
-;void ff_hevc_sao_edge_filter_<width>_<depth>_<opt>(uint8_t *_dst, uint8_t *_src, ptrdiff_t stride_dst, int16_t *sao_offset_val,
+;void ff_<codec>_sao_edge_filter_<width>_<depth>_<opt>(uint8_t *_dst, uint8_t *_src, ptrdiff_t stride_dst, int16_t *sao_offset_val,
 ;                                                   int eo, int width, int height);
 %macro HEVC_SAO_EDGE_FILTER 3
 %if ARCH_X86_64
-cglobal hevc_sao_edge_filter_%2_%1, 4, 9, 16, dst, src, dststride, offset, eo, a_stride, b_stride, height, tmp
+cglobal SAO_CODEC %+ _sao_edge_filter_%2_%1, 4, 9, 16, dst, src, dststride, offset, eo, a_stride, b_stride, height, tmp
 %define tmp2q heightq
     HEVC_SAO_EDGE_FILTER_INIT
     mov          heightd, r6m
@@ -233,7 +263,7 @@ cglobal hevc_sao_edge_filter_%2_%1, 4, 9, 16, dst, src, dststride, offset, eo, a
     add        b_strideq, b_strideq
 
 %else ; ARCH_X86_32
-cglobal hevc_sao_edge_filter_%2_%1, 1, 6, 8, 5*mmsize, dst, src, dststride, a_stride, b_stride, height
+cglobal SAO_CODEC %+ _sao_edge_filter_%2_%1, 1, 6, 8, 5*mmsize, dst, src, dststride, a_stride, b_stride, height
 %define eoq   srcq
 %define tmpq  heightq
 %define tmp2q dststrideq
@@ -344,12 +374,24 @@ HEVC_SAO_EDGE_FILTER 10, 16, 2
 HEVC_SAO_EDGE_FILTER 10, 32, 4
 HEVC_SAO_EDGE_FILTER 10, 48, 6
 HEVC_SAO_EDGE_FILTER 10, 64, 8
+%if MAX_PB_SIZE > 64
+HEVC_SAO_EDGE_FILTER 10, 80, 10
+HEVC_SAO_EDGE_FILTER 10, 96, 12
+HEVC_SAO_EDGE_FILTER 10, 112, 14
+HEVC_SAO_EDGE_FILTER 10, 128, 16
+%endif
 
 HEVC_SAO_EDGE_FILTER 12,  8, 1
 HEVC_SAO_EDGE_FILTER 12, 16, 2
 HEVC_SAO_EDGE_FILTER 12, 32, 4
 HEVC_SAO_EDGE_FILTER 12, 48, 6
 HEVC_SAO_EDGE_FILTER 12, 64, 8
+%if MAX_PB_SIZE > 64
+HEVC_SAO_EDGE_FILTER 12, 80, 10
+HEVC_SAO_EDGE_FILTER 12, 96, 12
+HEVC_SAO_EDGE_FILTER 12, 112, 14
+HEVC_SAO_EDGE_FILTER 12, 128, 16
+%endif
 
 %if HAVE_AVX2_EXTERNAL
 INIT_XMM avx2
@@ -359,6 +401,12 @@ HEVC_SAO_EDGE_FILTER 10, 16, 1
 HEVC_SAO_EDGE_FILTER 10, 32, 2
 HEVC_SAO_EDGE_FILTER 10, 48, 3
 HEVC_SAO_EDGE_FILTER 10, 64, 4
+%if MAX_PB_SIZE > 64
+HEVC_SAO_EDGE_FILTER 10, 80, 5
+HEVC_SAO_EDGE_FILTER 10, 96, 6
+HEVC_SAO_EDGE_FILTER 10, 112, 7
+HEVC_SAO_EDGE_FILTER 10, 128, 8
+%endif
 
 INIT_XMM avx2
 HEVC_SAO_EDGE_FILTER 12,  8, 1
@@ -367,4 +415,10 @@ HEVC_SAO_EDGE_FILTER 12, 16, 1
 HEVC_SAO_EDGE_FILTER 12, 32, 2
 HEVC_SAO_EDGE_FILTER 12, 48, 3
 HEVC_SAO_EDGE_FILTER 12, 64, 4
+%if MAX_PB_SIZE > 64
+HEVC_SAO_EDGE_FILTER 12, 80, 5
+HEVC_SAO_EDGE_FILTER 12, 96, 6
+HEVC_SAO_EDGE_FILTER 12, 112, 7
+HEVC_SAO_EDGE_FILTER 12, 128, 8
+%endif
 %endif
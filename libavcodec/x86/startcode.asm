@@ -0,0 +1,75 @@
+;******************************************************************************
+;* SIMD start code candidate search
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+;-----------------------------------------------------------------------------
+; int ff_startcode_find_candidate(const uint8_t *buf, int size)
+;
+; Two vectors are tested per iteration, so up to 2 * mmsize - 1 bytes past
+; buf + size are read, which stays within the input padding.
+;-----------------------------------------------------------------------------
+%macro STARTCODE_FIND_CANDIDATE 0
+cglobal startcode_find_candidate, 2, 4, 4, buf, size, idx, mask
+    xor           idxd, idxd
+    movsxdifnidn  sizeq, sized
+    test          sizeq, sizeq
+    jle .end
+    pxor            m0, m0
+.loop:
+    movu            m1, [bufq + idxq]
+    movu            m2, [bufq + idxq + mmsize]
+    pminub          m3, m1, m2
+    pcmpeqb         m3, m0
+    pmovmskb     maskd, m3
+    test         maskd, maskd
+    jnz .found
+    add           idxq, 2 * mmsize
+    cmp           idxq, sizeq
+    jl .loop
+    mov           idxq, sizeq
+    jmp .end
+.found:
+    pcmpeqb         m1, m0
+    pmovmskb     maskd, m1
+    test         maskd, maskd
+    jnz .first
+    add           idxq, mmsize
+    pcmpeqb         m2, m0
+    pmovmskb     maskd, m2
+.first:
+    bsf          maskd, maskd
+    add           idxq, maskq
+    cmp           idxq, sizeq
+    cmovg         idxq, sizeq
+.end:
+    mov            eax, idxd
+    RET
+%endmacro
+
+INIT_XMM sse2
+STARTCODE_FIND_CANDIDATE
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+STARTCODE_FIND_CANDIDATE
+%endif
@@ -0,0 +1,331 @@
+;******************************************************************************
+;* SIMD texture block decompression
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+pb_dxt_bcast:      db 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3
+pb_dxt_code_mask:  times 4 db 0x03, 0x0c, 0x30, 0xc0
+pb_dxt_lo_sel:     times 4 db 0xff, 0xff, 0x00, 0x00
+pb_dxt_hi_sel:     times 4 db 0x00, 0x00, 0xff, 0xff
+pb_dxt_code_lut:   db 0, 4, 8, 12, 4, 0, 0, 0, 8, 0, 0, 0, 12, 0, 0, 0
+pb_dxt_rgba_off:   times 4 db 0, 1, 2, 3
+pb_dxt_alpha_row:  db 0x80, 0x80, 0x80, 0, 0x80, 0x80, 0x80, 1
+                   db 0x80, 0x80, 0x80, 2, 0x80, 0x80, 0x80, 3
+pb_dxt3_alpha_lut: db 0, 17, 34, 51, 68, 85, 102, 119
+                   db 136, 153, 170, 187, 204, 221, 238, 255
+pb_bc4_idx_lo:     db 2, 3, 2, 3, 2, 3, 3, 4, 3, 4, 3, 4, 4, 5, 4, 5
+pb_bc4_idx_hi:     db 5, 6, 5, 6, 5, 6, 6, 7, 6, 7, 6, 7, 7, 0x80, 7, 0x80
+pb_rgtc1_rgb:      db 0, 0, 0, 0x80, 1, 1, 1, 0x80, 2, 2, 2, 0x80, 3, 3, 3, 0x80
+pd_alpha:          times 4 dd 0xff000000
+pd_alpha_3:        dd 0xff000000, 0xff000000, 0xff000000, 0
+pd_rgb:            times 4 dd 0x00ffffff
+pd_65025:          times 4 dd 65025
+pd_127:            times 4 dd 127
+pw_565_mul:        times 2 dw 1, 1, 2048, 0
+pw_565_mask:       times 2 dw 0xf800, 0x07e0, 0xf800, 0
+pw_565_shift:      times 2 dw 32, 2048, 32, 0
+pw_565_expand:     times 2 dw 526, 259, 526, 0
+pw_div3:           times 8 dw 21846
+pw_div5:           times 8 dw 13108
+pw_div7:           times 8 dw 9363
+pw_bc4_w0_7:       dw 7, 0, 6, 5, 4, 3, 2, 1
+pw_bc4_w1_7:       dw 0, 7, 1, 2, 3, 4, 5, 6
+pw_bc4_w0_5:       dw 5, 0, 4, 3, 2, 1, 0, 0
+pw_bc4_w1_5:       dw 0, 5, 1, 2, 3, 4, 0, 0
+pw_bc4_max_5:      dw 0, 0, 0, 0, 0, 0, 0, 255
+pw_bc4_idx_mul:    dw 8192, 1024, 128, 4096, 512, 64, 2048, 256
+pw_ff00:           times 8 dw 0xff00
+
+cextern pb_15
+cextern pw_32
+
+SECTION .text
+
+; The colour palette of a DXT block is built in words as
+;   r0 g0 b0 0 r1 g1 b1 0
+; with the 565 components expanded as (v * 526 + 32) >> 6 and
+; (v * 259 + 32) >> 6, which matches the rounding of the C code. The
+; divisions by 3, 5 and 7 are done with pmulhuw, which is exact for the
+; range of the interpolated sums.
+
+; m0 = RGBA palette of the colour block at [blockq + %1]
+; %2 = alpha of the fourth colour in three colour mode, -1 for formats
+;      which always use four colours and leave the alpha to the caller
+; clobbers m1, m2, c0, c1
+%macro DXT_COLORS 2
+    movd            m0, [blockq + %1]
+    punpcklwd       m0, m0
+    pshufd          m0, m0, q1100
+    pmullw          m0, [pw_565_mul]
+    pand            m0, [pw_565_mask]
+    pmulhuw         m0, [pw_565_shift]
+    pmullw          m0, [pw_565_expand]
+    paddw           m0, [pw_32]
+    psrlw           m0, 6
+    pshufd          m1, m0, q1032
+%if %2 >= 0
+    movzx          c0d, word [blockq + %1]
+    movzx          c1d, word [blockq + %1 + 2]
+    cmp            c0d, c1d
+    jbe %%three_colors
+%endif
+    paddw           m2, m0, m0
+    paddw           m2, m1
+    pmulhuw         m2, [pw_div3]
+    packuswb        m0, m2
+%if %2 >= 0
+    por             m0, [pd_alpha]
+    jmp %%done
+%%three_colors:
+    paddw           m1, m0
+    psrlw           m1, 1
+    movq            m1, m1
+    packuswb        m0, m1
+%if %2
+    por             m0, [pd_alpha]
+%else
+    por             m0, [pd_alpha_3]
+%endif
+%%done:
+%endif
+%endmacro
+
+; write the 4x4 block using the palette in m0 and the colour codes at
+; [blockq + %1]; if %2, the alpha values of the 16 pixels are in m5
+; clobbers m1-m5
+%macro DXT_STORE 2
+    movd            m3, [blockq + %1]
+    mova            m4, [pb_dxt_bcast]
+    pshufb          m3, m4
+    pand            m3, [pb_dxt_code_mask]
+    psrlw           m2, m3, 4
+    pand            m3, [pb_dxt_lo_sel]
+    pand            m2, [pb_dxt_hi_sel]
+    por             m3, m2
+    mova            m2, [pb_dxt_code_lut]
+    pshufb          m2, m3
+%rep 4
+    mova            m1, m2
+    pshufb          m1, m4
+    paddb           m1, [pb_dxt_rgba_off]
+    mova            m3, m0
+    pshufb          m3, m1
+%if %2
+    mova            m1, m5
+    pshufb          m1, [pb_dxt_alpha_row]
+    por             m3, m1
+    psrldq          m5, 4
+%endif
+    movu        [dstq], m3
+    psrldq          m2, 4
+    add           dstq, strideq
+%endrep
+%endmacro
+
+; m1 = the 16 8-bit values of the BC4 (RGTC1, DXT5 alpha) block at
+; [blockq + %1], in raster order; %2 = signed endpoints
+; clobbers m2, m3, c0, c1
+%macro BC4_VALUES 2
+    movzx          c0d, byte [blockq + %1]
+    movzx          c1d, byte [blockq + %1 + 1]
+%if %2
+    xor            c0d, 0x80
+    xor            c1d, 0x80
+%endif
+    movd            m1, c0d
+    movd            m2, c1d
+    SPLATW          m1, m1
+    SPLATW          m2, m2
+    cmp            c0d, c1d
+    jbe %%five_values
+    pmullw          m1, [pw_bc4_w0_7]
+    pmullw          m2, [pw_bc4_w1_7]
+    paddw           m1, m2
+    pmulhuw         m1, [pw_div7]
+    jmp %%table_done
+%%five_values:
+    pmullw          m1, [pw_bc4_w0_5]
+    pmullw          m2, [pw_bc4_w1_5]
+    paddw           m1, m2
+    pmulhuw         m1, [pw_div5]
+    por             m1, [pw_bc4_max_5]
+%%table_done:
+    packuswb        m1, m1
+    ; each 3-bit index is extracted from the 16-bit window holding it
+    movq            m2, [blockq + %1]
+    mova            m3, m2
+    pshufb          m2, [pb_bc4_idx_lo]
+    pshufb          m3, [pb_bc4_idx_hi]
+    pmullw          m2, [pw_bc4_idx_mul]
+    pmullw          m3, [pw_bc4_idx_mul]
+    psrlw           m2, 13
+    psrlw           m3, 13
+    packuswb        m2, m3
+    pshufb          m1, m2
+%endmacro
+
+INIT_XMM ssse3
+;-----------------------------------------------------------------------------
+; int ff_dxt1_block(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
+;-----------------------------------------------------------------------------
+cglobal dxt1_block, 3, 5, 5, dst, stride, block, c0, c1
+    DXT_COLORS       0, 1
+    DXT_STORE        4, 0
+    mov            eax, 8
+    RET
+
+cglobal dxt1a_block, 3, 5, 5, dst, stride, block, c0, c1
+    DXT_COLORS       0, 0
+    DXT_STORE        4, 0
+    mov            eax, 8
+    RET
+
+cglobal dxt3_block, 3, 3, 6, dst, stride, block
+    movq            m5, [blockq]
+    psrlw           m1, m5, 4
+    pand            m5, [pb_15]
+    pand            m1, [pb_15]
+    punpcklbw       m5, m1
+    mova            m1, [pb_dxt3_alpha_lut]
+    pshufb          m1, m5
+    SWAP             1, 5
+    DXT_COLORS       8, -1
+    DXT_STORE       12, 1
+    mov            eax, 16
+    RET
+
+cglobal dxt5_block, 3, 5, 6, dst, stride, block, c0, c1
+    BC4_VALUES       0, 0
+    SWAP             1, 5
+    DXT_COLORS       8, -1
+    DXT_STORE       12, 1
+    mov            eax, 16
+    RET
+
+;-----------------------------------------------------------------------------
+; int ff_rgtc1_block(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
+;-----------------------------------------------------------------------------
+%macro RGTC1_BLOCK 2 ; suffix, signed
+cglobal rgtc1%1_block, 3, 5, 4, dst, stride, block, c0, c1
+    BC4_VALUES       0, %2
+    mova            m0, [pb_rgtc1_rgb]
+    mova            m3, [pd_alpha]
+%rep 4
+    mova            m2, m1
+    pshufb          m2, m0
+    por             m2, m3
+    movu        [dstq], m2
+    psrldq          m1, 4
+    add           dstq, strideq
+%endrep
+    mov            eax, 8
+    RET
+%endmacro
+
+RGTC1_BLOCK s, 1
+RGTC1_BLOCK u, 0
+
+cglobal rgtc1u_gray_block, 3, 5, 4, dst, stride, block, c0, c1
+    BC4_VALUES       0, 0
+%rep 4
+    movd        [dstq], m1
+    psrldq          m1, 4
+    add           dstq, strideq
+%endrep
+    mov            eax, 8
+    RET
+
+cglobal rgtc1u_alpha_block, 3, 5, 5, dst, stride, block, c0, c1
+    BC4_VALUES       0, 0
+    mova            m0, [pb_dxt_alpha_row]
+    mova            m3, [pd_rgb]
+%rep 4
+    movu            m2, [dstq]
+    pand            m2, m3
+    mova            m4, m1
+    pshufb          m4, m0
+    por             m2, m4
+    movu        [dstq], m2
+    psrldq          m1, 4
+    add           dstq, strideq
+%endrep
+    mov            eax, 8
+    RET
+
+;-----------------------------------------------------------------------------
+; int ff_rgtc2_block(uint8_t *dst, ptrdiff_t stride, const uint8_t *block)
+;-----------------------------------------------------------------------------
+
+; %1 = r * r + g * g in, blue out (dwords), %2 = temporary, m7 = 0
+%macro RGTC2_BLUE 2
+    mova            %2, [pd_65025]
+    psubd           %2, %1
+    psrad           %2, 1
+    cvtdq2ps        %1, %2
+    sqrtps          %1, %1
+    cvtps2dq        %1, %1
+    pcmpgtd         %2, m7
+    pand            %1, %2
+    pandn           %2, [pd_127]
+    por             %1, %2
+%endmacro
+
+; write two rows from the interleaved red and green bytes in %1
+%macro RGTC2_ROWS 1
+    punpcklbw       m1, %1, m7
+    punpckhbw       m2, %1, m7
+    pmaddwd         m1, m1
+    pmaddwd         m2, m2
+    RGTC2_BLUE      m1, m3
+    RGTC2_BLUE      m2, m3
+    packssdw        m1, m2
+    por             m1, [pw_ff00]
+    mova            m2, %1
+    punpcklwd       %1, m1
+    punpckhwd       m2, m1
+    movu          [dstq], %1
+    movu [dstq + strideq], m2
+    lea           dstq, [dstq + strideq * 2]
+%endmacro
+
+%macro RGTC2_BLOCK 3 ; name, signed, swapped red and green
+cglobal %1_block, 3, 5, 8, dst, stride, block, c0, c1
+    BC4_VALUES       0, %2
+    mova            m4, m1
+    BC4_VALUES       8, %2
+    mova            m5, m1
+%if %3
+    SWAP             4, 5
+%endif
+    pxor            m7, m7
+    mova            m0, m4
+    punpcklbw       m4, m5
+    punpckhbw       m0, m5
+    RGTC2_ROWS      m4
+    RGTC2_ROWS      m0
+    mov            eax, 16
+    RET
+%endmacro
+
+RGTC2_BLOCK rgtc2s, 1, 0
+RGTC2_BLOCK rgtc2u, 0, 0
+RGTC2_BLOCK dxn3dc, 0, 1
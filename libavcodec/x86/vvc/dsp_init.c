@@ -93,6 +93,55 @@ void BF(ff_vvc_alf_classify, bpc, opt)(int *class_idx, int *transpose_idx, const
 ALF_BPC_PROTOTYPES(8,  avx2)
 ALF_BPC_PROTOTYPES(16, avx2)
 
+#define SAO_BAND_FILTER_PROTOTYPE(w, bd, opt)                                                                   \
+void ff_vvc_sao_band_filter_##w##_##bd##_##opt(uint8_t *dst, const uint8_t *src, ptrdiff_t dst_stride,         \
+    ptrdiff_t src_stride, const int16_t *sao_offset_val, int sao_left_class, int width, int height);
+#define SAO_EDGE_FILTER_PROTOTYPE(w, bd, opt)                                                                   \
+void ff_vvc_sao_edge_filter_##w##_##bd##_##opt(uint8_t *dst, const uint8_t *src, ptrdiff_t dst_stride,         \
+    const int16_t *sao_offset_val, int sao_eo_class, int width, int height);
+
+#define SAO_FILTER_PROTOTYPES(type, bd, opt)        \
+    SAO_##type##_FILTER_PROTOTYPE(8,   bd, opt)     \
+    SAO_##type##_FILTER_PROTOTYPE(16,  bd, opt)     \
+    SAO_##type##_FILTER_PROTOTYPE(32,  bd, opt)     \
+    SAO_##type##_FILTER_PROTOTYPE(48,  bd, opt)     \
+    SAO_##type##_FILTER_PROTOTYPE(64,  bd, opt)     \
+    SAO_##type##_FILTER_PROTOTYPE(80,  bd, opt)     \
+    SAO_##type##_FILTER_PROTOTYPE(96,  bd, opt)     \
+    SAO_##type##_FILTER_PROTOTYPE(112, bd, opt)     \
+    SAO_##type##_FILTER_PROTOTYPE(128, bd, opt)
+
+SAO_FILTER_PROTOTYPES(BAND,  8, sse2)
+SAO_FILTER_PROTOTYPES(BAND, 10, sse2)
+SAO_FILTER_PROTOTYPES(BAND, 12, sse2)
+SAO_FILTER_PROTOTYPES(BAND,  8, avx2)
+SAO_FILTER_PROTOTYPES(BAND, 10, avx2)
+SAO_FILTER_PROTOTYPES(BAND, 12, avx2)
+SAO_FILTER_PROTOTYPES(EDGE,  8, ssse3)
+SAO_FILTER_PROTOTYPES(EDGE, 10, sse2)
+SAO_FILTER_PROTOTYPES(EDGE, 12, sse2)
+SAO_EDGE_FILTER_PROTOTYPE(32,  8, avx2)
+SAO_EDGE_FILTER_PROTOTYPE(48,  8, avx2)
+SAO_EDGE_FILTER_PROTOTYPE(64,  8, avx2)
+SAO_EDGE_FILTER_PROTOTYPE(80,  8, avx2)
+SAO_EDGE_FILTER_PROTOTYPE(96,  8, avx2)
+SAO_EDGE_FILTER_PROTOTYPE(112, 8, avx2)
+SAO_EDGE_FILTER_PROTOTYPE(128, 8, avx2)
+SAO_FILTER_PROTOTYPES(EDGE, 10, avx2)
+SAO_FILTER_PROTOTYPES(EDGE, 12, avx2)
+
+#define SAO_FILTER_INIT(type, bd, opt) do {                                    \
+    c->sao.type##_filter[0] = ff_vvc_sao_##type##_filter_8_##bd##_##opt;      \
+    c->sao.type##_filter[1] = ff_vvc_sao_##type##_filter_16_##bd##_##opt;     \
+    c->sao.type##_filter[2] = ff_vvc_sao_##type##_filter_32_##bd##_##opt;     \
+    c->sao.type##_filter[3] = ff_vvc_sao_##type##_filter_48_##bd##_##opt;     \
+    c->sao.type##_filter[4] = ff_vvc_sao_##type##_filter_64_##bd##_##opt;     \
+    c->sao.type##_filter[5] = ff_vvc_sao_##type##_filter_80_##bd##_##opt;     \
+    c->sao.type##_filter[6] = ff_vvc_sao_##type##_filter_96_##bd##_##opt;     \
+    c->sao.type##_filter[7] = ff_vvc_sao_##type##_filter_112_##bd##_##opt;    \
+    c->sao.type##_filter[8] = ff_vvc_sao_##type##_filter_128_##bd##_##opt;    \
+} while (0)
+
 #if ARCH_X86_64
 #define FW_PUT(name, depth, opt) \
 static void vvc_put_ ## name ## _ ## depth ## _##opt(int16_t *dst, const uint8_t *src, ptrdiff_t srcstride,    \
@@ -312,6 +361,14 @@ void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
 
     switch (bd) {
     case 8:
+#if HAVE_SSE2_EXTERNAL
+        if (EXTERNAL_SSE2(cpu_flags))
+            SAO_FILTER_INIT(band, 8, sse2);
+#endif
+#if HAVE_SSSE3_EXTERNAL
+        if (EXTERNAL_SSSE3(cpu_flags))
+            SAO_FILTER_INIT(edge, 8, ssse3);
+#endif
 #if HAVE_SSE4_EXTERNAL
         if (EXTERNAL_SSE4(cpu_flags)) {
             MC_LINK_SSE4(8);
@@ -320,6 +377,14 @@ void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
 #if HAVE_AVX2_EXTERNAL
         if (EXTERNAL_AVX2_FAST(cpu_flags)) {
             ALF_INIT(8);
+            SAO_FILTER_INIT(band, 8, avx2);
+            c->sao.edge_filter[2] = ff_vvc_sao_edge_filter_32_8_avx2;
+            c->sao.edge_filter[3] = ff_vvc_sao_edge_filter_48_8_avx2;
+            c->sao.edge_filter[4] = ff_vvc_sao_edge_filter_64_8_avx2;
+            c->sao.edge_filter[5] = ff_vvc_sao_edge_filter_80_8_avx2;
+            c->sao.edge_filter[6] = ff_vvc_sao_edge_filter_96_8_avx2;
+            c->sao.edge_filter[7] = ff_vvc_sao_edge_filter_112_8_avx2;
+            c->sao.edge_filter[8] = ff_vvc_sao_edge_filter_128_8_avx2;
             AVG_INIT(8, avx2);
             MC_LINKS_AVX2(8);
             OF_INIT(8);
@@ -329,6 +394,12 @@ void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
 #endif
         break;
     case 10:
+#if HAVE_SSE2_EXTERNAL
+        if (EXTERNAL_SSE2(cpu_flags)) {
+            SAO_FILTER_INIT(band, 10, sse2);
+            SAO_FILTER_INIT(edge, 10, sse2);
+        }
+#endif
 #if HAVE_SSE4_EXTERNAL
         if (EXTERNAL_SSE4(cpu_flags)) {
             MC_LINK_SSE4(10);
@@ -337,6 +408,8 @@ void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
 #if HAVE_AVX2_EXTERNAL
         if (EXTERNAL_AVX2_FAST(cpu_flags)) {
             ALF_INIT(10);
+            SAO_FILTER_INIT(band, 10, avx2);
+            SAO_FILTER_INIT(edge, 10, avx2);
             AVG_INIT(10, avx2);
             MC_LINKS_AVX2(10);
             MC_LINKS_16BPC_AVX2(10);
@@ -347,6 +420,12 @@ void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
 #endif
         break;
     case 12:
+#if HAVE_SSE2_EXTERNAL
+        if (EXTERNAL_SSE2(cpu_flags)) {
+            SAO_FILTER_INIT(band, 12, sse2);
+            SAO_FILTER_INIT(edge, 12, sse2);
+        }
+#endif
 #if HAVE_SSE4_EXTERNAL
         if (EXTERNAL_SSE4(cpu_flags)) {
             MC_LINK_SSE4(12);
@@ -355,6 +434,8 @@ void ff_vvc_dsp_init_x86(VVCDSPContext *const c, const int bd)
 #if HAVE_AVX2_EXTERNAL
         if (EXTERNAL_AVX2_FAST(cpu_flags)) {
             ALF_INIT(12);
+            SAO_FILTER_INIT(band, 12, avx2);
+            SAO_FILTER_INIT(edge, 12, avx2);
             AVG_INIT(12, avx2);
             MC_LINKS_AVX2(12);
             MC_LINKS_16BPC_AVX2(12);
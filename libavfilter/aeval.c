@@ -72,6 +72,9 @@ typedef struct EvalContext {
     uint64_t n;
     double var_values[VAR_VARS_NB];
     double *channel_values;
+    int uses_val;               ///< some expression uses val()
+    double *var_arrays;         ///< per sample values of N and T
+    unsigned int var_arrays_size;
 } EvalContext;
 
 static double val(void *priv, double ch)
@@ -109,6 +112,7 @@ static int parse_channel_expressions(AVFilterContext *ctx,
     char *expr, *last_expr = NULL, *buf;
     double (* const *func1)(void *, double) = NULL;
     const char * const *func1_names = NULL;
+    unsigned nb_val;
     int i, ret = 0;
 
     if (!args1)
@@ -136,6 +140,10 @@ static int parse_channel_expressions(AVFilterContext *ctx,
                             NULL, NULL, 0, ctx);                        \
         if (ret < 0)                                                    \
             goto end;                                                   \
+        nb_val = 0;                                                     \
+        av_expr_count_func(eval->expr[eval->nb_channels - 1],           \
+                           &nb_val, 1, 1);                              \
+        eval->uses_val |= !!nb_val;                                     \
     } while (0)
 
     /* reset expressions */
@@ -145,6 +153,7 @@ static int parse_channel_expressions(AVFilterContext *ctx,
     }
     av_freep(&eval->expr);
     eval->nb_channels = 0;
+    eval->uses_val = 0;
 
     buf = args1;
     while (expr = av_strtok(buf, "|", &buf)) {
@@ -219,6 +228,7 @@ static av_cold void uninit(AVFilterContext *ctx)
     }
     av_freep(&eval->expr);
     av_freep(&eval->channel_values);
+    av_freep(&eval->var_arrays);
     av_channel_layout_uninit(&eval->chlayout);
 }
 
@@ -268,6 +278,7 @@ static int activate(AVFilterContext *ctx)
 {
     AVFilterLink *outlink = ctx->outputs[0];
     EvalContext *eval = outlink->src->priv;
+    const double *arrays[VAR_VARS_NB] = { NULL };
     AVFrame *samplesref;
     int i, j;
     int64_t t = av_rescale(eval->n, AV_TIME_BASE, eval->sample_rate);
@@ -294,17 +305,25 @@ static int activate(AVFilterContext *ctx)
     if (!samplesref)
         return AVERROR(ENOMEM);
 
-    /* evaluate expression for each single sample and for each channel */
-    for (i = 0; i < nb_samples; i++, eval->n++) {
-        eval->var_values[VAR_N] = eval->n;
-        eval->var_values[VAR_T] = eval->var_values[VAR_N] * (double)1/eval->sample_rate;
+    av_fast_malloc(&eval->var_arrays, &eval->var_arrays_size,
+                   2 * nb_samples * sizeof(*eval->var_arrays));
+    if (!eval->var_arrays) {
+        av_frame_free(&samplesref);
+        return AVERROR(ENOMEM);
+    }
+    arrays[VAR_N] = eval->var_arrays;
+    arrays[VAR_T] = eval->var_arrays + nb_samples;
 
-        for (j = 0; j < eval->nb_channels; j++) {
-            *((double *) samplesref->extended_data[j] + i) =
-                av_expr_eval(eval->expr[j], eval->var_values, NULL);
-        }
+    for (i = 0; i < nb_samples; i++, eval->n++) {
+        eval->var_arrays[i] = eval->n;
+        eval->var_arrays[nb_samples + i] = eval->var_arrays[i] * (double)1/eval->sample_rate;
     }
 
+    /* evaluate expression for all samples of each channel at once */
+    for (j = 0; j < eval->nb_channels; j++)
+        av_expr_eval_array(eval->expr[j], (double *)samplesref->extended_data[j],
+                           nb_samples, eval->var_values, arrays, NULL);
+
     samplesref->pts = eval->pts;
     samplesref->sample_rate = eval->sample_rate;
     eval->pts += nb_samples;
@@ -425,6 +444,35 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
 
     t0 = TS2T(in->pts, inlink->time_base);
 
+    if (!eval->uses_val) {
+        const double *arrays[VAR_VARS_NB] = { NULL };
+
+        av_fast_malloc(&eval->var_arrays, &eval->var_arrays_size,
+                       2 * nb_samples * sizeof(*eval->var_arrays));
+        if (!eval->var_arrays) {
+            av_frame_free(&in);
+            av_frame_free(&out);
+            return AVERROR(ENOMEM);
+        }
+        arrays[VAR_N] = eval->var_arrays;
+        arrays[VAR_T] = eval->var_arrays + nb_samples;
+
+        for (i = 0; i < nb_samples; i++, eval->n++) {
+            eval->var_arrays[i] = eval->n;
+            eval->var_arrays[nb_samples + i] = t0 + i * (double)1/inlink->sample_rate;
+        }
+
+        /* evaluate expression for all samples of each channel at once */
+        for (j = 0; j < outlink->ch_layout.nb_channels; j++) {
+            eval->var_values[VAR_CH] = j;
+            av_expr_eval_array(eval->expr[j], (double *)out->extended_data[j],
+                               nb_samples, eval->var_values, arrays, eval);
+        }
+
+        av_frame_free(&in);
+        return ff_filter_frame(outlink, out);
+    }
+
     /* evaluate expression for each single sample and for each channel */
     for (i = 0; i < nb_samples; i++, eval->n++) {
         eval->var_values[VAR_N] = eval->n;
@@ -46,9 +46,16 @@ struct FFFramePool {
     int align;
     int linesize[4];
     AVBufferPool *pools[4];
+    AVBufferRef* (*alloc)(size_t size);
 
 };
 
+static AVBufferRef *frame_pool_alloc(void *opaque, size_t size)
+{
+    FFFramePool *pool = opaque;
+    return pool->alloc ? pool->alloc(size) : av_buffer_alloc(size);
+}
+
 FFFramePool *ff_frame_pool_video_init(AVBufferRef* (*alloc)(size_t size),
                                       int width,
                                       int height,
@@ -69,6 +76,7 @@ FFFramePool *ff_frame_pool_video_init(AVBufferRef* (*alloc)(size_t size),
     pool->height = height;
     pool->format = format;
     pool->align = align;
+    pool->alloc = alloc;
 
     if ((ret = av_image_check_size2(width, height, INT64_MAX, format, 0, NULL)) < 0) {
         goto fail;
@@ -100,7 +108,9 @@ FFFramePool *ff_frame_pool_video_init(AVBufferRef* (*alloc)(size_t size),
     for (i = 0; i < 4 && sizes[i]; i++) {
         if (sizes[i] > SIZE_MAX - align)
             goto fail;
-        pool->pools[i] = av_buffer_pool_init(sizes[i] + align, alloc);
+        pool->pools[i] = av_buffer_pool_init3(sizes[i] + align, pool,
+                                              frame_pool_alloc, NULL,
+                                              AV_BUFFER_POOL_FLAG_THREAD_CACHE);
         if (!pool->pools[i])
             goto fail;
     }
@@ -141,7 +151,8 @@ FFFramePool *ff_frame_pool_audio_init(AVBufferRef* (*alloc)(size_t size),
 
     if (pool->linesize[0] > SIZE_MAX - align)
         goto fail;
-    pool->pools[0] = av_buffer_pool_init(pool->linesize[0] + align, NULL);
+    pool->pools[0] = av_buffer_pool_init3(pool->linesize[0] + align, NULL, NULL, NULL,
+                                          AV_BUFFER_POOL_FLAG_THREAD_CACHE);
     if (!pool->pools[0])
         goto fail;
 
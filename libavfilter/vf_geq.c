@@ -39,6 +39,7 @@
 
 #define MAX_NB_THREADS 32
 #define NB_PLANES 4
+#define ROW_BLOCK 256
 
 enum InterpolationMethods {
     INTERP_NEAREST,
@@ -58,6 +59,7 @@ typedef struct GEQContext {
     uint16_t *dst16;            ///< reference pointer to the 16bits output
     float *dst32;               ///< reference pointer to the 32bits output
     double values[VAR_VARS_NB]; ///< expression values
+    double *x_values;           ///< values of X for a whole row
     int hsub, vsub;             ///< chroma subsampling
     int planes;                 ///< number of planes
     int interpolation;
@@ -387,6 +389,14 @@ static int geq_config_props(AVFilterLink *inlink)
     geq->vsub = desc->log2_chroma_h;
     geq->bps = desc->comp[0].depth;
     geq->planes = desc->nb_components;
+
+    av_freep(&geq->x_values);
+    geq->x_values = av_malloc_array(inlink->w, sizeof(*geq->x_values));
+    if (!geq->x_values)
+        return AVERROR(ENOMEM);
+    for (int x = 0; x < inlink->w; x++)
+        geq->x_values[x] = x;
+
     return 0;
 }
 
@@ -410,6 +420,8 @@ static int slice_geq_filter(AVFilterContext *ctx, void *arg, int jobnr, int nb_j
     int x, y;
 
     double values[VAR_VARS_NB];
+    const double *arrays[VAR_VARS_NB] = { NULL };
+    double res[ROW_BLOCK];
     values[VAR_W] = geq->values[VAR_W];
     values[VAR_H] = geq->values[VAR_H];
     values[VAR_N] = geq->values[VAR_N];
@@ -417,36 +429,29 @@ static int slice_geq_filter(AVFilterContext *ctx, void *arg, int jobnr, int nb_j
     values[VAR_SH] = geq->values[VAR_SH];
     values[VAR_T] = geq->values[VAR_T];
 
-    if (geq->bps == 8) {
-        uint8_t *ptr = geq->dst + linesize * slice_start;
-        for (y = slice_start; y < slice_end; y++) {
-            values[VAR_Y] = y;
-
-            for (x = 0; x < width; x++) {
-                values[VAR_X] = x;
-                ptr[x] = av_expr_eval(geq->e[plane][jobnr], values, geq);
-            }
-            ptr += linesize;
-        }
-    } else if (geq->bps <= 16) {
-        uint16_t *ptr16 = geq->dst16 + (linesize/2) * slice_start;
-        for (y = slice_start; y < slice_end; y++) {
-            values[VAR_Y] = y;
-            for (x = 0; x < width; x++) {
-                values[VAR_X] = x;
-                ptr16[x] = av_expr_eval(geq->e[plane][jobnr], values, geq);
-            }
-            ptr16 += linesize/2;
-        }
-    } else {
-        float *ptr32 = geq->dst32 + (linesize/4) * slice_start;
-        for (y = slice_start; y < slice_end; y++) {
-            values[VAR_Y] = y;
-            for (x = 0; x < width; x++) {
-                values[VAR_X] = x;
-                ptr32[x] = av_expr_eval(geq->e[plane][jobnr], values, geq);
+    /* evaluate the expression for blocks of pixels of a row at once */
+    for (y = slice_start; y < slice_end; y++) {
+        values[VAR_Y] = y;
+
+        for (x = 0; x < width; x += ROW_BLOCK) {
+            const int n = FFMIN(width - x, ROW_BLOCK);
+
+            arrays[VAR_X] = geq->x_values + x;
+            av_expr_eval_array(geq->e[plane][jobnr], res, n, values, arrays, geq);
+
+            if (geq->bps == 8) {
+                uint8_t *ptr = geq->dst + linesize * y + x;
+                for (int i = 0; i < n; i++)
+                    ptr[i] = res[i];
+            } else if (geq->bps <= 16) {
+                uint16_t *ptr16 = geq->dst16 + (linesize/2) * y + x;
+                for (int i = 0; i < n; i++)
+                    ptr16[i] = res[i];
+            } else {
+                float *ptr32 = geq->dst32 + (linesize/4) * y + x;
+                for (int i = 0; i < n; i++)
+                    ptr32[i] = res[i];
             }
-            ptr32 += linesize/4;
         }
     }
 
@@ -515,6 +520,7 @@ static av_cold void geq_uninit(AVFilterContext *ctx)
             av_expr_free(geq->e[i][j]);
     for (i = 0; i < NB_PLANES; i++)
         av_freep(&geq->pixel_sums);
+    av_freep(&geq->x_values);
 }
 
 static const AVFilterPad geq_inputs[] = {
@@ -32,8 +32,11 @@
 
 #include "config.h"
 #include "adler32.h"
+#include "adler32_internal.h"
+#include "attributes.h"
 #include "intreadwrite.h"
 #include "macros.h"
+#include "thread.h"
 
 #define BASE 65521L /* largest prime smaller than 65536 */
 
@@ -41,7 +44,7 @@
 #define DO4(buf)  DO1(buf); DO1(buf); DO1(buf); DO1(buf);
 #define DO16(buf) DO4(buf); DO4(buf); DO4(buf); DO4(buf);
 
-AVAdler av_adler32_update(AVAdler adler, const uint8_t *buf, size_t len)
+AVAdler ff_adler32_update_c(AVAdler adler, const uint8_t *buf, size_t len)
 {
     unsigned long s1 = adler & 0xffff;
     unsigned long s2 = adler >> 16;
@@ -94,3 +97,25 @@ AVAdler av_adler32_update(AVAdler adler, const uint8_t *buf, size_t len)
     }
     return (s2 << 16) | s1;
 }
+
+av_cold void ff_adler32_init(FFAdler32UpdateFn *update)
+{
+    *update = ff_adler32_update_c;
+#if ARCH_X86
+    ff_adler32_init_x86(update);
+#endif
+}
+
+static FFAdler32UpdateFn adler32_update;
+static AVOnce adler32_once_control = AV_ONCE_INIT;
+
+static av_cold void adler32_init_once(void)
+{
+    ff_adler32_init(&adler32_update);
+}
+
+AVAdler av_adler32_update(AVAdler adler, const uint8_t *buf, size_t len)
+{
+    ff_thread_once(&adler32_once_control, adler32_init_once);
+    return adler32_update(adler, buf, len);
+}
@@ -0,0 +1,38 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVUTIL_ADLER32_INTERNAL_H
+#define AVUTIL_ADLER32_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "adler32.h"
+
+typedef AVAdler (*FFAdler32UpdateFn)(AVAdler adler, const uint8_t *buf, size_t len);
+
+AVAdler ff_adler32_update_c(AVAdler adler, const uint8_t *buf, size_t len);
+
+/**
+ * Set *update to the fastest av_adler32_update() implementation for the
+ * current CPU flags.
+ */
+void ff_adler32_init(FFAdler32UpdateFn *update);
+void ff_adler32_init_x86(FFAdler32UpdateFn *update);
+
+#endif /* AVUTIL_ADLER32_INTERNAL_H */
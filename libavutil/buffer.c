@@ -256,15 +256,27 @@ int av_buffer_replace(AVBufferRef **pdst, const AVBufferRef *src)
     return 0;
 }
 
-AVBufferPool *av_buffer_pool_init2(size_t size, void *opaque,
+AVBufferPool *av_buffer_pool_init3(size_t size, void *opaque,
                                    AVBufferRef* (*alloc)(void *opaque, size_t size),
-                                   void (*pool_free)(void *opaque))
+                                   void (*pool_free)(void *opaque), int flags)
 {
     AVBufferPool *pool = av_mallocz(sizeof(*pool));
     if (!pool)
         return NULL;
 
+    if (flags & AV_BUFFER_POOL_FLAG_THREAD_CACHE) {
+        pool->cache = av_malloc_array(BUFFER_POOL_MAGAZINES, sizeof(*pool->cache));
+        if (!pool->cache) {
+            av_free(pool);
+            return NULL;
+        }
+        for (int i = 0; i < BUFFER_POOL_MAGAZINES; i++)
+            for (int j = 0; j < BUFFER_POOL_MAGAZINE_SIZE; j++)
+                atomic_init(&pool->cache[i][j], 0);
+    }
+
     if (ff_mutex_init(&pool->mutex, NULL)) {
+        av_free(pool->cache);
         av_free(pool);
         return NULL;
     }
@@ -280,6 +292,13 @@ AVBufferPool *av_buffer_pool_init2(size_t size, void *opaque,
     return pool;
 }
 
+AVBufferPool *av_buffer_pool_init2(size_t size, void *opaque,
+                                   AVBufferRef* (*alloc)(void *opaque, size_t size),
+                                   void (*pool_free)(void *opaque))
+{
+    return av_buffer_pool_init3(size, opaque, alloc, pool_free, 0);
+}
+
 AVBufferPool *av_buffer_pool_init(size_t size, AVBufferRef* (*alloc)(size_t size))
 {
     AVBufferPool *pool = av_mallocz(sizeof(*pool));
@@ -299,14 +318,31 @@ AVBufferPool *av_buffer_pool_init(size_t size, AVBufferRef* (*alloc)(size_t size
     return pool;
 }
 
+static void buffer_pool_free_entry(BufferPoolEntry *buf)
+{
+    buf->free(buf->opaque, buf->data);
+    av_free(buf);
+}
+
 static void buffer_pool_flush(AVBufferPool *pool)
 {
     while (pool->pool) {
         BufferPoolEntry *buf = pool->pool;
         pool->pool = buf->next;
 
-        buf->free(buf->opaque, buf->data);
-        av_freep(&buf);
+        buffer_pool_free_entry(buf);
+    }
+
+    if (pool->cache) {
+        for (int i = 0; i < BUFFER_POOL_MAGAZINES; i++) {
+            for (int j = 0; j < BUFFER_POOL_MAGAZINE_SIZE; j++) {
+                BufferPoolEntry *buf = (BufferPoolEntry *)
+                    atomic_exchange_explicit(&pool->cache[i][j], 0,
+                                             memory_order_acquire);
+                if (buf)
+                    buffer_pool_free_entry(buf);
+            }
+        }
     }
 }
 
@@ -322,6 +358,7 @@ static void buffer_pool_free(AVBufferPool *pool)
     if (pool->pool_free)
         pool->pool_free(pool->opaque);
 
+    av_freep(&pool->cache);
     av_freep(&pool);
 }
 
@@ -342,15 +379,70 @@ void av_buffer_pool_uninit(AVBufferPool **ppool)
         buffer_pool_free(pool);
 }
 
+/*
+ * Pick the cache magazine for the calling thread. There is no thread-local
+ * storage to remember it in, but the stacks of different threads are far
+ * apart, so hashing the stack address spreads threads over the magazines
+ * and keeps each thread on the same one most of the time.
+ */
+static int pool_cache_magazine(void)
+{
+    char stack;
+    uint32_t hash = (uint32_t)((uintptr_t)&stack >> 16) * 0x9E3779B1U;
+
+    return (hash >> 24) % BUFFER_POOL_MAGAZINES;
+}
+
+/* Returns the entry displaced last if the magazine was full, NULL otherwise. */
+static BufferPoolEntry *pool_cache_push(AVBufferPool *pool, BufferPoolEntry *buf)
+{
+    atomic_uintptr_t *slots = pool->cache[pool_cache_magazine()];
+
+    for (int i = 0; i < BUFFER_POOL_MAGAZINE_SIZE && buf; i++) {
+        if (!atomic_load_explicit(&slots[i], memory_order_relaxed))
+            buf = (BufferPoolEntry *)atomic_exchange_explicit(&slots[i], (uintptr_t)buf,
+                                                              memory_order_acq_rel);
+    }
+
+    return buf;
+}
+
+static BufferPoolEntry *pool_cache_pop(AVBufferPool *pool)
+{
+    int first = pool_cache_magazine();
+
+    for (int i = 0; i < BUFFER_POOL_MAGAZINES; i++) {
+        atomic_uintptr_t *slots = pool->cache[(first + i) % BUFFER_POOL_MAGAZINES];
+
+        for (int j = 0; j < BUFFER_POOL_MAGAZINE_SIZE; j++) {
+            BufferPoolEntry *buf;
+
+            if (!atomic_load_explicit(&slots[j], memory_order_relaxed))
+                continue;
+            buf = (BufferPoolEntry *)atomic_exchange_explicit(&slots[j], 0,
+                                                              memory_order_acquire);
+            if (buf)
+                return buf;
+        }
+    }
+
+    return NULL;
+}
+
 static void pool_release_buffer(void *opaque, uint8_t *data)
 {
     BufferPoolEntry *buf = opaque;
     AVBufferPool *pool = buf->pool;
 
-    ff_mutex_lock(&pool->mutex);
-    buf->next = pool->pool;
-    pool->pool = buf;
-    ff_mutex_unlock(&pool->mutex);
+    if (pool->cache)
+        buf = pool_cache_push(pool, buf);
+
+    if (buf) {
+        ff_mutex_lock(&pool->mutex);
+        buf->next = pool->pool;
+        pool->pool = buf;
+        ff_mutex_unlock(&pool->mutex);
+    }
 
     if (atomic_fetch_sub_explicit(&pool->refcount, 1, memory_order_acq_rel) == 1)
         buffer_pool_free(pool);
@@ -387,26 +479,48 @@ static AVBufferRef *pool_alloc_buffer(AVBufferPool *pool)
     return ret;
 }
 
-AVBufferRef *av_buffer_pool_get(AVBufferPool *pool)
+/* make a new reference to the free entry buf, using its embedded AVBuffer */
+static AVBufferRef *pool_reuse_buffer(AVBufferPool *pool, BufferPoolEntry *buf)
 {
     AVBufferRef *ret;
-    BufferPoolEntry *buf;
 
-    ff_mutex_lock(&pool->mutex);
-    buf = pool->pool;
-    if (buf) {
-        memset(&buf->buffer, 0, sizeof(buf->buffer));
-        ret = buffer_create(&buf->buffer, buf->data, pool->size,
-                            pool_release_buffer, buf, 0);
-        if (ret) {
-            pool->pool = buf->next;
-            buf->next = NULL;
-            buf->buffer.flags_internal |= BUFFER_FLAG_NO_FREE;
+    memset(&buf->buffer, 0, sizeof(buf->buffer));
+    ret = buffer_create(&buf->buffer, buf->data, pool->size,
+                        pool_release_buffer, buf, 0);
+    if (ret)
+        buf->buffer.flags_internal |= BUFFER_FLAG_NO_FREE;
+
+    return ret;
+}
+
+AVBufferRef *av_buffer_pool_get(AVBufferPool *pool)
+{
+    AVBufferRef *ret = NULL;
+    BufferPoolEntry *buf = NULL;
+
+    if (pool->cache && (buf = pool_cache_pop(pool))) {
+        ret = pool_reuse_buffer(pool, buf);
+        if (!ret) {
+            ff_mutex_lock(&pool->mutex);
+            buf->next = pool->pool;
+            pool->pool = buf;
+            ff_mutex_unlock(&pool->mutex);
+            return NULL;
         }
     } else {
-        ret = pool_alloc_buffer(pool);
+        ff_mutex_lock(&pool->mutex);
+        buf = pool->pool;
+        if (buf) {
+            ret = pool_reuse_buffer(pool, buf);
+            if (ret) {
+                pool->pool = buf->next;
+                buf->next = NULL;
+            }
+        } else {
+            ret = pool_alloc_buffer(pool);
+        }
+        ff_mutex_unlock(&pool->mutex);
     }
-    ff_mutex_unlock(&pool->mutex);
 
     if (ret)
         atomic_fetch_add_explicit(&pool->refcount, 1, memory_order_relaxed);
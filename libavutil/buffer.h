@@ -284,6 +284,32 @@ AVBufferPool *av_buffer_pool_init2(size_t size, void *opaque,
                                    AVBufferRef* (*alloc)(void *opaque, size_t size),
                                    void (*pool_free)(void *opaque));
 
+/**
+ * Keep released buffers in a small lock-free cache in front of the pool's
+ * mutex-protected free list, with separate slots for different threads.
+ * This reduces lock contention when many threads get and release buffers
+ * from the same pool at the same time.
+ */
+#define AV_BUFFER_POOL_FLAG_THREAD_CACHE (1 << 0)
+
+/**
+ * Allocate and initialize a buffer pool with a more complex allocator and
+ * flags.
+ *
+ * @param size size of each buffer in this pool
+ * @param opaque arbitrary user data used by the allocator
+ * @param alloc a function that will be used to allocate new buffers when the
+ *              pool is empty. May be NULL, then the default allocator will be
+ *              used (av_buffer_alloc()).
+ * @param pool_free a function that will be called immediately before the pool
+ *                  is freed. May be NULL. See av_buffer_pool_init2().
+ * @param flags a combination of AV_BUFFER_POOL_FLAG_*
+ * @return newly created buffer pool on success, NULL on error.
+ */
+AVBufferPool *av_buffer_pool_init3(size_t size, void *opaque,
+                                   AVBufferRef* (*alloc)(void *opaque, size_t size),
+                                   void (*pool_free)(void *opaque), int flags);
+
 /**
  * Mark the pool as being available for freeing. It will actually be freed only
  * once all the allocated buffers associated with the pool are released. Thus it
@@ -85,10 +85,23 @@ typedef struct BufferPoolEntry {
     AVBuffer buffer;
 } BufferPoolEntry;
 
+#define BUFFER_POOL_MAGAZINES     8
+#define BUFFER_POOL_MAGAZINE_SIZE 8
+
 struct AVBufferPool {
     AVMutex mutex;
     BufferPoolEntry *pool;
 
+    /*
+     * Only allocated with AV_BUFFER_POOL_FLAG_THREAD_CACHE: free entries
+     * kept in front of pool, each slot holding a BufferPoolEntry pointer or 0.
+     * The slots are only ever swapped atomically, so they need no lock.
+     * Releasing threads fill the magazine picked for them and overflow into
+     * pool, getting threads look in their own magazine first, then in the
+     * others, then in pool.
+     */
+    atomic_uintptr_t (*cache)[BUFFER_POOL_MAGAZINE_SIZE];
+
     /*
      * This is used to track when the pool is to be freed.
      * The pointer to the pool itself held by the caller is considered to
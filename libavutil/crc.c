@@ -24,7 +24,9 @@
 #include "avassert.h"
 #include "bswap.h"
 #include "crc.h"
+#include "crc_internal.h"
 #include "error.h"
+#include "macros.h"
 
 #if CONFIG_HARDCODED_TABLES
 static const AVCRC av_crc_table[AV_CRC_MAX][257] = {
@@ -318,25 +320,52 @@ static const AVCRC av_crc_table[AV_CRC_MAX][257] = {
 #define CRC_TABLE_SIZE 1024
 #endif
 static AVCRC av_crc_table[AV_CRC_MAX][CRC_TABLE_SIZE];
+#endif
+
+static const struct {
+    uint8_t  le;
+    uint8_t  bits;
+    uint32_t poly;
+} crc_params[AV_CRC_MAX] = {
+    [AV_CRC_8_ATM]      = { 0,  8,       0x07 },
+    [AV_CRC_8_EBU]      = { 0,  8,       0x1D },
+    [AV_CRC_16_ANSI]    = { 0, 16,     0x8005 },
+    [AV_CRC_16_CCITT]   = { 0, 16,     0x1021 },
+    [AV_CRC_24_IEEE]    = { 0, 24,   0x864CFB },
+    [AV_CRC_32_IEEE]    = { 0, 32, 0x04C11DB7 },
+    [AV_CRC_32_IEEE_LE] = { 1, 32, 0xEDB88320 },
+    [AV_CRC_16_ANSI_LE] = { 1, 16,     0xA001 },
+};
+
+static FFCRC crc_ctx[AV_CRC_MAX];
+
+static void crc_init_table(AVCRCId id)
+{
+#if !CONFIG_HARDCODED_TABLES
+    av_assert0(av_crc_init(av_crc_table[id], crc_params[id].le, crc_params[id].bits,
+                           crc_params[id].poly, sizeof(av_crc_table[id])) >= 0);
+#endif
+    ff_crc_init(&crc_ctx[id], av_crc_table[id], crc_params[id].le,
+                crc_params[id].bits, crc_params[id].poly);
+}
 
-#define DECLARE_CRC_INIT_TABLE_ONCE(id, le, bits, poly)                                       \
+#define DECLARE_CRC_INIT_TABLE_ONCE(id)                                                       \
 static AVOnce id ## _once_control = AV_ONCE_INIT;                                             \
 static void id ## _init_table_once(void)                                                      \
 {                                                                                             \
-    av_assert0(av_crc_init(av_crc_table[id], le, bits, poly, sizeof(av_crc_table[id])) >= 0); \
+    crc_init_table(id);                                                                       \
 }
 
 #define CRC_INIT_TABLE_ONCE(id) ff_thread_once(&id ## _once_control, id ## _init_table_once)
 
-DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_8_ATM,      0,  8,       0x07)
-DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_8_EBU,      0,  8,       0x1D)
-DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_16_ANSI,    0, 16,     0x8005)
-DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_16_CCITT,   0, 16,     0x1021)
-DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_24_IEEE,    0, 24,   0x864CFB)
-DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_32_IEEE,    0, 32, 0x04C11DB7)
-DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_32_IEEE_LE, 1, 32, 0xEDB88320)
-DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_16_ANSI_LE, 1, 16,     0xA001)
-#endif
+DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_8_ATM)
+DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_8_EBU)
+DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_16_ANSI)
+DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_16_CCITT)
+DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_24_IEEE)
+DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_32_IEEE)
+DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_32_IEEE_LE)
+DECLARE_CRC_INIT_TABLE_ONCE(AV_CRC_16_ANSI_LE)
 
 int av_crc_init(AVCRC *ctx, int le, int bits, uint32_t poly, int ctx_size)
 {
@@ -373,7 +402,6 @@ int av_crc_init(AVCRC *ctx, int le, int bits, uint32_t poly, int ctx_size)
 
 const AVCRC *av_crc_get_table(AVCRCId crc_id)
 {
-#if !CONFIG_HARDCODED_TABLES
     switch (crc_id) {
     case AV_CRC_8_ATM:      CRC_INIT_TABLE_ONCE(AV_CRC_8_ATM); break;
     case AV_CRC_8_EBU:      CRC_INIT_TABLE_ONCE(AV_CRC_8_EBU); break;
@@ -385,12 +413,79 @@ const AVCRC *av_crc_get_table(AVCRCId crc_id)
     case AV_CRC_16_ANSI_LE: CRC_INIT_TABLE_ONCE(AV_CRC_16_ANSI_LE); break;
     default: av_assert0(0);
     }
-#endif
     return av_crc_table[crc_id];
 }
 
+/* x^n modulo x^32 + poly */
+static uint32_t xpow_mod(unsigned n, uint32_t poly)
+{
+    uint32_t r = 1;
+
+    while (n--)
+        r = (r << 1) ^ (poly & -(r >> 31));
+    return r;
+}
+
+static uint32_t reverse32(uint32_t x)
+{
+    uint32_t r = 0;
+
+    for (int i = 0; i < 32; i++)
+        r |= ((x >> i) & 1) << (31 - i);
+    return r;
+}
+
+static uint32_t crc_table(const FFCRC *c, uint32_t crc,
+                          const uint8_t *buffer, size_t length)
+{
+    return ff_crc_table(c->table, crc, buffer, length);
+}
+
+void ff_crc_init(FFCRC *c, const AVCRC *table, int le, int bits, uint32_t poly)
+{
+    static const unsigned dist[FF_CRC_FOLD_NB] = {
+        [FF_CRC_FOLD_2048] = 2048,
+        [FF_CRC_FOLD_512]  =  512,
+        [FF_CRC_FOLD_128]  =  128,
+    };
+    /* The table-driven code effectively computes a 32-bit CRC; for
+     * narrower ones, with the polynomial multiplied by x^(32-bits). */
+    uint32_t p = le ? reverse32(poly) : poly << (32 - bits);
+
+    for (int i = 0; i < FF_CRC_FOLD_NB; i++) {
+        unsigned n = dist[i];
+
+        if (le) {
+            c->fold[i][0] = (uint64_t)reverse32(xpow_mod(n + 63, p)) << 32;
+            c->fold[i][1] = (uint64_t)reverse32(xpow_mod(n -  1, p)) << 32;
+        } else {
+            c->fold[i][0] = xpow_mod(n,      p);
+            c->fold[i][1] = xpow_mod(n + 64, p);
+        }
+    }
+
+    c->table = table;
+    c->crc   = crc_table;
+
+#if ARCH_X86
+    ff_crc_init_x86(c, le);
+#endif
+}
+
 uint32_t av_crc(const AVCRC *ctx, uint32_t crc,
                 const uint8_t *buffer, size_t length)
+{
+    /* the standard tables may have faster implementations */
+    if (ctx >= av_crc_table[0] && ctx <= av_crc_table[AV_CRC_MAX - 1]) {
+        const FFCRC *c = &crc_ctx[(ctx - av_crc_table[0]) / FF_ARRAY_ELEMS(av_crc_table[0])];
+        return c->crc(c, crc, buffer, length);
+    }
+
+    return ff_crc_table(ctx, crc, buffer, length);
+}
+
+uint32_t ff_crc_table(const AVCRC *ctx, uint32_t crc,
+                      const uint8_t *buffer, size_t length)
 {
     const uint8_t *end = buffer + length;
 
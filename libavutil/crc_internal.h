@@ -0,0 +1,69 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVUTIL_CRC_INTERNAL_H
+#define AVUTIL_CRC_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc.h"
+#include "mem_internal.h"
+
+/**
+ * Folding distances, in bits, of the constants in FFCRC.fold.
+ */
+enum FFCRCFold {
+    FF_CRC_FOLD_2048,
+    FF_CRC_FOLD_512,
+    FF_CRC_FOLD_128,
+    FF_CRC_FOLD_NB,
+};
+
+typedef struct FFCRC {
+    /**
+     * Constants for folding a 128-bit block forward by n bits with carry-less
+     * multiplications: x^n and x^(n+64) modulo the CRC polynomial extended to
+     * 32 bits, for the low and high quadword of the block respectively.
+     * For bit-reversed CRCs, these are x^(n+63) and x^(n-1), bit-reversed
+     * into the upper half of each quadword, which accounts for the product
+     * of two reversed operands being one bit short.
+     */
+    DECLARE_ALIGNED(16, uint64_t, fold)[FF_CRC_FOLD_NB][2];
+
+    const AVCRC *table;
+
+    uint32_t (*crc)(const struct FFCRC *c, uint32_t crc,
+                    const uint8_t *buf, size_t length);
+} FFCRC;
+
+/**
+ * Initialize c for the CRC computed with the given table, with the
+ * parameters it was initialized with by av_crc_init().
+ */
+void ff_crc_init(FFCRC *c, const AVCRC *table, int le, int bits, uint32_t poly);
+
+/**
+ * Compute a CRC with the lookup table only.
+ */
+uint32_t ff_crc_table(const AVCRC *ctx, uint32_t crc,
+                      const uint8_t *buffer, size_t length);
+
+void ff_crc_init_x86(FFCRC *c, int le);
+
+#endif /* AVUTIL_CRC_INTERNAL_H */
@@ -19,6 +19,7 @@
  */
 
 #include <inttypes.h>
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -26,14 +27,118 @@
 #include "avstring.h"
 #include "dict.h"
 #include "error.h"
+#include "macros.h"
 #include "mem.h"
 #include "bprint.h"
 
+/* number of entries from which lookups use the hash index */
+#define DICT_INDEX_MIN 16
+
 struct AVDictionary {
     int count;
     AVDictionaryEntry *elems;
+
+    /*
+     * Hash index of the keys, case-insensitive, built once count reaches
+     * DICT_INDEX_MIN and rebuilt whenever count would exceed nb_buckets, with
+     * the smallest power of two of at least twice count buckets. buckets[]
+     * holds the first entry of each chain, next[] the following one
+     * (-1 terminated) and hashes[] the full hash of each entry. next[] and
+     * hashes[] have nb_buckets elements. nb_buckets is 0 when there is no
+     * index; lookups then fall back to a linear scan, as they do for
+     * AV_DICT_IGNORE_SUFFIX.
+     */
+    int nb_buckets;
+    int *buckets;
+    int *next;
+    uint32_t *hashes;
 };
 
+static uint32_t dict_hash(const char *key)
+{
+    uint32_t hash = 2166136261U;
+
+    while (*key)
+        hash = (hash ^ av_toupper(*key++)) * 16777619U;
+
+    return hash;
+}
+
+static void dict_index_free(AVDictionary *m)
+{
+    av_freep(&m->buckets);
+    av_freep(&m->next);
+    av_freep(&m->hashes);
+    m->nb_buckets = 0;
+}
+
+static void dict_index_link(AVDictionary *m, int i, uint32_t hash)
+{
+    int *head = &m->buckets[hash & (m->nb_buckets - 1)];
+
+    m->hashes[i] = hash;
+    m->next[i]   = *head;
+    *head        = i;
+}
+
+static void dict_index_unlink(AVDictionary *m, int i)
+{
+    int *link = &m->buckets[m->hashes[i] & (m->nb_buckets - 1)];
+
+    while (*link != i)
+        link = &m->next[*link];
+    *link = m->next[i];
+}
+
+/* Failing to build the index is not an error, lookups just stay linear. */
+static void dict_index_build(AVDictionary *m)
+{
+    int nb_buckets = 2 * DICT_INDEX_MIN;
+
+    dict_index_free(m);
+
+    /* size from count, not from nb_buckets, which is 0 after a failed build */
+    while (nb_buckets / 2 < m->count) {
+        if (nb_buckets > INT_MAX / 2)
+            return;
+        nb_buckets *= 2;
+    }
+
+    m->buckets = av_malloc_array(nb_buckets, sizeof(*m->buckets));
+    m->next    = av_malloc_array(nb_buckets, sizeof(*m->next));
+    m->hashes  = av_malloc_array(nb_buckets, sizeof(*m->hashes));
+    if (!m->buckets || !m->next || !m->hashes) {
+        dict_index_free(m);
+        return;
+    }
+
+    m->nb_buckets = nb_buckets;
+    for (int i = 0; i < nb_buckets; i++)
+        m->buckets[i] = -1;
+    for (int i = 0; i < m->count; i++)
+        dict_index_link(m, i, dict_hash(m->elems[i].key));
+}
+
+/* Entry with the lowest index after prev whose key is exactly key. */
+static AVDictionaryEntry *dict_index_get(const AVDictionary *m, const char *key,
+                                         const AVDictionaryEntry *prev, int flags)
+{
+    uint32_t hash = dict_hash(key);
+    int start = prev ? prev - m->elems + 1 : 0;
+    int found = -1;
+
+    for (int i = m->buckets[hash & (m->nb_buckets - 1)]; i >= 0; i = m->next[i]) {
+        const char *s = m->elems[i].key;
+
+        if (m->hashes[i] != hash || i < start || (found >= 0 && i > found))
+            continue;
+        if ((flags & AV_DICT_MATCH_CASE) ? !strcmp(s, key) : !av_strcasecmp(s, key))
+            found = i;
+    }
+
+    return found >= 0 ? &m->elems[found] : NULL;
+}
+
 int av_dict_count(const AVDictionary *m)
 {
     return m ? m->count : 0;
@@ -66,6 +171,9 @@ AVDictionaryEntry *av_dict_get(const AVDictionary *m, const char *key,
     if (!key)
         return NULL;
 
+    if (m && m->nb_buckets && !(flags & AV_DICT_IGNORE_SUFFIX))
+        return dict_index_get(m, key, prev, flags);
+
     while ((entry = av_dict_iterate(m, entry))) {
         const char *s = entry->key;
         if (flags & AV_DICT_MATCH_CASE)
@@ -142,6 +250,14 @@ int av_dict_set(AVDictionary **pm, const char *key, const char *value,
         } else
             av_free(tag->value);
         av_free(tag->key);
+        if (m->nb_buckets) {
+            int i = tag - m->elems, last = m->count - 1;
+            dict_index_unlink(m, i);
+            if (i != last) {
+                dict_index_unlink(m, last);
+                dict_index_link(m, i, m->hashes[last]);
+            }
+        }
         *tag = m->elems[--m->count];
     } else if (copy_value) {
         AVDictionaryEntry *tmp = av_realloc_array(m->elems,
@@ -154,6 +270,10 @@ int av_dict_set(AVDictionary **pm, const char *key, const char *value,
         m->elems[m->count].key = copy_key;
         m->elems[m->count].value = copy_value;
         m->count++;
+        if (m->count > m->nb_buckets && m->count >= DICT_INDEX_MIN)
+            dict_index_build(m);
+        else if (m->nb_buckets)
+            dict_index_link(m, m->count - 1, dict_hash(copy_key));
     } else {
         err = 0;
         goto end;
@@ -168,6 +288,7 @@ err_out:
 end:
     if (m && !m->count) {
         av_freep(&m->elems);
+        dict_index_free(m);
         av_freep(pm);
     }
     av_free(copy_key);
@@ -240,6 +361,7 @@ void av_dict_free(AVDictionary **pm)
             av_freep(&m->elems[m->count].value);
         }
         av_freep(&m->elems);
+        dict_index_free(m);
     }
     av_freep(pm);
 }
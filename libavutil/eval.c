@@ -35,6 +35,7 @@
 #include "log.h"
 #include "mathematics.h"
 #include "mem.h"
+#include "mem_internal.h"
 #include "sfc64.h"
 #include "time.h"
 #include "avstring.h"
@@ -45,6 +46,8 @@ typedef struct Parser {
     int stack_index;
     char *s;
     const double *const_values;
+    const double * const *const_arrays;       // per element values, see av_expr_eval_array()
+    int array_index;
     const char * const *const_names;          // NULL terminated
     double (* const *funcs1)(void *, double a);           // NULL terminated
     const char * const *func1_names;          // NULL terminated
@@ -155,6 +158,29 @@ static int strmatch(const char *s, const char *prefix)
     return !IS_IDENTIFIER_CHAR(s[i]);
 }
 
+/**
+ * Pure expressions are additionally lowered to a flat program working on
+ * blocks of EXPR_LANES elements at once, see compile_expr() and run_program().
+ * Every instruction evaluates one node of the tree for all elements of the
+ * block, reading its arguments from the registers dst, dst+1 and dst+2 and
+ * storing its result in dst, so the registers are used as a stack. Register
+ * files have 2 extra registers to keep the unused argument pointers valid.
+ */
+#define EXPR_LANES    32
+#define EXPR_MAX_REGS 32
+
+typedef struct ExprInsn {
+    const AVExpr *e;
+    int dst;
+} ExprInsn;
+
+typedef struct ExprProgram {
+    ExprInsn *insn;
+    int nb_insn;
+    int nb_regs;
+    int lazy_funcs; ///< user functions are only evaluated conditionally in the tree
+} ExprProgram;
+
 struct AVExpr {
     enum {
         e_value, e_const, e_func0, e_func1, e_func2,
@@ -176,6 +202,7 @@ struct AVExpr {
     struct AVExpr *param[3];
     double *var;
     FFSFC64 *prng_state;
+    ExprProgram *prog; // only set in the root node
 };
 
 static double etime(double v)
@@ -187,7 +214,9 @@ static double eval_expr(Parser *p, AVExpr *e)
 {
     switch (e->type) {
         case e_value:  return e->value;
-        case e_const:  return e->value * p->const_values[e->const_index];
+        case e_const:  return e->value * (p->const_arrays && p->const_arrays[e->const_index] ?
+                                          p->const_arrays[e->const_index][p->array_index] :
+                                          p->const_values[e->const_index]);
         case e_func0:  return e->value * e->a.func0(eval_expr(p, e->param[0]));
         case e_func1:  return e->value * e->a.func1(p->opaque, eval_expr(p, e->param[0]));
         case e_func2:  return e->value * e->a.func2(p->opaque, eval_expr(p, e->param[0]), eval_expr(p, e->param[1]));
@@ -363,6 +392,9 @@ void av_expr_free(AVExpr *e)
     av_expr_free(e->param[2]);
     av_freep(&e->var);
     av_freep(&e->prng_state);
+    if (e->prog)
+        av_freep(&e->prog->insn);
+    av_freep(&e->prog);
     av_freep(&e);
 }
 
@@ -707,6 +739,217 @@ static int verify_expr(AVExpr *e)
     }
 }
 
+static int expr_is_pure(const AVExpr *e)
+{
+    if (!e)
+        return 1;
+    switch (e->type) {
+    case e_st:
+    case e_while:
+    case e_taylor:
+    case e_root:
+    case e_random:
+    case e_randomi:
+    case e_print:
+        return 0;
+    default:
+        break;
+    }
+    return expr_is_pure(e->param[0]) && expr_is_pure(e->param[1]) &&
+           expr_is_pure(e->param[2]);
+}
+
+/**
+ * Replace all subtrees which do not depend on constants, variables, user
+ * functions or side effects by their value.
+ *
+ * @return 1 if e is a value after folding, 0 otherwise
+ */
+static int fold_expr(Parser *p, AVExpr *e)
+{
+    int is_value = 1;
+
+    for (int i = 0; i < 3; i++)
+        if (e->param[i] && !fold_expr(p, e->param[i]))
+            is_value = 0;
+
+    switch (e->type) {
+    case e_value:
+        return 1;
+    case e_func0:
+        if (e->a.func0 == etime)
+            return 0;
+        break;
+    case e_const:
+    case e_func1:
+    case e_func2:
+    case e_ld:
+    case e_st:
+    case e_while:
+    case e_taylor:
+    case e_root:
+    case e_random:
+    case e_randomi:
+    case e_print:
+        return 0;
+    default:
+        break;
+    }
+    if (!is_value)
+        return 0;
+
+    e->value = eval_expr(p, e);
+    e->type  = e_value;
+    for (int i = 0; i < 3; i++) {
+        av_expr_free(e->param[i]);
+        e->param[i] = NULL;
+    }
+    return 1;
+}
+
+static int count_nodes(const AVExpr *e)
+{
+    return e ? 1 + count_nodes(e->param[0]) + count_nodes(e->param[1]) +
+                   count_nodes(e->param[2]) : 0;
+}
+
+static int compile_expr(ExprProgram *prog, const AVExpr *e, int reg, int cond)
+{
+    int nb_args = 0;
+
+    for (int i = 0; i < 3 && e->param[i]; i++, nb_args++) {
+        int lazy = i && (e->type == e_if || e->type == e_ifnot || e->type == e_between);
+        int ret = compile_expr(prog, e->param[i], reg + i, cond || lazy);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (reg + FFMAX(nb_args, 1) > EXPR_MAX_REGS)
+        return AVERROR(ENOSPC);
+    prog->nb_regs = FFMAX(prog->nb_regs, reg + FFMAX(nb_args, 1));
+    if (cond && (e->type == e_func1 || e->type == e_func2))
+        prog->lazy_funcs = 1;
+
+    prog->insn[prog->nb_insn].e   = e;
+    prog->insn[prog->nb_insn].dst = reg;
+    prog->nb_insn++;
+    return 0;
+}
+
+/**
+ * Lower e to a program, which is left NULL if e has side effects or is too
+ * complex.
+ */
+static int compile_program(AVExpr *e)
+{
+    ExprProgram *prog;
+    int ret;
+
+    if (!expr_is_pure(e))
+        return 0;
+
+    prog = av_mallocz(sizeof(*prog));
+    if (!prog)
+        return AVERROR(ENOMEM);
+    prog->insn = av_malloc_array(count_nodes(e), sizeof(*prog->insn));
+    if (!prog->insn) {
+        av_free(prog);
+        return AVERROR(ENOMEM);
+    }
+
+    ret = compile_expr(prog, e, 0, 0);
+    if (ret < 0) {
+        av_free(prog->insn);
+        av_free(prog);
+        return ret == AVERROR(ENOSPC) ? 0 : ret;
+    }
+    e->prog = prog;
+    return 0;
+}
+
+/**
+ * Evaluate the program for n <= EXPR_LANES elements, the result is left in
+ * regs[0 .. n-1]. Register r starts at regs + r * stride.
+ */
+static void run_program(const ExprProgram *prog, double *regs, ptrdiff_t stride, int n,
+                        const double *const_values, const double * const *const_arrays,
+                        int offset, void *opaque, const double *var)
+{
+    for (int k = 0; k < prog->nb_insn; k++) {
+        const AVExpr *e = prog->insn[k].e;
+        double *d       = regs + prog->insn[k].dst * stride;
+        const double *a = d;
+        const double *b = d + stride;
+        const double *c = d + 2 * stride;
+        const double v  = e->value;
+
+#define LOOP(expr) for (int i = 0; i < n; i++) d[i] = expr; break
+        switch (e->type) {
+        case e_value:  LOOP(v);
+        case e_const:
+            if (const_arrays && const_arrays[e->const_index]) {
+                const double *src = const_arrays[e->const_index] + offset;
+                LOOP(v * src[i]);
+            } else {
+                const double x = v * const_values[e->const_index];
+                LOOP(x);
+            }
+        case e_func0:  LOOP(v * e->a.func0(a[i]));
+        case e_func1:  LOOP(v * e->a.func1(opaque, a[i]));
+        case e_func2:  LOOP(v * e->a.func2(opaque, a[i], b[i]));
+        case e_squish: LOOP(1/(1+exp(4*a[i])));
+        case e_gauss:  LOOP(exp(-a[i]*a[i]/2)/sqrt(2*M_PI));
+        case e_ld:     LOOP(v * var[av_clip(a[i], 0, VARS-1)]);
+        case e_isnan:  LOOP(v * !!isnan(a[i]));
+        case e_isinf:  LOOP(v * !!isinf(a[i]));
+        case e_floor:  LOOP(v * floor(a[i]));
+        case e_ceil:   LOOP(v * ceil (a[i]));
+        case e_trunc:  LOOP(v * trunc(a[i]));
+        case e_round:  LOOP(v * round(a[i]));
+        case e_sgn:    LOOP(v * FFDIFFSIGN(a[i], 0));
+        case e_sqrt:   LOOP(v * sqrt (a[i]));
+        case e_not:    LOOP(v * (a[i] == 0));
+        case e_if:
+            if (e->param[2]) {
+                LOOP(v * (a[i] ? b[i] : c[i]));
+            } else {
+                LOOP(v * (a[i] ? b[i] : 0));
+            }
+        case e_ifnot:
+            if (e->param[2]) {
+                LOOP(v * (!a[i] ? b[i] : c[i]));
+            } else {
+                LOOP(v * (!a[i] ? b[i] : 0));
+            }
+        case e_clip:
+            LOOP(isnan(b[i]) || isnan(c[i]) || isnan(a[i]) || b[i] > c[i] ?
+                 NAN : v * av_clipd(a[i], b[i], c[i]));
+        case e_between: LOOP(v * (a[i] >= b[i] && a[i] <= c[i]));
+        case e_lerp:   LOOP(a[i] + (b[i] - a[i]) * c[i]);
+        case e_mod:    LOOP(v * (a[i] - floor(b[i] ? a[i] / b[i] : a[i] * INFINITY) * b[i]));
+        case e_gcd:    LOOP(v * av_gcd(a[i], b[i]));
+        case e_max:    LOOP(v * (a[i] >  b[i] ? a[i] : b[i]));
+        case e_min:    LOOP(v * (a[i] <  b[i] ? a[i] : b[i]));
+        case e_eq:     LOOP(v * (a[i] == b[i] ? 1.0 : 0.0));
+        case e_gt:     LOOP(v * (a[i] >  b[i] ? 1.0 : 0.0));
+        case e_gte:    LOOP(v * (a[i] >= b[i] ? 1.0 : 0.0));
+        case e_lt:     LOOP(v * (a[i] <  b[i] ? 1.0 : 0.0));
+        case e_lte:    LOOP(v * (a[i] <= b[i] ? 1.0 : 0.0));
+        case e_pow:    LOOP(v * pow(a[i], b[i]));
+        case e_mul:    LOOP(v * (a[i] * b[i]));
+        case e_div:    LOOP(v * (b[i] ? (a[i] / b[i]) : a[i] * INFINITY));
+        case e_add:    LOOP(v * (a[i] + b[i]));
+        case e_last:   LOOP(v * b[i]);
+        case e_hypot:  LOOP(v * hypot(a[i], b[i]));
+        case e_atan2:  LOOP(v * atan2(a[i], b[i]));
+        case e_bitand: LOOP(isnan(a[i]) || isnan(b[i]) ? NAN : v * ((long int)a[i] & (long int)b[i]));
+        case e_bitor:  LOOP(isnan(a[i]) || isnan(b[i]) ? NAN : v * ((long int)a[i] | (long int)b[i]));
+        default:       LOOP(NAN);
+        }
+#undef LOOP
+    }
+}
+
 int av_expr_parse(AVExpr **expr, const char *s,
                   const char * const *const_names,
                   const char * const *func1_names, double (* const *funcs1)(void *, double),
@@ -749,6 +992,9 @@ int av_expr_parse(AVExpr **expr, const char *s,
         ret = AVERROR(EINVAL);
         goto end;
     }
+    fold_expr(&p, e);
+    if ((ret = compile_program(e)) < 0)
+        goto end;
     e->var= av_mallocz(sizeof(double) *VARS);
     e->prng_state = av_mallocz(sizeof(*e->prng_state) *VARS);
     if (!e->var || !e->prng_state) {
@@ -799,9 +1045,44 @@ double av_expr_eval(AVExpr *e, const double *const_values, void *opaque)
         .prng_state   = e->prng_state,
     };
 
+    if (e->prog && !e->prog->lazy_funcs) {
+        double regs[EXPR_MAX_REGS + 2];
+        run_program(e->prog, regs, 1, 1, const_values, NULL, 0, opaque, e->var);
+        return regs[0];
+    }
+
     return eval_expr(&p, e);
 }
 
+void av_expr_eval_array(AVExpr *e, double *res, int nb,
+                        const double *const_values,
+                        const double * const *const_arrays, void *opaque)
+{
+    Parser p = {
+        .class        = &eval_class,
+        .const_values = const_values,
+        .const_arrays = const_arrays,
+        .opaque       = opaque,
+        .var          = e->var,
+        .prng_state   = e->prng_state,
+    };
+
+    if (e->prog) {
+        DECLARE_ALIGNED(32, double, regs)[(EXPR_MAX_REGS + 2) * EXPR_LANES];
+
+        for (int i = 0; i < nb; i += EXPR_LANES) {
+            int n = FFMIN(nb - i, EXPR_LANES);
+            run_program(e->prog, regs, EXPR_LANES, n, const_values, const_arrays,
+                        i, opaque, e->var);
+            memcpy(res + i, regs, n * sizeof(*res));
+        }
+        return;
+    }
+
+    for (p.array_index = 0; p.array_index < nb; p.array_index++)
+        res[p.array_index] = eval_expr(&p, e);
+}
+
 int av_expr_parse_and_eval(double *d, const char *s,
                            const char * const *const_names, const double *const_values,
                            const char * const *func1_names, double (* const *funcs1)(void *, double),
@@ -87,6 +87,33 @@ int av_expr_parse(AVExpr **expr, const char *s,
  */
 double av_expr_eval(AVExpr *e, const double *const_values, void *opaque);
 
+/**
+ * Evaluate a previously parsed expression for an array of values of some
+ * of its constants.
+ *
+ * The result is the same as calling av_expr_eval() nb times, with the value
+ * of each constant i for which const_arrays[i] is not NULL taken from
+ * const_arrays[i][n] for the n-th evaluation. Expressions without side
+ * effects (st(), while(), random() etc.) are evaluated for many elements at
+ * once, which is much faster than separate av_expr_eval() calls.
+ *
+ * @note The functions from funcs1 and funcs2 may be called in any order and
+ *       also for arguments of if(), ifnot() and between() which are not
+ *       needed for the result, so they should not have side effects.
+ *
+ * @param e the AVExpr to evaluate
+ * @param res array of nb elements where the results are stored
+ * @param nb number of evaluations
+ * @param const_values array of values for the identifiers from av_expr_parse() const_names
+ * @param const_arrays NULL, or an array with an element for each identifier from
+ *                     av_expr_parse() const_names, which is either NULL to use the
+ *                     value from const_values or an array of nb values
+ * @param opaque a pointer which will be passed to all functions from funcs1 and funcs2
+ */
+void av_expr_eval_array(AVExpr *e, double *res, int nb,
+                        const double *const_values,
+                        const double * const *const_arrays, void *opaque);
+
 /**
  * Track the presence of variables and their number of occurrences in a parsed expression
  *
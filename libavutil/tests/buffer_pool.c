@@ -0,0 +1,162 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Multi-threaded AVBufferPool stress test and benchmark.
+ *
+ * Each thread keeps a few buffers from a shared pool at a time, stamps every
+ * buffer it gets and checks the stamp is intact before releasing it, which
+ * catches a buffer being handed out twice. Without arguments, this is run
+ * for a few thread counts, with and without AV_BUFFER_POOL_FLAG_THREAD_CACHE.
+ * With arguments, the get/release rate is printed for 1 to max_threads
+ * threads.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/buffer.h"
+#include "libavutil/common.h"
+#include "libavutil/error.h"
+#include "libavutil/thread.h"
+#include "libavutil/time.h"
+
+#define MAX_THREADS 64
+#define NB_HELD      4
+
+typedef struct ThreadData {
+    AVBufferPool *pool;
+    pthread_t     thread;
+    uint32_t      id;
+    int           nb_gets;
+    int           ret;
+} ThreadData;
+
+static void *worker(void *arg)
+{
+    ThreadData *td = arg;
+    AVBufferRef *held[NB_HELD] = { NULL };
+    uint32_t stamp[NB_HELD];
+
+    for (int i = 0; i < td->nb_gets + NB_HELD; i++) {
+        int slot = i % NB_HELD;
+
+        if (held[slot]) {
+            uint32_t *data = (uint32_t *)held[slot]->data;
+            if (data[0] != td->id || data[1] != stamp[slot]) {
+                fprintf(stderr, "thread %"PRIu32": buffer overwritten\n", td->id);
+                td->ret = AVERROR_BUG;
+            }
+            av_buffer_unref(&held[slot]);
+        }
+        if (i >= td->nb_gets)
+            continue;
+
+        held[slot] = av_buffer_pool_get(td->pool);
+        if (!held[slot]) {
+            td->ret = AVERROR(ENOMEM);
+            break;
+        }
+        stamp[slot] = i;
+        ((uint32_t *)held[slot]->data)[0] = td->id;
+        ((uint32_t *)held[slot]->data)[1] = i;
+    }
+
+    for (int i = 0; i < NB_HELD; i++)
+        av_buffer_unref(&held[i]);
+    return NULL;
+}
+
+static int run(int nb_threads, int nb_gets, int flags, double *gets_per_sec)
+{
+    ThreadData td[MAX_THREADS];
+    AVBufferPool *pool;
+    int64_t t0;
+    int ret = 0;
+
+    pool = av_buffer_pool_init3(64, NULL, NULL, NULL, flags);
+    if (!pool)
+        return AVERROR(ENOMEM);
+
+    t0 = av_gettime_relative();
+    for (int i = 0; i < nb_threads; i++) {
+        td[i] = (ThreadData){ .pool = pool, .id = i, .nb_gets = nb_gets };
+        if ((ret = pthread_create(&td[i].thread, NULL, worker, &td[i]))) {
+            nb_threads = i;
+            ret = AVERROR(ret);
+            break;
+        }
+    }
+    for (int i = 0; i < nb_threads; i++) {
+        pthread_join(td[i].thread, NULL);
+        if (td[i].ret < 0)
+            ret = td[i].ret;
+    }
+    if (gets_per_sec)
+        *gets_per_sec = (double)nb_threads * nb_gets /
+                        FFMAX(av_gettime_relative() - t0, 1) * 1000000;
+
+    av_buffer_pool_uninit(&pool);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static const int flags[] = { 0, AV_BUFFER_POOL_FLAG_THREAD_CACHE };
+    int max_threads, nb_gets, ret;
+
+    if (argc == 1) {
+        for (int nb_threads = 1; nb_threads <= 8; nb_threads *= 2) {
+            for (int i = 0; i < FF_ARRAY_ELEMS(flags); i++) {
+                ret = run(nb_threads, 20000, flags[i], NULL);
+                if (ret < 0) {
+                    fprintf(stderr, "%d threads, flags %d: %s\n",
+                            nb_threads, flags[i], av_err2str(ret));
+                    return 1;
+                }
+            }
+        }
+        return 0;
+    }
+
+    max_threads = av_clip(atoi(argv[1]), 1, MAX_THREADS);
+    nb_gets     = argc > 2 ? atoi(argv[2]) : 1000000;
+    if (nb_gets <= 0) {
+        fprintf(stderr, "Usage: %s [max_threads [gets_per_thread]]\n", argv[0]);
+        return 1;
+    }
+
+    printf("threads     locked Mgets/s   cached Mgets/s\n");
+    for (int nb_threads = 1; nb_threads <= max_threads; nb_threads++) {
+        double rate[FF_ARRAY_ELEMS(flags)];
+
+        for (int i = 0; i < FF_ARRAY_ELEMS(flags); i++) {
+            ret = run(nb_threads, nb_gets, flags[i], &rate[i]);
+            if (ret < 0) {
+                fprintf(stderr, "%d threads, flags %d: %s\n",
+                        nb_threads, flags[i], av_err2str(ret));
+                return 1;
+            }
+        }
+        printf("%7d %18.2f %16.2f\n", nb_threads, rate[0] / 1e6, rate[1] / 1e6);
+    }
+
+    return 0;
+}
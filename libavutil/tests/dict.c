@@ -50,6 +50,54 @@ static void print_dict(const AVDictionary *m)
     printf("\n");
 }
 
+/* av_dict_get() without the hash index */
+static const AVDictionaryEntry *dict_get_linear(const AVDictionary *m, const char *key,
+                                                const AVDictionaryEntry *prev, int flags)
+{
+    const AVDictionaryEntry *t = prev;
+
+    while ((t = av_dict_iterate(m, t)))
+        if ((flags & AV_DICT_MATCH_CASE) ? !strcmp(t->key, key) : !av_strcasecmp(t->key, key))
+            return t;
+    return NULL;
+}
+
+static int test_index(void)
+{
+    AVDictionary *dict = NULL;
+    char key[16], value[16];
+    int errors = 0;
+
+    for (int i = 0; i < 3000; i++) {
+        int n = (i * 7919) % 1000;
+        int flags = i % 5 == 4 ? AV_DICT_MULTIKEY : (i % 7 == 6) * AV_DICT_APPEND;
+
+        snprintf(key, sizeof(key), i & 1 ? "Key%d" : "kEY%d", n);
+        snprintf(value, sizeof(value), "%d", i);
+        if (av_dict_set(&dict, key, i % 11 == 10 ? NULL : value, flags) < 0)
+            return -1;
+    }
+    if (!dict->nb_buckets)
+        errors++;
+
+    for (int n = 0; n < 1100; n++) {
+        for (int flags = 0; flags <= AV_DICT_MATCH_CASE; flags += AV_DICT_MATCH_CASE) {
+            const AVDictionaryEntry *t = NULL;
+
+            snprintf(key, sizeof(key), n & 1 ? "key%d" : "KEY%d", n);
+            do {
+                const AVDictionaryEntry *ref = dict_get_linear(dict, key, t, flags);
+                t = av_dict_get(dict, key, t, flags);
+                errors += t != ref;
+            } while (t);
+        }
+    }
+
+    printf("%d entries, %d lookup errors\n", av_dict_count(dict), errors);
+    av_dict_free(&dict);
+    return 0;
+}
+
 static void test_separators(const AVDictionary *m, const char pair, const char val)
 {
     AVDictionary *dict = NULL;
@@ -163,5 +211,9 @@ int main(void)
     printf("%s\n", e->value);
     av_dict_free(&dict);
 
+    printf("\nTesting the hash index\n");
+    if (test_index() < 0)
+        return 1;
+
     return 0;
 }
@@ -37,6 +37,99 @@ static const char *const const_names[] = {
     0
 };
 
+static const char *const array_const_names[] = {
+    "X",
+    "Y",
+    0
+};
+
+static double array_func1(void *opaque, double x)
+{
+    return x * 0.5 + 1;
+}
+
+static double array_func2(void *opaque, double x, double y)
+{
+    return x - y * 3;
+}
+
+static double (* const array_funcs1[])(void *, double) = { array_func1, NULL };
+static const char *const array_func1_names[] = { "f", NULL };
+static double (* const array_funcs2[])(void *, double, double) = { array_func2, NULL };
+static const char *const array_func2_names[] = { "g", NULL };
+
+/* check av_expr_eval_array() against av_expr_eval() on a copy of the expression */
+static void test_eval_array(void)
+{
+    static const char *const exprs[] = {
+        "X",
+        "-X*Y+2^3",
+        "sin(X)+cos(Y)-tan(X/7)+exp(-abs(X))+log(Y)",
+        "sinh(X/9)+cosh(Y/9)+tanh(X)+atan(Y)+asin(1/(X+2))+acos(1/(Y+2))",
+        "squish(X)+gauss(Y)+isnan(log(X))+isinf(1/X)+floor(X/3)+ceil(Y/3)",
+        "trunc(-X/3)+round(Y/7)+sgn(X-Y)+sqrt(X)+not(X-Y)",
+        "mod(X,Y)+mod(-X,3)+max(X,Y)-min(X,-Y)+X/Y+X/0+gcd(X,Y)",
+        "eq(X,Y)+gt(X,Y)+gte(X,Y)+lt(X,Y)+lte(X,Y)+pow(Y,X/10)+hypot(X,Y)+atan2(X,Y)",
+        "if(mod(X,2), X, Y)+ifnot(gt(X,Y), X*2)+if(X, -Y)+ifnot(Y, 4, X)",
+        "bitand(X, 12)+bitor(X, Y)+bitand(X/0, 1)+between(X, Y, 2*Y)+clip(X, 3, Y)",
+        "clip(X, Y, 5)+lerp(X, Y, 0.25)+ld(3)+ld(X)-PI*E",
+        "f(X)*g(Y, X)+if(gt(X,5), f(Y), g(X, 1))",
+        "X;Y;-gauss(3);-squish(-X)",
+        "st(1, X+ld(1)); ld(1)*Y",
+        "while(lt(ld(0), X), st(0, ld(0)+1))+random(2)+randomi(3, X, Y)",
+        "time(0)*0+print(X, 48)",
+        NULL
+    };
+    double values[2], x[100], y[100], res[100];
+    const double *arrays[2][2] = { { x, y }, { x, NULL } };
+    int nb_errors = 0;
+
+    for (int i = 0; i < 100; i++) {
+        x[i] = i - 30;
+        y[i] = (i * 37 % 100) / 8.0;
+    }
+    values[1] = 0.75;
+
+    for (int k = 0; k < 2; k++) {
+        for (const char *const *expr = exprs; *expr; expr++) {
+            AVExpr *e1 = NULL, *e2 = NULL;
+
+            if (av_expr_parse(&e1, *expr, array_const_names,
+                              array_func1_names, array_funcs1,
+                              array_func2_names, array_funcs2, 0, NULL) < 0 ||
+                av_expr_parse(&e2, *expr, array_const_names,
+                              array_func1_names, array_funcs1,
+                              array_func2_names, array_funcs2, 0, NULL) < 0) {
+                printf("Failed to parse '%s'\n", *expr);
+                nb_errors++;
+                av_expr_free(e1);
+                continue;
+            }
+
+            av_expr_eval_array(e1, res, 100, values, arrays[k], NULL);
+            for (int i = 0; i < 100; i++) {
+                double ref;
+
+                values[0] = x[i];
+                if (arrays[k][1])
+                    values[1] = y[i];
+                ref = av_expr_eval(e2, values, NULL);
+                if (memcmp(&ref, &res[i], sizeof(ref)) && !(isnan(ref) && isnan(res[i]))) {
+                    printf("'%s' for X=%f Y=%f: %f != %f\n", *expr, values[0], values[1],
+                           res[i], ref);
+                    nb_errors++;
+                }
+            }
+            values[1] = 0.75;
+
+            av_expr_free(e1);
+            av_expr_free(e2);
+        }
+    }
+
+    printf("av_expr_eval_array: %d errors\n", nb_errors);
+}
+
 int main(int argc, char **argv)
 {
     int i;
@@ -168,6 +261,8 @@ int main(int argc, char **argv)
     if (ret < 0)
         printf("av_expr_parse_and_eval failed\n");
 
+    test_eval_array();
+
     if (argc > 1 && !strcmp(argv[1], "-t")) {
         for (i = 0; i < 1050; i++) {
             START_TIMER;
@@ -0,0 +1,88 @@
+;******************************************************************************
+;* Adler-32 checksum
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "x86util.asm"
+
+SECTION_RODATA 32
+
+; weight of each byte of a 64-byte block in the second sum
+adler32_taps: db 64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49
+              db 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33
+              db 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17
+              db 16, 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1
+pw_1:         times 16 dw 1
+
+SECTION .text
+
+;-----------------------------------------------------------------------------
+; void ff_adler32_sums(uint32_t sums[2], const uint8_t *buf, size_t len)
+;
+; Compute both sums of the Adler-32 of buf, starting from 0 and without
+; modulo. len must be a non-zero multiple of 64 and small enough for the sums
+; not to overflow.
+;-----------------------------------------------------------------------------
+%macro ADLER32_SUMS 0
+cglobal adler32_sums, 3, 3, 7, sums, buf, len
+    pxor           m0, m0     ; s1
+    pxor           m1, m1     ; s2 within each block
+    pxor           m2, m2     ; s1 at the start of each block
+    pxor           m3, m3
+    mova           m6, [pw_1]
+.loop:
+    paddd          m2, m0
+%assign i 0
+%rep 64 / mmsize
+    movu           m4, [bufq + i * mmsize]
+    psadbw         m5, m4, m3
+    pmaddubsw      m4, [adler32_taps + i * mmsize]
+    paddd          m0, m5
+    pmaddwd        m4, m6
+    paddd          m1, m4
+    %assign i i + 1
+%endrep
+    add          bufq, 64
+    sub          lenq, 64
+    jnz .loop
+
+    pslld          m2, 6
+    paddd          m1, m2
+%if mmsize == 32
+    vextracti128  xm4, m0, 1
+    paddd         xm0, xm4
+    vextracti128  xm4, m1, 1
+    paddd         xm1, xm4
+%endif
+    pshufd        xm4, xm0, q3232
+    paddd         xm0, xm4
+    pshufd        xm4, xm1, q3232
+    paddd         xm1, xm4
+    pshufd        xm4, xm1, q1111
+    paddd         xm1, xm4
+    movd   [sumsq + 0], xm0
+    movd   [sumsq + 4], xm1
+    RET
+%endmacro
+
+INIT_XMM ssse3
+ADLER32_SUMS
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+ADLER32_SUMS
+%endif
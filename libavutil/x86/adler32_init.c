@@ -0,0 +1,85 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "libavutil/adler32_internal.h"
+#include "libavutil/attributes.h"
+#include "libavutil/macros.h"
+#include "libavutil/x86/cpu.h"
+
+#if HAVE_X86ASM
+#define BASE 65521
+
+/* The second sum of N bytes computed from 0 is at most 255 * N * (N + 1) / 2,
+ * which fits in 32 bits up to N = 5803, i.e. 90 whole 64-byte blocks. */
+#define MAX_BLOCKS 90
+
+void ff_adler32_sums_ssse3(uint32_t sums[2], const uint8_t *buf, size_t len);
+void ff_adler32_sums_avx2(uint32_t sums[2], const uint8_t *buf, size_t len);
+
+static av_always_inline AVAdler adler32_update(AVAdler adler, const uint8_t *buf, size_t len,
+                                               void (*adler32_sums)(uint32_t sums[2],
+                                                                    const uint8_t *buf,
+                                                                    size_t len))
+{
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+
+    while (len >= 64) {
+        size_t n = FFMIN(len / 64, MAX_BLOCKS) * 64;
+        uint32_t sums[2];
+
+        adler32_sums(sums, buf, n);
+        s2 = (s2 + (uint64_t)s1 * n + sums[1]) % BASE;
+        s1 = (s1 + sums[0]) % BASE;
+        buf += n;
+        len -= n;
+    }
+
+    return ff_adler32_update_c((s2 << 16) | s1, buf, len);
+}
+
+static AVAdler adler32_update_ssse3(AVAdler adler, const uint8_t *buf, size_t len)
+{
+    return adler32_update(adler, buf, len, ff_adler32_sums_ssse3);
+}
+
+#if HAVE_AVX2_EXTERNAL
+static AVAdler adler32_update_avx2(AVAdler adler, const uint8_t *buf, size_t len)
+{
+    return adler32_update(adler, buf, len, ff_adler32_sums_avx2);
+}
+#endif
+#endif /* HAVE_X86ASM */
+
+av_cold void ff_adler32_init_x86(FFAdler32UpdateFn *update)
+{
+#if HAVE_X86ASM
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSSE3(cpu_flags))
+        *update = adler32_update_ssse3;
+#if HAVE_AVX2_EXTERNAL
+    if (EXTERNAL_AVX2_FAST(cpu_flags))
+        *update = adler32_update_avx2;
+#endif
+#endif
+}
@@ -0,0 +1,164 @@
+;******************************************************************************
+;* CRC computation with carry-less multiplications
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "x86util.asm"
+
+SECTION_RODATA
+
+pb_bswap128: db 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+
+SECTION .text
+
+; The message is split into 128-bit blocks, which are folded forward over
+; n bits by multiplying their two quadwords by x^n and x^(n+64) modulo the
+; polynomial, and xoring the (at most 96-bit) products into the block found
+; n bits further. For non-reflected CRCs, the bytes of each block are
+; swapped so that the bit order matches the one of the polynomial.
+
+; load a block (one per 128-bit lane) in polynomial bit order
+%macro LOAD_BLOCK 3 ; dst, src, bswap mask
+    movu          %1, %2
+%if BE
+    pshufb        %1, %3
+%endif
+%endmacro
+
+; dst ^= acc * k
+%macro FOLD 5 ; dst, acc, k, tmp1, tmp2
+    pclmulqdq     %4, %2, %3, 0x00
+    pclmulqdq     %5, %2, %3, 0x11
+    pxor          %1, %4
+    pxor          %1, %5
+%endmacro
+
+; acc = acc * k ^ src
+%macro FOLD_LOAD 6 ; acc, src, k, tmp1, tmp2, bswap mask
+    LOAD_BLOCK    %4, %2, %6
+    pclmulqdq     %5, %1, %3, 0x11
+    pclmulqdq     %1, %1, %3, 0x00
+    pxor          %1, %4
+    pxor          %1, %5
+%endmacro
+
+;-----------------------------------------------------------------------------
+; void ff_crc_fold_{be,le}(uint8_t *dst, uint32_t crc, const uint8_t *buf,
+;                          size_t len, const uint64_t (*k)[2])
+;-----------------------------------------------------------------------------
+%macro CRC_FOLD 1 ; be/le
+%ifidn %1, be
+    %define BE 1
+%else
+    %define BE 0
+%endif
+cglobal crc_fold_%1, 5, 5, 8, dst, crc, buf, len, k
+%if BE
+%if mmsize == 64
+    vbroadcasti32x4 m7, [pb_bswap128]
+%else
+    mova          m7, [pb_bswap128]
+%endif
+%endif
+    movd         xm4, crcd
+    movu          m0, [bufq]
+    pxor          m0, m4
+%if BE
+    pshufb        m0, m7
+%endif
+    LOAD_BLOCK    m1, [bufq+mmsize*1], m7
+    LOAD_BLOCK    m2, [bufq+mmsize*2], m7
+    LOAD_BLOCK    m3, [bufq+mmsize*3], m7
+    add         bufq, mmsize*4
+    sub         lenq, mmsize*4
+
+    ; fold 4 vectors at a time
+%if mmsize == 64
+    vbroadcasti32x4 m4, [kq+16*0] ; 2048 bits
+%else
+    mova          m4, [kq+16*1]   ; 512 bits
+%endif
+    cmp         lenq, mmsize*4
+    jb .fold_4_done
+.fold_4:
+    FOLD_LOAD     m0, [bufq+mmsize*0], m4, m5, m6, m7
+    FOLD_LOAD     m1, [bufq+mmsize*1], m4, m5, m6, m7
+    FOLD_LOAD     m2, [bufq+mmsize*2], m4, m5, m6, m7
+    FOLD_LOAD     m3, [bufq+mmsize*3], m4, m5, m6, m7
+    add         bufq, mmsize*4
+    sub         lenq, mmsize*4
+    cmp         lenq, mmsize*4
+    jae .fold_4
+.fold_4_done:
+
+    ; fold the 4 vectors into the last one
+%if mmsize == 64
+    vbroadcasti32x4 m4, [kq+16*1] ; 512 bits
+%else
+    mova          m4, [kq+16*2]   ; 128 bits
+%endif
+    FOLD          m1, m0, m4, m5, m6
+    FOLD          m2, m1, m4, m5, m6
+    FOLD          m3, m2, m4, m5, m6
+
+%if mmsize == 64
+    ; fold the remaining whole vectors, then the 4 lanes into the last one
+    cmp         lenq, mmsize
+    jb .fold_1_done
+.fold_1:
+    FOLD_LOAD     m3, [bufq], m4, m5, m6, m7
+    add         bufq, mmsize
+    sub         lenq, mmsize
+    cmp         lenq, mmsize
+    jae .fold_1
+.fold_1_done:
+    mova         xm4, [kq+16*2]   ; 128 bits
+    vextracti32x4 xm0, m3, 1
+    vextracti32x4 xm1, m3, 2
+    vextracti32x4 xm2, m3, 3
+    FOLD         xm0, xm3, xm4, xm5, xm6
+    FOLD         xm1, xm0, xm4, xm5, xm6
+    FOLD         xm2, xm1, xm4, xm5, xm6
+    mova         xm3, xm2
+%endif
+
+    ; fold the remaining blocks
+    test        lenq, lenq
+    jz .end
+.fold_block:
+    FOLD_LOAD    xm3, [bufq], xm4, xm5, xm6, xm7
+    add         bufq, 16
+    sub         lenq, 16
+    jnz .fold_block
+.end:
+%if BE
+    pshufb       xm3, xm7
+%endif
+    movu      [dstq], xm3
+    RET
+%endmacro
+
+INIT_XMM clmul
+CRC_FOLD be
+CRC_FOLD le
+
+%if HAVE_AVX512ICL_EXTERNAL
+INIT_ZMM avx512icl
+CRC_FOLD be
+CRC_FOLD le
+%endif
@@ -0,0 +1,88 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/crc_internal.h"
+#include "libavutil/mem_internal.h"
+#include "libavutil/x86/cpu.h"
+
+#if HAVE_X86ASM
+/**
+ * Fold len bytes of buf, with crc xored into its first 4 bytes, into a
+ * 16-byte block dst having the same CRC. len must be a multiple of 16 and
+ * at least 4 times the vector size.
+ */
+void ff_crc_fold_be_clmul(uint8_t *dst, uint32_t crc, const uint8_t *buf,
+                          size_t len, const uint64_t (*k)[2]);
+void ff_crc_fold_le_clmul(uint8_t *dst, uint32_t crc, const uint8_t *buf,
+                          size_t len, const uint64_t (*k)[2]);
+void ff_crc_fold_be_avx512icl(uint8_t *dst, uint32_t crc, const uint8_t *buf,
+                              size_t len, const uint64_t (*k)[2]);
+void ff_crc_fold_le_avx512icl(uint8_t *dst, uint32_t crc, const uint8_t *buf,
+                              size_t len, const uint64_t (*k)[2]);
+
+static av_always_inline uint32_t crc_fold(const FFCRC *c, uint32_t crc,
+                                          const uint8_t *buf, size_t length,
+                                          int le, int avx512)
+{
+    LOCAL_ALIGNED_16(uint8_t, block, [16]);
+    size_t len = length & ~(size_t)15;
+
+    if (avx512 && length >= 256) {
+        (le ? ff_crc_fold_le_avx512icl : ff_crc_fold_be_avx512icl)(block, crc, buf, len, c->fold);
+    } else if (length >= 64) {
+        (le ? ff_crc_fold_le_clmul : ff_crc_fold_be_clmul)(block, crc, buf, len, c->fold);
+    } else
+        return ff_crc_table(c->table, crc, buf, length);
+
+    crc = ff_crc_table(c->table, 0, block, 16);
+    return ff_crc_table(c->table, crc, buf + len, length - len);
+}
+
+#define CRC_FUNC(name, le, avx512)                                      \
+static uint32_t crc_ ## name(const FFCRC *c, uint32_t crc,              \
+                             const uint8_t *buf, size_t length)         \
+{                                                                       \
+    return crc_fold(c, crc, buf, length, le, avx512);                   \
+}
+
+CRC_FUNC(be_clmul,     0, 0)
+CRC_FUNC(le_clmul,     1, 0)
+#if HAVE_AVX512ICL_EXTERNAL
+CRC_FUNC(be_avx512icl, 0, 1)
+CRC_FUNC(le_avx512icl, 1, 1)
+#endif
+#endif /* HAVE_X86ASM */
+
+av_cold void ff_crc_init_x86(FFCRC *c, int le)
+{
+#if HAVE_X86ASM
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_CLMUL(cpu_flags))
+        c->crc = le ? crc_le_clmul : crc_be_clmul;
+#if HAVE_AVX512ICL_EXTERNAL
+    if (EXTERNAL_AVX512ICL(cpu_flags) && EXTERNAL_CLMUL(cpu_flags))
+        c->crc = le ? crc_le_avx512icl : crc_be_avx512icl;
+#endif
+#endif
+}
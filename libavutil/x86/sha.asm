@@ -0,0 +1,169 @@
+;******************************************************************************
+;* SHA-1 and SHA-256 block transforms using the SHA extensions
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "x86util.asm"
+
+; not in x86inc, SHA-NI implies SSE4.2 on every CPU implementing it
+%assign cpuflags_shani (1<<28) | cpuflags_sse42
+
+SECTION_RODATA
+
+pb_bswap128:   db 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0
+pb_bswap32:    db  3,  2,  1,  0,  7,  6,  5,  4, 11, 10,  9,  8, 15, 14, 13, 12
+
+sha256_k:      dd 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5
+               dd 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5
+               dd 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3
+               dd 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174
+               dd 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc
+               dd 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da
+               dd 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7
+               dd 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967
+               dd 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13
+               dd 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85
+               dd 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3
+               dd 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070
+               dd 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5
+               dd 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3
+               dd 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208
+               dd 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+
+SECTION .text
+
+%if ARCH_X86_64
+INIT_XMM shani
+
+;-----------------------------------------------------------------------------
+; void ff_sha1_transform(uint32_t *state, const uint8_t buffer[64])
+;-----------------------------------------------------------------------------
+; The 80 rounds are done in 20 groups of 4. Group g takes E from m(g&1) and
+; leaves the copy of ABCD the group after next derives its E from in the
+; other one. Each of the 16 message dwords in m2-m5 is expanded in place,
+; 4 groups before it is needed.
+%macro SHA1_ROUNDS4 1 ; group
+    %assign %%e  %1 & 1
+    %assign %%e1 %%e ^ 1
+    %assign %%m  2 + (%1 & 3)
+    %assign %%m1 2 + ((%1 + 1) & 3)
+    %assign %%m2 2 + ((%1 + 2) & 3)
+    %assign %%m3 2 + ((%1 + 3) & 3)
+%if %1 < 4
+    movu           m %+ %%m, [bufq + 16 * %1]
+    pshufb         m %+ %%m, m8
+%endif
+%if %1 == 0
+    paddd          m0, m2
+%else
+    sha1nexte      m %+ %%e, m %+ %%m
+%endif
+    mova           m %+ %%e1, m6
+%if %1 >= 3 && %1 <= 18
+    sha1msg2       m %+ %%m1, m %+ %%m
+%endif
+    sha1rnds4      m6, m %+ %%e, %1 / 5
+%if %1 >= 1 && %1 <= 16
+    sha1msg1       m %+ %%m3, m %+ %%m
+%endif
+%if %1 >= 2 && %1 <= 17
+    pxor           m %+ %%m2, m %+ %%m
+%endif
+%endmacro
+
+cglobal sha1_transform, 2, 2, 10, state, buf
+    movu           m6, [stateq]
+    pshufd         m6, m6, q0123        ; ABCD
+    pxor           m0, m0
+    pinsrd         m0, [stateq + 16], 3 ; E
+    mova           m8, [pb_bswap128]
+    mova           m7, m6
+    mova           m9, m0
+
+%assign i 0
+%rep 20
+    SHA1_ROUNDS4   i
+    %assign i i + 1
+%endrep
+
+    sha1nexte      m0, m9
+    paddd          m6, m7
+    pshufd         m6, m6, q0123
+    movu      [stateq], m6
+    pextrd    [stateq + 16], m0, 3
+    RET
+
+;-----------------------------------------------------------------------------
+; void ff_sha256_transform(uint32_t *state, const uint8_t buffer[64])
+;-----------------------------------------------------------------------------
+; sha256rnds2 implicitly takes the message plus round constants in m0.
+; m1/m2 hold ABEF/CDGH, the 16 message dwords are expanded in place in m3-m6.
+%macro SHA256_ROUNDS4 1 ; first round
+    %assign %%g  %1 / 4
+    %assign %%m  3 + (%%g & 3)
+    %assign %%m1 3 + ((%%g + 1) & 3)
+    %assign %%m3 3 + ((%%g + 3) & 3)
+%if %1 < 16
+    movu           m %+ %%m, [bufq + 4 * %1]
+    pshufb         m %+ %%m, m7
+%endif
+    mova           m0, [sha256_k + 4 * %1]
+    paddd          m0, m %+ %%m
+    sha256rnds2    m2, m1
+%if %1 >= 12 && %1 < 60
+    mova           m8, m %+ %%m
+    palignr        m8, m %+ %%m3, 4
+    paddd          m %+ %%m1, m8
+    sha256msg2     m %+ %%m1, m %+ %%m
+%endif
+    punpckhqdq     m0, m0
+    sha256rnds2    m1, m2
+%if %1 >= 4 && %1 < 52
+    sha256msg1     m %+ %%m3, m %+ %%m
+%endif
+%endmacro
+
+cglobal sha256_transform, 2, 2, 11, state, buf
+    movu           m1, [stateq]         ; DCBA
+    movu           m2, [stateq + 16]    ; HGFE
+    mova           m0, m1
+    punpcklqdq     m1, m2               ; FEBA
+    punpckhqdq     m2, m0               ; DCHG
+    pshufd         m1, m1, q0123        ; ABEF
+    pshufd         m2, m2, q2301        ; CDGH
+    mova           m7, [pb_bswap32]
+    mova           m9, m1
+    mova          m10, m2
+
+%assign i 0
+%rep 16
+    SHA256_ROUNDS4 i
+    %assign i i + 4
+%endrep
+
+    paddd          m1, m9
+    paddd          m2, m10
+    pshufd         m1, m1, q0123        ; FEBA
+    pshufd         m2, m2, q2301        ; DCHG
+    mova           m0, m1
+    pblendw        m1, m2, 0xF0         ; DCBA
+    palignr        m2, m0, 8            ; HGFE
+    movu      [stateq], m1
+    movu [stateq + 16], m2
+    RET
+%endif
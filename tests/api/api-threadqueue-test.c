@@ -0,0 +1,215 @@
+/*
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ * fftools ThreadQueue test and handoff benchmark
+ *
+ * One thread sends packets to two streams of a queue, another one receives
+ * them, checks their order and finishes the second stream half way through
+ * from the receiving side. This is done for both the locked and the lock-free
+ * single-producer queue, and the average handoff time per item is printed.
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "fftools/thread_queue.h"
+
+#include "libavcodec/packet.h"
+
+#include "libavutil/error.h"
+#include "libavutil/log.h"
+#include "libavutil/thread.h" // not public
+#include "libavutil/time.h"
+
+#define NB_STREAMS 2
+
+typedef struct ThreadData {
+    ThreadQueue *tq;
+    int          nb_items;
+    int          ret;
+} ThreadData;
+
+static void *sender_thread(void *arg)
+{
+    ThreadData *td = arg;
+    AVPacket *pkt = av_packet_alloc();
+    int stream_done[NB_STREAMS] = { 0 };
+    int ret = 0;
+
+    if (!pkt) {
+        td->ret = AVERROR(ENOMEM);
+        goto finish;
+    }
+
+    for (int i = 0; i < td->nb_items; i++) {
+        int stream_idx = i % NB_STREAMS;
+
+        if (stream_done[stream_idx])
+            continue;
+
+        pkt->pts = i;
+        ret = tq_send(td->tq, stream_idx, pkt, 0);
+        if (ret == AVERROR_EOF) {
+            av_packet_unref(pkt);
+            stream_done[stream_idx] = 1;
+        } else if (ret < 0) {
+            av_log(NULL, AV_LOG_ERROR, "sender: error sending item %d: %s\n",
+                   i, av_err2str(ret));
+            td->ret = ret;
+            break;
+        }
+    }
+
+finish:
+    for (int i = 0; i < NB_STREAMS; i++)
+        tq_send_finish(td->tq, i);
+
+    av_packet_free(&pkt);
+    return NULL;
+}
+
+static int receive_all(ThreadData *td)
+{
+    AVPacket *pkt = av_packet_alloc();
+    int64_t last_pts[NB_STREAMS] = { -1, -1 };
+    int got_eof[NB_STREAMS] = { 0 };
+    int nb_received = 0;
+    int ret = 0;
+
+    if (!pkt)
+        return AVERROR(ENOMEM);
+
+    while (1) {
+        int stream_idx;
+
+        ret = tq_receive(td->tq, &stream_idx, pkt, 0);
+        if (ret == AVERROR_EOF && stream_idx < 0) {
+            ret = 0;
+            break;
+        } else if (ret == AVERROR_EOF) {
+            if (got_eof[stream_idx]++) {
+                av_log(NULL, AV_LOG_ERROR, "receiver: duplicate EOF on stream %d\n",
+                       stream_idx);
+                ret = AVERROR_BUG;
+                break;
+            }
+            continue;
+        } else if (ret < 0) {
+            av_log(NULL, AV_LOG_ERROR, "receiver: error %s\n", av_err2str(ret));
+            break;
+        }
+
+        if (got_eof[stream_idx] || pkt->pts % NB_STREAMS != stream_idx ||
+            pkt->pts <= last_pts[stream_idx]) {
+            av_log(NULL, AV_LOG_ERROR, "receiver: unexpected item %"PRId64
+                   " on stream %d\n", pkt->pts, stream_idx);
+            ret = AVERROR_BUG;
+            break;
+        }
+        last_pts[stream_idx] = pkt->pts;
+        av_packet_unref(pkt);
+        nb_received++;
+
+        // stop accepting the second stream half way through
+        if (stream_idx == 1 && last_pts[1] >= td->nb_items / 2) {
+            tq_receive_finish(td->tq, 1);
+            got_eof[1] = 1;
+        }
+    }
+
+    // everything sent to the first stream must have arrived
+    if (!ret && last_pts[0] != (td->nb_items - 1) / NB_STREAMS * NB_STREAMS) {
+        av_log(NULL, AV_LOG_ERROR, "receiver: last item on stream 0 was %"PRId64"\n",
+               last_pts[0]);
+        ret = AVERROR_BUG;
+    }
+
+    av_packet_free(&pkt);
+    return ret < 0 ? ret : nb_received;
+}
+
+static int run_test(int nb_items, int queue_size, unsigned flags)
+{
+    ThreadData td = { .nb_items = nb_items };
+    pthread_t sender;
+    int64_t t0, t1;
+    int ret;
+
+    td.tq = tq_alloc(NB_STREAMS, queue_size, THREAD_QUEUE_PACKETS, flags);
+    if (!td.tq)
+        return AVERROR(ENOMEM);
+
+    t0 = av_gettime_relative();
+
+    ret = pthread_create(&sender, NULL, sender_thread, &td);
+    if (ret) {
+        tq_free(&td.tq);
+        return AVERROR(ret);
+    }
+
+    ret = receive_all(&td);
+    if (ret < 0) {
+        // make sure the sender does not block forever
+        for (int i = 0; i < NB_STREAMS; i++)
+            tq_receive_finish(td.tq, i);
+    }
+
+    pthread_join(sender, NULL);
+    t1 = av_gettime_relative();
+
+    if (ret >= 0 && td.ret < 0)
+        ret = td.ret;
+
+    if (ret >= 0)
+        av_log(NULL, AV_LOG_INFO, "%s: %d items received, %.1f ns/item\n",
+               (flags & THREAD_QUEUE_SINGLE_PRODUCER) ? "single producer" : "locked",
+               ret, ret ? (t1 - t0) * 1000.0 / ret : 0.0);
+
+    tq_free(&td.tq);
+    return ret;
+}
+
+int main(int ac, char **av)
+{
+    int nb_items, queue_size, ret;
+
+    if (ac != 3) {
+        av_log(NULL, AV_LOG_ERROR, "%s <nb_items> <queue_size>\n", av[0]);
+        return 1;
+    }
+
+    nb_items   = atoi(av[1]);
+    queue_size = atoi(av[2]);
+    if (nb_items <= 0 || queue_size <= 0) {
+        av_log(NULL, AV_LOG_ERROR, "Invalid arguments\n");
+        return 1;
+    }
+
+    ret = run_test(nb_items, queue_size, 0);
+    if (ret < 0)
+        return 1;
+
+    ret = run_test(nb_items, queue_size, THREAD_QUEUE_SINGLE_PRODUCER);
+    if (ret < 0)
+        return 1;
+
+    return 0;
+}
@@ -42,6 +42,8 @@
 static void test_abs_pow34(AACEncDSPContext *s)
 {
 #define BUF_SIZE 1024
+    /* scalefactor band sizes, called with 16-byte aligned pointers */
+    static const int band_sizes[] = { 4, 8, 12, 20, 28, 32, 44, 96 };
     LOCAL_ALIGNED_32(float, in, [BUF_SIZE]);
 
     declare_func(void, float *, const float *, int);
@@ -58,6 +60,19 @@ static void test_abs_pow34(AACEncDSPContext *s)
         if (!float_near_ulp_array(out, out2, 1, BUF_SIZE))
             fail();
 
+        for (int i = 0; i < FF_ARRAY_ELEMS(band_sizes); i++) {
+            int size = band_sizes[i], offset = 4 * (rnd() & 1);
+
+            memset(out,  0, BUF_SIZE * sizeof(*out));
+            memset(out2, 0, BUF_SIZE * sizeof(*out2));
+            call_ref(out  + offset, in + offset, size);
+            call_new(out2 + offset, in + offset, size);
+
+            /* also checks that nothing is written past the band */
+            if (!float_near_ulp_array(out, out2, 1, size + 16))
+                fail();
+        }
+
         bench_new(out, in, BUF_SIZE);
     }
 
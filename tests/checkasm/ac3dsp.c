@@ -25,7 +25,9 @@
 #include "libavutil/mem.h"
 #include "libavutil/mem_internal.h"
 
+#include "libavcodec/ac3defs.h"
 #include "libavcodec/ac3dsp.h"
+#include "libavcodec/ac3tab.h"
 
 #include "checkasm.h"
 
@@ -114,6 +116,52 @@ static void check_ac3_extract_exponents(AC3DSPContext *c) {
     report("ac3_extract_exponents");
 }
 
+static void check_ac3_bit_alloc_calc_bap(AC3DSPContext *c) {
+    /* full range, LFE, a partial band at each end, short ranges */
+    static const int ranges[][2] = {
+        { 0, 253 }, { 0, 7 }, { 37, 253 }, { 13, 229 }, { 100, 110 },
+        { 29, 45 }, { 240, 253 }, { 5, 6 },
+    };
+    LOCAL_ALIGNED_16(int16_t, mask, [AC3_CRITICAL_BANDS]);
+    LOCAL_ALIGNED_16(int16_t, psd, [AC3_MAX_COEFS]);
+    LOCAL_ALIGNED_16(uint8_t, bap_tab, [64]);
+    LOCAL_ALIGNED_16(uint8_t, v1, [AC3_MAX_COEFS]);
+    LOCAL_ALIGNED_16(uint8_t, v2, [AC3_MAX_COEFS]);
+    int i, n;
+
+    declare_func(void, int16_t *, int16_t *, int, int, int, int,
+                 const uint8_t *, uint8_t *);
+
+    for (i = 0; i < AC3_CRITICAL_BANDS; i++)
+        mask[i] = rnd() % 6144 - 1024;
+    for (i = 0; i < AC3_MAX_COEFS; i++)
+        psd[i] = rnd() % 4096 - 512;
+    for (i = 0; i < 64; i++)
+        bap_tab[i] = rnd();
+
+    if (check_func(c->bit_alloc_calc_bap, "ac3_bit_alloc_calc_bap")) {
+        for (n = 0; n < FF_ARRAY_ELEMS(ranges) * 8; n++) {
+            int start  = ranges[n >> 3][0];
+            int end    = ranges[n >> 3][1];
+            int snr    = n & 7 ? (((rnd() % 64 - 15) << 4) + rnd() % 16) << 2 : -960;
+            int floor  = ff_ac3_floor_tab[rnd() % 8];
+
+            for (i = 0; i < AC3_MAX_COEFS; i++)
+                v1[i] = v2[i] = rnd();
+
+            call_ref(mask, psd, start, end, snr, floor, bap_tab, v1);
+            call_new(mask, psd, start, end, snr, floor, bap_tab, v2);
+
+            if (memcmp(v1, v2, AC3_MAX_COEFS) != 0)
+                fail();
+        }
+
+        bench_new(mask, psd, 0, 253, 0, ff_ac3_floor_tab[4], bap_tab, v2);
+    }
+
+    report("ac3_bit_alloc_calc_bap");
+}
+
 static void check_float_to_fixed24(AC3DSPContext *c) {
 #define BUF_SIZE 1024
     LOCAL_ALIGNED_32(float, src, [BUF_SIZE]);
@@ -197,6 +245,7 @@ void checkasm_check_ac3dsp(void)
 
     check_ac3_exponent_min(&c);
     check_ac3_extract_exponents(&c);
+    check_ac3_bit_alloc_calc_bap(&c);
     check_float_to_fixed24(&c);
     check_ac3_sum_square_butterfly_int32(&c);
     check_ac3_sum_square_butterfly_float(&c);
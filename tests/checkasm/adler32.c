@@ -0,0 +1,59 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "checkasm.h"
+#include "libavutil/adler32.h"
+#include "libavutil/adler32_internal.h"
+#include "libavutil/mem_internal.h"
+
+#define BUF_SIZE 16384
+
+void checkasm_check_adler32(void)
+{
+    DECLARE_ALIGNED(32, uint8_t, buf)[BUF_SIZE + 64];
+    FFAdler32UpdateFn update;
+
+    ff_adler32_init(&update);
+
+    if (check_func(update, "adler32_update")) {
+        declare_func(AVAdler, AVAdler adler, const uint8_t *buf, size_t len);
+
+        for (int i = 0; i < 2; i++) {
+            // the second pass checks the sums cannot overflow on 0xFF bytes
+            for (int j = 0; j < BUF_SIZE + 64; j++)
+                buf[j] = i ? 0xFF : rnd();
+
+            for (size_t len = 0; len <= BUF_SIZE; len += 1 + (rnd() % 509)) {
+                const uint8_t *src = buf + (rnd() & 63);
+                AVAdler adler = i ? 0xFFF0FFF0 : (rnd() % 65521) | (rnd() % 65521) << 16;
+                AVAdler ref = call_ref(adler, src, len);
+                AVAdler new = call_new(adler, src, len);
+
+                if (ref != new) {
+                    fprintf(stderr, "adler32: length %zu: %08lx != %08lx\n",
+                            len, (unsigned long)ref, (unsigned long)new);
+                    fail();
+                    break;
+                }
+            }
+        }
+        bench_new(1, buf, BUF_SIZE);
+    }
+
+    report("adler32");
+}
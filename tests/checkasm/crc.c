@@ -0,0 +1,77 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "checkasm.h"
+#include "libavutil/crc.h"
+#include "libavutil/crc_internal.h"
+#include "libavutil/mem_internal.h"
+
+#define BUF_SIZE 4096
+
+static const struct {
+    const char *name;
+    AVCRCId     id;
+    int         le;
+    int         bits;
+    uint32_t    poly;
+} crcs[] = {
+    { "8_atm",       AV_CRC_8_ATM,      0,  8,       0x07 },
+    { "8_ebu",       AV_CRC_8_EBU,      0,  8,       0x1D },
+    { "16_ansi",     AV_CRC_16_ANSI,    0, 16,     0x8005 },
+    { "16_ccitt",    AV_CRC_16_CCITT,   0, 16,     0x1021 },
+    { "24_ieee",     AV_CRC_24_IEEE,    0, 24,   0x864CFB },
+    { "32_ieee",     AV_CRC_32_IEEE,    0, 32, 0x04C11DB7 },
+    { "32_ieee_le",  AV_CRC_32_IEEE_LE, 1, 32, 0xEDB88320 },
+    { "16_ansi_le",  AV_CRC_16_ANSI_LE, 1, 16,     0xA001 },
+};
+
+void checkasm_check_crc(void)
+{
+    DECLARE_ALIGNED(64, uint8_t, buf)[BUF_SIZE + 64];
+    FFCRC c;
+
+    for (int i = 0; i < BUF_SIZE + 64; i++)
+        buf[i] = rnd();
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(crcs); i++) {
+        ff_crc_init(&c, av_crc_get_table(crcs[i].id), crcs[i].le,
+                    crcs[i].bits, crcs[i].poly);
+
+        if (check_func(c.crc, "crc_%s", crcs[i].name)) {
+            declare_func(uint32_t, const FFCRC *c, uint32_t crc,
+                         const uint8_t *buf, size_t length);
+
+            for (size_t len = 0; len <= BUF_SIZE; len += 1 + (rnd() & 63)) {
+                const uint8_t *src = buf + (rnd() & 63);
+                uint32_t crc = rnd();
+                uint32_t ref = call_ref(&c, crc, src, len);
+                uint32_t new = call_new(&c, crc, src, len);
+
+                if (ref != new) {
+                    fprintf(stderr, "crc_%s: length %zu: %08"PRIx32" != %08"PRIx32"\n",
+                            crcs[i].name, len, ref, new);
+                    fail();
+                    break;
+                }
+            }
+            bench_new(&c, 0, buf, BUF_SIZE);
+        }
+    }
+
+    report("crc");
+}
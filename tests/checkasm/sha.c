@@ -0,0 +1,59 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavutil/sha.h"
+#include "libavutil/sha_internal.h"
+
+#define NB_BLOCKS 8
+
+void checkasm_check_sha(void)
+{
+    static const int bits[] = { 160, 224, 256 };
+    uint8_t buf[NB_BLOCKS][64];
+    AVSHA ctx;
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(bits); i++) {
+        av_sha_init(&ctx, bits[i]);
+
+        if (check_func(ctx.transform, "sha%d_transform", bits[i])) {
+            declare_func(void, uint32_t *state, const uint8_t buffer[64]);
+            uint32_t state_ref[8], state_new[8];
+
+            for (int j = 0; j < NB_BLOCKS; j++)
+                for (int k = 0; k < sizeof(buf[j]); k++)
+                    buf[j][k] = rnd();
+
+            memcpy(state_ref, ctx.state, sizeof(state_ref));
+            memcpy(state_new, ctx.state, sizeof(state_new));
+            for (int j = 0; j < NB_BLOCKS; j++) {
+                call_ref(state_ref, buf[j]);
+                call_new(state_new, buf[j]);
+                if (memcmp(state_ref, state_new, sizeof(state_ref))) {
+                    fail();
+                    break;
+                }
+            }
+            bench_new(state_new, buf[0]);
+        }
+    }
+
+    report("sha");
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "checkasm.h"
+#include "libavcodec/defs.h"
+#include "libavcodec/startcode.h"
+#include "libavutil/macros.h"
+#include "libavutil/mem_internal.h"
+
+#define BUF_SIZE 1024
+#define MAX_OFFSET 32
+
+void checkasm_check_startcode(void)
+{
+    LOCAL_ALIGNED_32(uint8_t, buf, [MAX_OFFSET + BUF_SIZE + AV_INPUT_BUFFER_PADDING_SIZE]);
+    ff_startcode_find_candidate_fn find_candidate = ff_startcode_find_candidate_get();
+
+    declare_func(int, const uint8_t *buf, int size);
+
+    for (int i = 0; i < MAX_OFFSET + BUF_SIZE + AV_INPUT_BUFFER_PADDING_SIZE; i++)
+        buf[i] = 1 + rnd() % 255;
+
+    if (check_func(find_candidate, "startcode_find_candidate")) {
+        for (int i = 0; i < 1024; i++) {
+            int offset = rnd() % MAX_OFFSET;
+            int size   = i < 256 ? i : rnd() % (BUF_SIZE + 1);
+            // Zero bytes before, inside and after the searched range,
+            // or none at all.
+            int nb_zeros = rnd() % 3;
+            int zeros[2];
+            int ref, new;
+
+            for (int j = 0; j < nb_zeros; j++) {
+                zeros[j] = offset + rnd() % (size + AV_INPUT_BUFFER_PADDING_SIZE);
+                buf[zeros[j]] = 0;
+            }
+
+            ref = call_ref(buf + offset, size);
+            new = call_new(buf + offset, size);
+            if (FFMIN(ref, size) != FFMIN(new, size)) {
+                fprintf(stderr, "startcode_find_candidate: size %d offset %d: "
+                        "%d != %d\n", size, offset, ref, new);
+                fail();
+            }
+
+            for (int j = 0; j < nb_zeros; j++)
+                buf[zeros[j]] = 1 + rnd() % 255;
+        }
+        bench_new(buf, BUF_SIZE);
+    }
+
+    report("startcode_find_candidate");
+}
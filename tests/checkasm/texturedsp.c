@@ -0,0 +1,94 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "checkasm.h"
+#include "libavcodec/texturedsp.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem_internal.h"
+
+#define STRIDE   (TEXTURE_BLOCK_W * 4 + 16)
+#define BUF_SIZE (TEXTURE_BLOCK_H * STRIDE)
+
+static void randomize_block(uint8_t *block, int i)
+{
+    for (int j = 0; j < 16; j += 4)
+        AV_WN32A(block + j, rnd());
+
+    /* exercise both orderings of the endpoints, including equal ones */
+    if (i & 1) {
+        memcpy(block + 2, block, 2);
+        memcpy(block + 10, block + 8, 2);
+    }
+}
+
+static void check_block(int (*func)(uint8_t *dst, ptrdiff_t stride, const uint8_t *block),
+                        const char *name)
+{
+    LOCAL_ALIGNED_16(uint8_t, block,   [16]);
+    LOCAL_ALIGNED_16(uint8_t, dst_ref, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst_new, [BUF_SIZE]);
+
+    declare_func(int, uint8_t *dst, ptrdiff_t stride, const uint8_t *block);
+
+    if (check_func(func, "%s", name)) {
+        for (int i = 0; i < 32; i++) {
+            int ret_ref, ret_new;
+
+            randomize_block(block, i);
+            for (int j = 0; j < BUF_SIZE; j += 4)
+                AV_WN32A(dst_ref + j, rnd());
+            memcpy(dst_new, dst_ref, BUF_SIZE);
+
+            ret_ref = call_ref(dst_ref, STRIDE, block);
+            ret_new = call_new(dst_new, STRIDE, block);
+            if (ret_ref != ret_new || memcmp(dst_ref, dst_new, BUF_SIZE))
+                fail();
+        }
+        bench_new(dst_new, STRIDE, block);
+    }
+}
+
+void checkasm_check_texturedsp(void)
+{
+    TextureDSPContext c;
+
+    ff_texturedsp_init(&c);
+
+#define CHECK(name) check_block(c.name, #name)
+    CHECK(dxt1_block);
+    CHECK(dxt1a_block);
+    CHECK(dxt2_block);
+    CHECK(dxt3_block);
+    CHECK(dxt4_block);
+    CHECK(dxt5_block);
+    CHECK(dxt5y_block);
+    CHECK(dxt5ys_block);
+    CHECK(rgtc1s_block);
+    CHECK(rgtc1u_block);
+    CHECK(rgtc1u_gray_block);
+    CHECK(rgtc1u_alpha_block);
+    CHECK(rgtc2s_block);
+    CHECK(rgtc2u_block);
+    CHECK(dxn3dc_block);
+#undef CHECK
+
+    report("texturedsp");
+}
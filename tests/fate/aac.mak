@@ -166,6 +166,16 @@ fate-aac-aref-encode: CMP_TARGET = 596
 fate-aac-aref-encode: SIZE_TOLERANCE = 2464
 fate-aac-aref-encode: FUZZ = 89
 
+# 5.1 has several channel elements, which slice threads search concurrently.
+# The threaded encode must be bit-identical to the serial one.
+FATE_AAC_FFMPEG-$(call ENCMUX, AAC, ADTS, ARESAMPLE_FILTER) += fate-aac-aref-encode-5.1 fate-aac-aref-encode-5.1-threads
+fate-aac-aref-encode-5.1 fate-aac-aref-encode-5.1-threads: tests/data/asynth-44100-6.wav
+fate-aac-aref-encode-5.1 fate-aac-aref-encode-5.1-threads: SRC = $(TARGET_PATH)/tests/data/asynth-44100-6.wav
+fate-aac-aref-encode-5.1: CMD = md5 -i $(SRC) -c:a aac -b:a 384k -f adts -fflags +bitexact -flags +bitexact -af aresample
+fate-aac-aref-encode-5.1-threads: CMD = md5 -i $(SRC) -c:a aac -b:a 384k -f adts -fflags +bitexact -flags +bitexact -af aresample -threads 4 -thread_type slice
+fate-aac-aref-encode-5.1 fate-aac-aref-encode-5.1-threads: CMP = oneline
+fate-aac-aref-encode-5.1 fate-aac-aref-encode-5.1-threads: REF = b712a8d132e087d8f9f6f570c6625a7d
+
 FATE_AAC_ENCODE += fate-aac-ln-encode
 fate-aac-ln-encode: CMD = enc_dec_pcm adts wav s16le $(TARGET_SAMPLES)/audio-reference/luckynight_2ch_44kHz_s16.wav -c:a aac -aac_coder fast -aac_is 0 -aac_pns 0 -aac_ms 0 -aac_tns 0 -b:a 512k -fflags +bitexact -flags +bitexact
 fate-aac-ln-encode: CMP = stddev
@@ -257,5 +267,7 @@ FATE_AAC_BSF-$(call ALLYES, AAC_DEMUXER AAC_ADTSTOASC_BSF MATROSKA_MUXER) += fat
 
 FATE_SAMPLES_FFMPEG += $(FATE_AAC_ALL) $(FATE_AAC_ENCODE-yes) $(FATE_AAC_BSF-yes)
 
-fate-aac: $(FATE_AAC_ALL) $(FATE_AAC_ENCODE) $(FATE_AAC_BSF-yes)
+FATE_FFMPEG += $(FATE_AAC_FFMPEG-yes)
+
+fate-aac: $(FATE_AAC_ALL) $(FATE_AAC_ENCODE) $(FATE_AAC_BSF-yes) $(FATE_AAC_FFMPEG-yes)
 fate-aac-latm: $(FATE_AAC_LATM-yes)
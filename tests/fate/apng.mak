@@ -15,5 +15,10 @@ fate-apng-dispose-background2: CMD = framecrc -i $(TARGET_SAMPLES)/apng/alogo.pn
 
 FATE_APNG-$(call DEMDEC, APNG, APNG) += $(FATE_APNG)
 
+# Difference frames cropped narrower than the image, encoded in slices.
+FATE_APNG_FFMPEG-$(call ALLYES, LAVFI_INDEV COLOR_FILTER FORMAT_FILTER GEQ_FILTER APNG_ENCODER FRAMECRC_MUXER PIPE_PROTOCOL) += fate-apng-enc-slices
+fate-apng-enc-slices: CMD = framecrc -f lavfi -i "color=black:s=320x240:r=5:d=1,format=rgb24,geq=r=if(lt(X\\,303)\\,mod(7*N+X+Y\\,256)\\,0):g=if(lt(X\\,303)\\,mod(3*N+X\\,256)\\,0):b=if(lt(X\\,303)\\,mod(5*N+Y\\,256)\\,0),format=rgb24" -c:v apng -slices 2 -threads 2 -thread_type slice
+
 FATE_SAMPLES_FFMPEG += $(FATE_APNG-yes)
-fate-apng: $(FATE_APNG-yes)
+FATE_FFMPEG += $(FATE_APNG_FFMPEG-yes)
+fate-apng: $(FATE_APNG-yes) $(FATE_APNG_FFMPEG-yes)
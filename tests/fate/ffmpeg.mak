@@ -23,6 +23,13 @@ fate-force_key_frames: CMD = enc_dec \
   avi "-c mpeg4 -g 240 -qscale 10 -force_key_frames 0.5,0:00:01.5" \
   framecrc "" "-skip_frame nokey"
 
+# only the I-frames must be output, also with frame threads and B-frames
+FATE_FFMPEG-$(call TRANSCODE, MPEG4, NUT, RAWVIDEO_DEMUXER) += fate-ffmpeg-keyframes_only
+fate-ffmpeg-keyframes_only: tests/data/vsynth1.yuv
+fate-ffmpeg-keyframes_only: CMD = threads=4 transcode \
+  "rawvideo -s 352x288 -pix_fmt yuv420p" tests/data/vsynth1.yuv \
+  nut "-c:v mpeg4 -qscale 10 -bf 2 -g 12" "" "" "" "-keyframes_only"
+
 # test -force_key_frames source with and without framerate conversion
 # * we don't care about the actual video content, so replace it with
 #   a 2x2 black square to speed up encoding
@@ -89,6 +96,12 @@ fate-unknown_layout-ac3: CMD = md5 -auto_conversion_filters \
   -guess_layout_max 0 -f s32le -ac 1 -ar 44100 -i $(TARGET_PATH)/$(AREF) \
   -f ac3 -flags +bitexact -c ac3_fixed
 
+FATE_FFMPEG-$(call FILTERDEMDECENCMUX, ARESAMPLE, PCM_S32LE, PCM_S32LE, AC3_FIXED, AC3) += fate-unknown_layout-ac3-threads
+fate-unknown_layout-ac3-threads: $(AREF)
+fate-unknown_layout-ac3-threads: CMD = md5 -auto_conversion_filters \
+  -guess_layout_max 0 -f s32le -ac 1 -ar 44100 -i $(TARGET_PATH)/$(AREF) \
+  -f ac3 -flags +bitexact -c ac3_fixed -threads 3 -thread_type slice
+
 FATE_FFMPEG-$(call FILTERDEMDEC, AMIX ARESAMPLE SINE, RAWVIDEO, \
                            PCM_S16LE RAWVIDEO, LAVFI_INDEV  \
                            MPEG4_ENCODER AC3_FIXED_ENCODER) \
@@ -360,10 +360,17 @@ fate-jpg-rgb-5: CMD = framecrc -idct simple -i $(TARGET_SAMPLES)/jpg/jpg-8930-5.
 FATE_JPG_TRANSCODE-$(call TRANSCODE, MJPEG, MJPEG IMAGE_JPEG_PIPE, IMAGE_PNG_PIPE_DEMUXER PNG_DECODER SCALE_FILTER) += fate-jpg-icc
 fate-jpg-icc: CMD = transcode png_pipe $(TARGET_SAMPLES)/png1/lena-int_rgb24.png mjpeg "-vf scale" "" "-show_frames"
 
+# slice-encoded MJPEG has a restart interval per macroblock row, whose
+# segments are decoded concurrently by slice threads
+FATE_JPG_FFMPEG-$(call TRANSCODE, MJPEG, AVI, RAWVIDEO_DEMUXER SCALE_FILTER) += fate-jpg-rst-threads
+fate-jpg-rst-threads: tests/data/vsynth1.yuv
+fate-jpg-rst-threads: CMD = threads=4 thread_type=slice transcode "rawvideo -s 352x288 -pix_fmt yuv420p" tests/data/vsynth1.yuv avi "-vf scale -c:v mjpeg -pix_fmt yuvj420p -qscale 9 -threads 5 -thread_type slice -frames:v 10"
+
 FATE_JPG-$(call DEMDEC, IMAGE2, MJPEG) += $(FATE_JPG)
 FATE_IMAGE_FRAMECRC += $(FATE_JPG-yes)
 FATE_IMAGE_TRANSCODE += $(FATE_JPG_TRANSCODE-yes)
-fate-jpg: $(FATE_JPG-yes) $(FATE_JPG_TRANSCODE-yes)
+FATE_FFMPEG += $(FATE_JPG_FFMPEG-yes)
+fate-jpg: $(FATE_JPG-yes) $(FATE_JPG_TRANSCODE-yes) $(FATE_JPG_FFMPEG-yes)
 
 FATE_JPEGLS += fate-jpegls-2bpc
 fate-jpegls-2bpc: CMD = framecrc -idct simple -i $(TARGET_SAMPLES)/jpegls/4.jls
@@ -551,6 +558,18 @@ FATE_TIFF-$(call FRAMECRC, IMAGE2, TIFF) += $(FATE_TIFF)
 FATE_IMAGE_FRAMECRC += $(FATE_TIFF-yes)
 fate-tiff: $(FATE_TIFF-yes)
 
+# PackBits strips decoded concurrently by slice threads, output must match
+# the single-threaded decode
+ifneq (,$(filter fate-lavf-tiff,$(FATE_LAVF_IMAGES)))
+FATE_TIFF_FFMPEG-$(call TRANSCODE, TIFF, MOV, IMAGE2_DEMUXER) += fate-tiff-packbits-threads
+endif
+fate-tiff-packbits-threads: fate-lavf-tiff
+fate-lavf-tiff: KEEP_FILES ?= 1
+fate-tiff-packbits-threads: CMD = threads=4 thread_type=slice transcode image2 tests/data/images/tiff/%02d.tiff mov "-c:v tiff -compression_algo packbits"
+
+FATE_FFMPEG += $(FATE_TIFF_FFMPEG-yes)
+fate-tiff: $(FATE_TIFF_FFMPEG-yes)
+
 FATE_WEBP += fate-webp-rgb-lossless
 fate-webp-rgb-lossless: CMD = framecrc -i $(TARGET_SAMPLES)/webp/rgb_lossless.webp
 
@@ -67,3 +67,14 @@ FATE_JPEG2000DEC += $(FATE_JPEG2000DEC-yes)
 
 FATE_SAMPLES_FFMPEG-$(call FRAMECRC, IMAGE_J2K_PIPE, JPEG2000) += $(FATE_JPEG2000DEC)
 fate-jpeg2000dec: $(FATE_JPEG2000DEC)
+
+# a 4K 12-bit frame coded with code-block parallel slice threads must be
+# bit-identical to the single-threaded encode
+FATE_JPEG2000ENC-$(call ALLYES, LAVFI_INDEV TESTSRC2_FILTER FORMAT_FILTER SCALE_FILTER JPEG2000_ENCODER RAWVIDEO_MUXER) += fate-jpeg2000enc-4k fate-jpeg2000enc-4k-threads
+fate-jpeg2000enc-4k: CMD = md5 -auto_conversion_filters -f lavfi -i testsrc2=s=3840x2160:d=0.04,format=gbrp12 -c:v jpeg2000 -pred 1 -f rawvideo
+fate-jpeg2000enc-4k-threads: CMD = md5 -auto_conversion_filters -f lavfi -i testsrc2=s=3840x2160:d=0.04,format=gbrp12 -c:v jpeg2000 -pred 1 -threads 4 -thread_type slice -f rawvideo
+fate-jpeg2000enc-4k fate-jpeg2000enc-4k-threads: CMP = oneline
+fate-jpeg2000enc-4k fate-jpeg2000enc-4k-threads: REF = 2b78f41243babe193a340876a9cbef4d
+
+FATE_FFMPEG += $(FATE_JPEG2000ENC-yes)
+fate-jpeg2000enc: $(FATE_JPEG2000ENC-yes)
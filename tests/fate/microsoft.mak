@@ -77,6 +77,24 @@ fate-vc1test_smm0015: CMD = framecrc -i $(TARGET_SAMPLES)/vc1/SMM0015.rcv
 FATE_VC1-$(call FRAMECRC, MOV, VC1) += fate-vc1-ism
 fate-vc1-ism: CMD = framecrc -i $(TARGET_SAMPLES)/isom/vc1-wmapro.ism -an
 
+# Frame-threaded decoding must produce the same output as serial decoding.
+define FATE_VC1_FRAME_THREADS
+fate-$(1)-frame-threads: CMD = threads=4 thread_type=frame framecrc $(3) -i $(TARGET_SAMPLES)/vc1/$(2)
+fate-$(1)-frame-threads: REF = $(SRC_PATH)/tests/ref/fate/$(1)
+endef
+
+$(eval $(call FATE_VC1_FRAME_THREADS,vc1_sa00040,SA00040.vc1))
+$(eval $(call FATE_VC1_FRAME_THREADS,vc1_sa00050,SA00050.vc1))
+$(eval $(call FATE_VC1_FRAME_THREADS,vc1_sa10091,SA10091.vc1))
+$(eval $(call FATE_VC1_FRAME_THREADS,vc1_sa10143,SA10143.vc1))
+$(eval $(call FATE_VC1_FRAME_THREADS,vc1_sa20021,SA20021.vc1))
+$(eval $(call FATE_VC1_FRAME_THREADS,vc1_ilaced_twomv,ilaced_twomv.vc1,-flags +bitexact))
+$(eval $(call FATE_VC1_FRAME_THREADS,vc1test_smm0005,SMM0005.rcv))
+$(eval $(call FATE_VC1_FRAME_THREADS,vc1test_smm0015,SMM0015.rcv))
+
+FATE_VC1-$(call FRAMECRC, VC1, VC1, VC1_PARSER EXTRACT_EXTRADATA_BSF) += $(addsuffix -frame-threads,$(FATE_VC1))
+FATE_VC1-$(call FRAMECRC, VC1T, WMV3) += fate-vc1test_smm0005-frame-threads fate-vc1test_smm0015-frame-threads
+
 FATE_MICROSOFT += $(FATE_VC1-yes)
 fate-vc1: $(FATE_VC1-yes)
 
@@ -0,0 +1,184 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * Bitstream filter benchmark
+ *
+ * All packets of one stream are demuxed into memory first, then passed
+ * through the given bitstream filter chain a number of times.  Only the
+ * filtering is timed.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "libavcodec/bsf.h"
+#include "libavformat/avformat.h"
+#include "libavutil/error.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"
+
+static int usage(int ret)
+{
+    fprintf(stderr, "Benchmark a bitstream filter chain on the packets of a file.\n");
+    fprintf(stderr, "bsf_bench file filters [runs [stream_index]]\n");
+    fprintf(stderr, "filters is a bitstream filter chain as accepted by -bsf,\n");
+    fprintf(stderr, "e.g. 'filter_units=remove_types=6'.\n");
+    return ret;
+}
+
+static int run_filter(const char *filters, const AVStream *st,
+                      AVPacket **pkts, int nb_pkts, AVPacket *out,
+                      int64_t *out_size)
+{
+    AVBSFContext *bsf;
+    int err;
+
+    err = av_bsf_list_parse_str(filters, &bsf);
+    if (err < 0)
+        return err;
+
+    err = avcodec_parameters_copy(bsf->par_in, st->codecpar);
+    if (err < 0)
+        goto end;
+    bsf->time_base_in = st->time_base;
+
+    err = av_bsf_init(bsf);
+    if (err < 0)
+        goto end;
+
+    for (int i = 0; i <= nb_pkts; i++) {
+        if (i < nb_pkts) {
+            err = av_packet_ref(out, pkts[i]);
+            if (err < 0)
+                goto end;
+            err = av_bsf_send_packet(bsf, out);
+        } else {
+            err = av_bsf_send_packet(bsf, NULL);
+        }
+        if (err < 0) {
+            av_packet_unref(out);
+            goto end;
+        }
+
+        while ((err = av_bsf_receive_packet(bsf, out)) >= 0) {
+            *out_size += out->size;
+            av_packet_unref(out);
+        }
+        if (err != AVERROR(EAGAIN) && err != AVERROR_EOF)
+            goto end;
+    }
+    err = 0;
+
+end:
+    av_bsf_free(&bsf);
+    return err;
+}
+
+int main(int argc, char **argv)
+{
+    AVFormatContext *fctx = NULL;
+    AVPacket **pkts = NULL, *pkt = NULL;
+    int nb_pkts = 0, runs = 10, stream_index = -1;
+    int64_t in_size = 0, out_size = 0, t0, t1;
+    int ret = 1, err;
+
+    if (argc < 3)
+        return usage(1);
+    if (argc > 3)
+        runs = atoi(argv[3]);
+    if (argc > 4)
+        stream_index = atoi(argv[4]);
+    if (runs <= 0)
+        return usage(1);
+
+    err = avformat_open_input(&fctx, argv[1], NULL, NULL);
+    if (err < 0) {
+        fprintf(stderr, "cannot open input: %s\n", av_err2str(err));
+        return 1;
+    }
+
+    err = avformat_find_stream_info(fctx, NULL);
+    if (err < 0) {
+        fprintf(stderr, "avformat_find_stream_info: %s\n", av_err2str(err));
+        goto end;
+    }
+
+    if (stream_index < 0)
+        stream_index = av_find_best_stream(fctx, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0);
+    if (stream_index < 0 || stream_index >= fctx->nb_streams) {
+        fprintf(stderr, "no usable stream\n");
+        goto end;
+    }
+
+    pkt = av_packet_alloc();
+    if (!pkt)
+        goto end;
+
+    while ((err = av_read_frame(fctx, pkt)) >= 0) {
+        AVPacket **tmp;
+
+        if (pkt->stream_index != stream_index) {
+            av_packet_unref(pkt);
+            continue;
+        }
+
+        tmp = av_realloc_array(pkts, nb_pkts + 1, sizeof(*pkts));
+        if (!tmp)
+            goto end;
+        pkts = tmp;
+
+        pkts[nb_pkts] = av_packet_clone(pkt);
+        av_packet_unref(pkt);
+        if (!pkts[nb_pkts])
+            goto end;
+        in_size += pkts[nb_pkts++]->size;
+    }
+    if (err != AVERROR_EOF) {
+        fprintf(stderr, "av_read_frame: %s\n", av_err2str(err));
+        goto end;
+    }
+
+    t0 = av_gettime_relative();
+    for (int i = 0; i < runs; i++) {
+        err = run_filter(argv[2], fctx->streams[stream_index],
+                         pkts, nb_pkts, pkt, &out_size);
+        if (err < 0) {
+            fprintf(stderr, "filtering failed: %s\n", av_err2str(err));
+            goto end;
+        }
+    }
+    t1 = av_gettime_relative();
+
+    printf("%d packets, %"PRId64" bytes in, %"PRId64" bytes out per run\n",
+           nb_pkts, in_size, out_size / runs);
+    printf("%.3f ms per run, %.1f ns per packet, %.1f MB/s\n",
+           (t1 - t0) / 1000.0 / runs,
+           nb_pkts ? (t1 - t0) * 1000.0 / runs / nb_pkts : 0.0,
+           t1 > t0 ? (double)in_size * runs / (t1 - t0) : 0.0);
+    ret = 0;
+
+end:
+    for (int i = 0; i < nb_pkts; i++)
+        av_packet_free(&pkts[i]);
+    av_freep(&pkts);
+    av_packet_free(&pkt);
+    avformat_close_input(&fctx);
+    return ret;
+}
@@ -72,6 +72,7 @@ struct hash_impl {
  * lavu: libavutil
  ***************************************************************************/
 
+#include "libavutil/adler32.h"
 #include "libavutil/md5.h"
 #include "libavutil/sha.h"
 #include "libavutil/sha512.h"
@@ -111,6 +112,19 @@ DEFINE_LAVU_MD(sha512,    AVSHA512, sha512, 512);
 DEFINE_LAVU_MD(ripemd128, AVRIPEMD, ripemd, 128);
 DEFINE_LAVU_MD(ripemd160, AVRIPEMD, ripemd, 160);
 
+static void run_lavu_adler32(uint8_t *output,
+                             const uint8_t *input, unsigned size)
+{
+    AV_WB32(output, av_adler32_update(1, input, size));
+}
+
+static void run_lavu_crc32(uint8_t *output,
+                           const uint8_t *input, unsigned size)
+{
+    const AVCRC *table = av_crc_get_table(AV_CRC_32_IEEE_LE);
+    AV_WB32(output, av_crc(table, UINT32_MAX, input, size) ^ UINT32_MAX);
+}
+
 static void run_lavu_aes128(uint8_t *output,
                             const uint8_t *input, unsigned size)
 {
@@ -647,6 +661,8 @@ struct hash_impl implementations[] = {
     IMPL(lavu,     "RIPEMD-128", ripemd128, "9ab8bfba2ddccc5d99c9d4cdfb844a5f")
     IMPL(tomcrypt, "RIPEMD-128", ripemd128, "9ab8bfba2ddccc5d99c9d4cdfb844a5f")
     IMPL_ALL("RIPEMD-160", ripemd160, "62a5321e4fc8784903bb43ab7752c75f8b25af00")
+    IMPL(lavu,     "ADLER-32", adler32, "02be3d2d")
+    IMPL(lavu,     "CRC-32",   crc32,   "12554ca6")
     IMPL_ALL("AES-128",    aes128,    "crc:ff6bc888")
     IMPL_ALL("CAMELLIA",   camellia,  "crc:7abb59a7")
     IMPL(lavu,     "CAST-128", cast128, "crc:456aa584")